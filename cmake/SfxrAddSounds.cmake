@@ -0,0 +1,85 @@
+# sfxr_add_sounds(<target>
+#     SOURCES <sound_file>...
+#     [OUTPUT_DIR <dir>]
+#     [BITS <8|16>]
+#     [RATE <22050|44100>]
+#     [ALL]
+# )
+#
+# Creates a custom target named <target> which renders the given .sfxr or
+# .sfxj files to wav files, using sfxr-render.
+#
+# Each sound file gets its own custom command, so only the sounds which changed
+# are rendered again, and parallel builds render several sounds at the same
+# time.
+#
+# OUTPUT_DIR defaults to the current binary dir. The wav files keep the
+# directory structure of the sound files, relative to the current source dir.
+#
+# BITS and RATE set the bits per sample and the samplerate of the wav files.
+# When they are not set, sfxr-render defaults apply.
+#
+# If ALL is set, the target is added to the default build target.
+#
+# The list of the wav files is stored in the SFXR_OUTPUTS property of <target>.
+function(sfxr_add_sounds target)
+    cmake_parse_arguments(arg "ALL" "OUTPUT_DIR;BITS;RATE" "SOURCES" ${ARGN})
+    if (arg_UNPARSED_ARGUMENTS)
+        message(FATAL_ERROR "sfxr_add_sounds: unknown arguments: ${arg_UNPARSED_ARGUMENTS}")
+    endif()
+    if (NOT arg_SOURCES)
+        message(FATAL_ERROR "sfxr_add_sounds: no SOURCES given")
+    endif()
+    if (NOT TARGET sfxr::sfxr-render)
+        message(FATAL_ERROR "sfxr_add_sounds: the sfxr::sfxr-render target does not exist")
+    endif()
+
+    if (NOT arg_OUTPUT_DIR)
+        set(arg_OUTPUT_DIR ${CMAKE_CURRENT_BINARY_DIR})
+    endif()
+    get_filename_component(output_dir ${arg_OUTPUT_DIR} ABSOLUTE BASE_DIR ${CMAKE_CURRENT_BINARY_DIR})
+
+    # The build tool takes care of running the commands in parallel, so each
+    # command only needs one job
+    set(render_args --jobs 1)
+    if (arg_BITS)
+        list(APPEND render_args --bits ${arg_BITS})
+    endif()
+    if (arg_RATE)
+        list(APPEND render_args --rate ${arg_RATE})
+    endif()
+
+    set(outputs)
+    foreach(source ${arg_SOURCES})
+        get_filename_component(source ${source} ABSOLUTE)
+        file(RELATIVE_PATH rel_source ${CMAKE_CURRENT_SOURCE_DIR} ${source})
+        if (rel_source MATCHES "^\\.\\./")
+            # Out of the source dir, do not recreate its structure
+            get_filename_component(rel_source ${source} NAME)
+        endif()
+        get_filename_component(rel_dir ${rel_source} DIRECTORY)
+        get_filename_component(name ${rel_source} NAME_WLE)
+        if (rel_dir)
+            set(output ${output_dir}/${rel_dir}/${name}.wav)
+        else()
+            set(output ${output_dir}/${name}.wav)
+        endif()
+        get_filename_component(output_subdir ${output} DIRECTORY)
+
+        add_custom_command(
+            OUTPUT ${output}
+            COMMAND ${CMAKE_COMMAND} -E make_directory ${output_subdir}
+            COMMAND sfxr::sfxr-render ${render_args} --output ${output} ${source}
+            DEPENDS ${source} sfxr::sfxr-render
+            COMMENT "Rendering ${rel_source}"
+            VERBATIM
+        )
+        list(APPEND outputs ${output})
+    endforeach()
+
+    if (arg_ALL)
+        set(all_arg ALL)
+    endif()
+    add_custom_target(${target} ${all_arg} DEPENDS ${outputs})
+    set_target_properties(${target} PROPERTIES SFXR_OUTPUTS "${outputs}")
+endfunction()
@@ -0,0 +1,66 @@
+#include "BankExport.h"
+
+#include "Parallel.h"
+#include "SoundParams.h"
+#include "WavSaver.h"
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QtEndian>
+
+namespace BankExport {
+
+static Result render(const WavSaver& saver, ExportItem* item, QVector<qint16>* samples) {
+    SoundParams params;
+    auto result = BatchExport::loadParams(*item, &params);
+    if (!result) {
+        return result;
+    }
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    result = saver.save(params, &buffer, &item->sampleCount);
+    if (!result) {
+        return result;
+    }
+    const auto& data = buffer.data();
+    samples->resize(data.size() / 2);
+    for (int idx = 0; idx < samples->size(); ++idx) {
+        (*samples)[idx] = qFromLittleEndian<qint16>(data.constData() + 2 * idx);
+    }
+    return {};
+}
+
+Result run(const WavSaver& saver,
+           QVector<ExportItem>* items,
+           int jobs,
+           SoundBank::Encoding encoding,
+           const QString& bankPath) {
+    Q_ASSERT(saver.bits() == 16 && saver.format() == WavSaver::Raw);
+    QVector<QVector<qint16>> samples(items->size());
+    items->detach();
+    Parallel::forEachIndex(items->size(), jobs, [&saver, items, &samples](int index) {
+        auto* item = &(*items)[index];
+        item->result = render(saver, item, &samples[index]);
+    });
+
+    // Add the sounds in the order of the items, so that the bank does not
+    // depend on thread scheduling
+    SoundBankWriter writer(encoding, saver.frequency());
+    for (int idx = 0; idx < items->size(); ++idx) {
+        auto* item = &(*items)[idx];
+        if (!item->result) {
+            continue;
+        }
+        auto name = BatchExport::soundName(*item);
+        if (!writer.addSound(name, samples.at(idx))) {
+            item->result = Result::createError(
+                QCoreApplication::translate("main", "Another sound is already called %1.")
+                    .arg(name));
+        }
+        // Free the memory as soon as possible, the writer has its own copy
+        samples[idx] = {};
+    }
+    return writer.write(bankPath);
+}
+
+} // namespace BankExport
@@ -0,0 +1,31 @@
+#ifndef BANKEXPORT_H
+#define BANKEXPORT_H
+
+#include "BatchExport.h"
+#include "SoundBank.h"
+
+class WavSaver;
+
+/**
+ * Renders many sound files and packs them in a single SoundBank file
+ */
+namespace BankExport {
+
+/**
+ * Renders `items` with `saver`, using up to `jobs` threads, and writes them to
+ * the bank at `bankPath`. Sounds are named after their file name, without the
+ * extension.
+ *
+ * Each item result is stored in its `result` and `sampleCount` fields. Items
+ * which fail are left out of the bank. The returned result is the one of
+ * writing the bank.
+ */
+Result run(const WavSaver& saver,
+           QVector<ExportItem>* items,
+           int jobs,
+           SoundBank::Encoding encoding,
+           const QString& bankPath);
+
+} // namespace BankExport
+
+#endif // BANKEXPORT_H
@@ -0,0 +1,147 @@
+#include "BatchExport.h"
+
+#include "BufferStrategy.h"
+#include "Parallel.h"
+#include "SoundIO.h"
+#include "SoundParams.h"
+#include "WavSaver.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace BatchExport {
+
+template <typename Source>
+static Result save(const WavSaver& saver,
+                   const Source& source,
+                   const QString& outputPath,
+                   qint64* sampleCount) {
+    if (outputPath == STDOUT_PATH) {
+#ifdef Q_OS_WIN
+        // Do not let the C runtime translate line feeds in the samples
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+        return saver.save(source, &out, sampleCount);
+    }
+    return saver.save(source, outputPath, sampleCount);
+}
+
+static void exportItem(const WavSaver& saver, ExportItem* item) {
+    SoundParams params;
+    item->result = loadParams(*item, &params);
+    if (!item->result) {
+        return;
+    }
+    if (item->variants.isEmpty() || saver.renderCache()) {
+        // The render cache stores converted samples, so each output has its
+        // own entry: let each saver look for it
+        item->result = save(saver, params, item->outputPath, &item->sampleCount);
+        for (const auto& variant : item->variants) {
+            if (!item->result) {
+                return;
+            }
+            item->result = save(*variant.saver, params, variant.outputPath, nullptr);
+        }
+        return;
+    }
+
+    // Synthesize once, then convert the samples for each output
+    auto samples = renderSamples(params);
+
+    item->result = save(saver, samples, item->outputPath, &item->sampleCount);
+    for (const auto& variant : item->variants) {
+        if (!item->result) {
+            return;
+        }
+        item->result = save(*variant.saver, samples, variant.outputPath, nullptr);
+    }
+}
+
+void run(const WavSaver& saver,
+         QVector<ExportItem>* items,
+         int jobs,
+         const ItemCallback& onItemDone) {
+    auto exportAt = [&saver, items, &onItemDone](int index) {
+        auto* item = &(*items)[index];
+        exportItem(saver, item);
+        if (onItemDone) {
+            onItemDone(index, *item);
+        }
+    };
+
+    // Detach now: the items must not be copied while the threads write to them
+    items->detach();
+    Parallel::forEachIndex(items->size(), jobs, exportAt);
+}
+
+QString soundName(const ExportItem& item) {
+    if (item.params.has_value()) {
+        return item.url.fragment();
+    }
+    return QFileInfo(item.url.path()).completeBaseName();
+}
+
+Result loadParams(const ExportItem& item, SoundParams* params) {
+    if (item.params.has_value()) {
+        *params = item.params.value();
+        return {};
+    }
+    *params = SoundParams();
+    return SoundIO::load(params, item.url);
+}
+
+QString defaultOutputPath(const QString& inputPath,
+                          const QString& outputDir,
+                          const QString& extension) {
+    auto path = inputPath.section('.', 0, -2) + '.' + extension;
+    if (outputDir.isEmpty()) {
+        return path;
+    }
+    return QDir(outputDir).filePath(QFileInfo(path).fileName());
+}
+
+int reportErrors(const QVector<ExportItem>& items) {
+    int failureCount = 0;
+    for (const auto& item : items) {
+        if (!item.result) {
+            ++failureCount;
+            auto path = item.url.path();
+            if (item.params.has_value()) {
+                path += '#' + item.url.fragment();
+            }
+            qCritical("%s: %s", qUtf8Printable(path), qUtf8Printable(item.result.message()));
+        }
+    }
+    return failureCount;
+}
+
+void printSummary(const QVector<ExportItem>& items, qint64 elapsedNs) {
+    int exportedCount = 0;
+    qint64 sampleCount = 0;
+    for (const auto& item : items) {
+        if (item.result) {
+            ++exportedCount;
+            sampleCount += item.sampleCount;
+        }
+    }
+    qreal seconds = qMax(elapsedNs, qint64(1)) / 1e9;
+    auto message = QCoreApplication::translate(
+                       "main", "Exported %1 of %2 files in %3 s (%4 files/s, %5 samples/s).")
+                       .arg(exportedCount)
+                       .arg(items.size())
+                       .arg(seconds, 0, 'f', 2)
+                       .arg(exportedCount / seconds, 0, 'f', 1)
+                       .arg(sampleCount / seconds, 0, 'f', 0);
+    qInfo("%s", qUtf8Printable(message));
+}
+
+} // namespace BatchExport
@@ -0,0 +1,98 @@
+#ifndef BATCHEXPORT_H
+#define BATCHEXPORT_H
+
+#include "Result.h"
+#include "SoundParams.h"
+
+#include <QStringList>
+#include <QUrl>
+#include <QVector>
+
+#include <functional>
+#include <optional>
+
+class WavSaver;
+
+/**
+ * An additional output for an ExportItem, with its own settings
+ */
+struct ExportVariant {
+    QString outputPath;
+    const WavSaver* saver = nullptr;
+};
+
+struct ExportItem {
+    QUrl url;
+    QString outputPath;
+
+    // For sounds coming from a parameter bank: their parameters, used instead
+    // of loading `url`. `url` points to the bank, with the name of the sound
+    // as fragment.
+    std::optional<SoundParams> params;
+    QStringList tags;
+
+    // Additional outputs. The sound is synthesized once for all outputs.
+    QVector<ExportVariant> variants;
+
+    // Set once the item has been exported
+    Result result;
+    qint64 sampleCount = 0;
+};
+
+/**
+ * Exports many sound files in parallel
+ */
+namespace BatchExport {
+
+/**
+ * Output path which means "write to the standard output"
+ */
+inline const QString STDOUT_PATH = QStringLiteral("-");
+
+/**
+ * Called from the worker threads each time an item has been exported
+ */
+using ItemCallback = std::function<void(int index, const ExportItem& item)>;
+
+/**
+ * Exports all `items`, using up to `jobs` threads. Each item result is stored
+ * in its `result` and `sampleCount` fields.
+ */
+void run(const WavSaver& saver,
+         QVector<ExportItem>* items,
+         int jobs,
+         const ItemCallback& onItemDone = {});
+
+/**
+ * Returns the name of the sound of `item`: the name of its file without the
+ * extension, or its name in the parameter bank it comes from
+ */
+QString soundName(const ExportItem& item);
+
+/**
+ * Loads the parameters of the sound of `item`
+ */
+Result loadParams(const ExportItem& item, SoundParams* params);
+
+/**
+ * Returns the default output path for `inputPath`: the same path with the
+ * `extension` of the output format, in `outputDir` if it is not empty.
+ */
+QString defaultOutputPath(const QString& inputPath,
+                          const QString& outputDir,
+                          const QString& extension);
+
+/**
+ * Prints the errors of `items`, in order, so that the output does not depend
+ * on thread scheduling. Returns the number of failed items.
+ */
+int reportErrors(const QVector<ExportItem>& items);
+
+/**
+ * Prints the number of exported files and the throughput
+ */
+void printSummary(const QVector<ExportItem>& items, qint64 elapsedNs);
+
+} // namespace BatchExport
+
+#endif // BATCHEXPORT_H
@@ -0,0 +1,25 @@
+#include "CommandLineUtils.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+
+namespace CommandLineUtils {
+
+bool parsePositiveInt(const QCommandLineParser& parser, const QString& name, int* value) {
+    if (!parser.isSet(name)) {
+        return true;
+    }
+    bool ok;
+    int number = parser.value(name).toInt(&ok);
+    if (!ok || number < 1) {
+        qCritical() << QCoreApplication::translate(
+                           "main", "Invalid value for --%1. It must be at least 1.")
+                           .arg(name);
+        return false;
+    }
+    *value = number;
+    return true;
+}
+
+} // namespace CommandLineUtils
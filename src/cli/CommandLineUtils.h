@@ -0,0 +1,20 @@
+#ifndef COMMANDLINEUTILS_H
+#define COMMANDLINEUTILS_H
+
+class QCommandLineParser;
+class QString;
+
+/**
+ * Helpers shared by the command line commands
+ */
+namespace CommandLineUtils {
+
+/**
+ * If option `name` is set, parses its value into `value`. Returns false,
+ * after printing an error, if the value is not an integer of at least 1.
+ */
+bool parsePositiveInt(const QCommandLineParser& parser, const QString& name, int* value);
+
+} // namespace CommandLineUtils
+
+#endif // COMMANDLINEUTILS_H
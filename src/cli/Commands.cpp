@@ -0,0 +1,51 @@
+#include "Commands.h"
+
+#include "DedupCommand.h"
+#include "ExportCommand.h"
+#include "FitCommand.h"
+#include "GenerateCommand.h"
+#include "Result.h"
+#include "SearchCommand.h"
+#include "SweepCommand.h"
+#include "WaveForm.h"
+
+#include <QCommandLineParser>
+
+namespace Commands {
+
+void addOptions(QCommandLineParser* parser) {
+    ExportCommand::addOptions(parser);
+    GenerateCommand::addOptions(parser);
+    SearchCommand::addOptions(parser);
+    DedupCommand::addOptions(parser);
+    FitCommand::addOptions(parser);
+    SweepCommand::addOptions(parser);
+}
+
+bool isCommandRequested(const QCommandLineParser& parser) {
+    return !parser.optionNames().isEmpty();
+}
+
+int run(const QCommandLineParser& parser) {
+    WaveForm::registerType();
+    Result::registerType();
+
+    if (parser.isSet("generate")) {
+        return GenerateCommand::run(parser);
+    }
+    if (parser.isSet("dedup")) {
+        return DedupCommand::run(parser);
+    }
+    if (parser.isSet("library")) {
+        return SearchCommand::run(parser);
+    }
+    if (parser.isSet("fit")) {
+        return FitCommand::run(parser);
+    }
+    if (parser.isSet("sweep")) {
+        return SweepCommand::run(parser);
+    }
+    return ExportCommand::run(parser);
+}
+
+} // namespace Commands
@@ -0,0 +1,32 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+class QCommandLineParser;
+
+/**
+ * Dispatches to the command line commands. Shared by sfxr-render and the
+ * command line mode of the app, so that both support the same commands.
+ */
+namespace Commands {
+
+/**
+ * Adds the options of all the commands
+ */
+void addOptions(QCommandLineParser* parser);
+
+/**
+ * Returns true if the command line asks for a command rather than the user
+ * interface. The user interface has no options of its own, so this is the
+ * case as soon as an option is set.
+ */
+bool isCommandRequested(const QCommandLineParser& parser);
+
+/**
+ * Runs the command selected by the options, ExportCommand by default.
+ * Returns the exit code of the process.
+ */
+int run(const QCommandLineParser& parser);
+
+} // namespace Commands
+
+#endif // COMMANDS_H
@@ -0,0 +1,159 @@
+#include "DedupCommand.h"
+
+#include "CommandLineUtils.h"
+#include "DuplicateFinder.h"
+#include "FeatureIndex.h"
+#include "Parallel.h"
+#include "SoundFingerprint.h"
+#include "SoundIO.h"
+#include "SoundParams.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <QUrl>
+
+#include <optional>
+
+using std::optional;
+
+namespace DedupCommand {
+
+struct Arguments {
+    QString dir;
+    int maxDistance = DuplicateFinder::DEFAULT_MAX_DISTANCE;
+    int jobs = QThread::idealThreadCount();
+
+    static optional<Arguments> parse(const QCommandLineParser& parser) {
+        Arguments instance;
+        if (!parser.positionalArguments().isEmpty() || parser.isSet("output")
+            || parser.isSet("generate") || parser.isSet("library")) {
+            qCritical() << QCoreApplication::translate(
+                "main",
+                "Input files, --output, --generate and --library cannot be used with --dedup.");
+            return {};
+        }
+        instance.dir = parser.value("dedup");
+        if (!QFileInfo(instance.dir).isDir()) {
+            qCritical() << QCoreApplication::translate("main", "%1 is not a directory.")
+                               .arg(instance.dir);
+            return {};
+        }
+        if (parser.isSet("max-distance")) {
+            bool ok;
+            instance.maxDistance = parser.value("max-distance").toInt(&ok);
+            if (!ok || instance.maxDistance < 0
+                || instance.maxDistance > DuplicateFinder::MAX_DISTANCE_LIMIT) {
+                qCritical() << QCoreApplication::translate(
+                                   "main",
+                                   "Invalid value for --max-distance. It must be between 0 and "
+                                   "%1.")
+                                   .arg(DuplicateFinder::MAX_DISTANCE_LIMIT);
+                return {};
+            }
+        }
+        if (!CommandLineUtils::parsePositiveInt(parser, "jobs", &instance.jobs)) {
+            return {};
+        }
+        return instance;
+    }
+};
+
+void addOptions(QCommandLineParser* parser) {
+    parser->addOption(
+        {"dedup",
+         QCoreApplication::translate(
+             "main",
+             "Finds the sound files of the given directory and its subdirectories which sound "
+             "almost the same. Prints the clusters of near-duplicates, one sound per line: "
+             "\"keep\" or \"drop\", the distance to the kept sound and the path."),
+         "dir"});
+    parser->addOption(
+        {"max-distance",
+         QCoreApplication::translate("main",
+                                     "Number of fingerprint bits, out of %1, which can differ "
+                                     "between near-duplicates found by --dedup. At most %2, "
+                                     "defaults to %3.")
+             .arg(SoundFingerprint::BIT_COUNT)
+             .arg(DuplicateFinder::MAX_DISTANCE_LIMIT)
+             .arg(DuplicateFinder::DEFAULT_MAX_DISTANCE),
+         "bits"});
+}
+
+int run(const QCommandLineParser& parser) {
+    auto maybeArgs = Arguments::parse(parser);
+    if (!maybeArgs.has_value()) {
+        return 1;
+    }
+    const auto& args = maybeArgs.value();
+
+    QElapsedTimer timer;
+    timer.start();
+    auto paths = FeatureIndex::findSoundFiles(args.dir);
+    QVector<SoundFingerprint> fingerprints(paths.size());
+    QVector<Result> results(paths.size());
+    SoundFingerprint* fingerprintData = fingerprints.data();
+    Result* resultData = results.data();
+    Parallel::forEachIndex(
+        paths.size(), args.jobs, [&paths, fingerprintData, resultData](int index) {
+            SoundParams params;
+            resultData[index] = SoundIO::load(&params, QUrl::fromLocalFile(paths.at(index)));
+            if (resultData[index]) {
+                fingerprintData[index] = SoundFingerprint::fromParams(params);
+            }
+        });
+
+    // Leave out the files which could not be loaded
+    QStringList loadedPaths;
+    QVector<SoundFingerprint> loadedFingerprints;
+    bool hasErrors = false;
+    for (int idx = 0; idx < paths.size(); ++idx) {
+        if (results.at(idx)) {
+            loadedPaths << paths.at(idx);
+            loadedFingerprints << fingerprints.at(idx);
+        } else {
+            qCritical("%s: %s",
+                      qUtf8Printable(paths.at(idx)),
+                      qUtf8Printable(results.at(idx).message()));
+            hasErrors = true;
+        }
+    }
+    qint64 fingerprintElapsed = timer.nsecsElapsed();
+
+    timer.restart();
+    auto clusters = DuplicateFinder::findClusters(loadedFingerprints, args.maxDistance);
+    qint64 clusterElapsed = timer.nsecsElapsed();
+
+    QTextStream out(stdout);
+    int droppedCount = 0;
+    for (const auto& cluster : clusters) {
+        const auto& kept = loadedFingerprints.at(cluster.kept);
+        out << "keep\t0\t" << loadedPaths.at(cluster.kept) << '\n';
+        for (int dropped : cluster.dropped) {
+            out << "drop\t" << kept.distance(loadedFingerprints.at(dropped)) << '\t'
+                << loadedPaths.at(dropped) << '\n';
+        }
+        out << '\n';
+        droppedCount += cluster.dropped.size();
+    }
+    out.flush();
+
+    auto message =
+        QCoreApplication::translate(
+            "main",
+            "Fingerprinted %1 sounds in %2 s and clustered them in %3 ms: found %4 clusters of "
+            "near-duplicates, %5 sounds can be removed.")
+            .arg(loadedPaths.size())
+            .arg(fingerprintElapsed / 1e9, 0, 'f', 2)
+            .arg(clusterElapsed / 1e6, 0, 'f', 2)
+            .arg(clusters.size())
+            .arg(droppedCount);
+    qInfo("%s", qUtf8Printable(message));
+    return hasErrors ? 1 : 0;
+}
+
+} // namespace DedupCommand
@@ -0,0 +1,27 @@
+#ifndef DEDUPCOMMAND_H
+#define DEDUPCOMMAND_H
+
+class QCommandLineParser;
+
+/**
+ * Finds the sound files of a directory which sound almost the same, from the
+ * command line, and suggests which ones to keep and which ones to remove.
+ *
+ * The sounds are synthesized and fingerprinted in parallel, then clustered by
+ * DuplicateFinder.
+ *
+ * Shares --jobs with ExportCommand, so its options must be added to the same
+ * parser.
+ */
+namespace DedupCommand {
+
+void addOptions(QCommandLineParser* parser);
+
+/**
+ * Returns the exit code of the process
+ */
+int run(const QCommandLineParser& parser);
+
+} // namespace DedupCommand
+
+#endif // DEDUPCOMMAND_H
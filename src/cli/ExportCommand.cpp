@@ -0,0 +1,729 @@
+#include "ExportCommand.h"
+
+#include "BankExport.h"
+#include "BatchExport.h"
+#include "CommandLineUtils.h"
+#include "Parallel.h"
+#include "ParamBank.h"
+#include "RenderCache.h"
+#include "ShardedExport.h"
+#include "SoundWatcher.h"
+#include "WavSaver.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSet>
+#include <QThread>
+#include <QUrl>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+using std::optional;
+
+namespace ExportCommand {
+
+static const QString NAME_PLACEHOLDER = QStringLiteral("{name}");
+
+/**
+ * An output given with --output, with optional settings overriding the
+ * global ones
+ */
+struct OutputSpec {
+    QString path;
+    optional<int> bits;
+    optional<int> frequency;
+    optional<WavSaver::Format> format;
+};
+
+static bool checkBits(int bits) {
+    if (!(bits == 8 || bits == 16)) {
+        qCritical() << QCoreApplication::translate(
+            "main", "Invalid bits per sample. Supported values are 8 and 16.");
+        return false;
+    }
+    return true;
+}
+
+static bool checkFrequency(int frequency) {
+    if (!(frequency == 22050 || frequency == 44100)) {
+        qCritical() << QCoreApplication::translate(
+            "main", "Invalid samplerate. Supported values are 22050 and 44100.");
+        return false;
+    }
+    return true;
+}
+
+static optional<WavSaver::Format> formatForExtension(const QString& extension) {
+    for (auto format : {WavSaver::Wav, WavSaver::Raw, WavSaver::Flac}) {
+        if (extension == WavSaver::fileExtension(format)) {
+            return format;
+        }
+    }
+    return {};
+}
+
+/**
+ * Parses an --output value: `path[:bits[:rate]]`. The format is deduced from
+ * the extension of the path, if it is a known one.
+ */
+static optional<OutputSpec> parseOutputSpec(const QString& value) {
+    // Only match numbers, so that Windows drive letters are not mistaken for
+    // settings
+    static const QRegularExpression SPEC_RX("^(.+?)(?::(\\d+))?(?::(\\d+))?$");
+    auto match = SPEC_RX.match(value);
+    OutputSpec spec;
+    spec.path = match.captured(1);
+    if (match.hasMatch() && !match.captured(2).isEmpty()) {
+        int bits = match.captured(2).toInt();
+        if (!checkBits(bits)) {
+            return {};
+        }
+        spec.bits = bits;
+    }
+    if (match.hasMatch() && !match.captured(3).isEmpty()) {
+        int frequency = match.captured(3).toInt();
+        if (!checkFrequency(frequency)) {
+            return {};
+        }
+        spec.frequency = frequency;
+    }
+    spec.format = formatForExtension(QFileInfo(spec.path).suffix());
+    return spec;
+}
+
+/**
+ * Returns the path to write to for `spec`, when exporting `item`
+ */
+static QString resolveOutputPath(const OutputSpec& spec, const ExportItem& item) {
+    if (spec.path == BatchExport::STDOUT_PATH) {
+        return BatchExport::STDOUT_PATH;
+    }
+    auto path = spec.path;
+    path.replace(NAME_PLACEHOLDER, BatchExport::soundName(item));
+    return QUrl::fromUserInput(path, QDir::currentPath(), QUrl::AssumeLocalFile).path();
+}
+
+/**
+ * Returns the path to write to when exporting `item` without --output
+ */
+static QString defaultOutputPath(const ExportItem& item,
+                                 const QString& outputDir,
+                                 const QString& extension) {
+    if (!item.params.has_value()) {
+        return BatchExport::defaultOutputPath(item.url.path(), outputDir, extension);
+    }
+    // Sounds from a parameter bank are exported next to the bank
+    auto dir = outputDir.isEmpty() ? QFileInfo(item.url.path()).dir() : QDir(outputDir);
+    return dir.filePath(BatchExport::soundName(item) + '.' + extension);
+}
+
+struct Arguments {
+    QVector<ExportItem> items;
+    optional<int> outputBits;
+    optional<int> outputFrequency;
+    WavSaver::Format outputFormat = WavSaver::Wav;
+    QVector<OutputSpec> outputSpecs;
+    QString outputDir;
+    int jobs = QThread::idealThreadCount();
+    ShardedExport::Options shardedExportOptions;
+    int workerCount = 1;
+    QString bankPath;
+    SoundBank::Encoding bankEncoding = SoundBank::Pcm16;
+    QString paramBankPath;
+    QStringList paramBankTags;
+    QString cacheDir;
+
+    static optional<Arguments> parse(const QCommandLineParser& parser) {
+        Arguments instance;
+        if (parser.isSet("cache-dir")) {
+            instance.cacheDir = parser.value("cache-dir");
+        } else if (parser.isSet("cache")) {
+            instance.cacheDir = RenderCache::defaultDir();
+        }
+        if (!parseOutputOptions(parser, &instance) || !parseJobOptions(parser, &instance)
+            || !parseBankOptions(parser, &instance) || !parseParamBankOptions(parser, &instance)) {
+            return {};
+        }
+        if (parser.isSet("manifest")) {
+            if (!parseManifestOptions(parser, &instance)) {
+                return {};
+            }
+            return instance;
+        }
+        if (parser.isSet("watch")) {
+            if (!parser.positionalArguments().isEmpty() || parser.isSet("output")) {
+                qCritical() << QCoreApplication::translate(
+                    "main", "Input files and --output cannot be used with --watch.");
+                return {};
+            }
+            return instance;
+        }
+        if (parser.isSet("workers")) {
+            qCritical() << QCoreApplication::translate(
+                "main", "--workers can only be used with --manifest.");
+            return {};
+        }
+        if (!parseInputs(parser, &instance)) {
+            return {};
+        }
+        return instance;
+    }
+
+    static bool parseInputs(const QCommandLineParser& parser, Arguments* instance) {
+        auto args = parser.positionalArguments();
+        if (args.isEmpty()) {
+            qCritical() << QCoreApplication::translate("main", "No file given to export.");
+            return false;
+        }
+
+        QStringList inputPaths;
+        for (const auto& arg : args) {
+            auto paths = expandGlob(arg);
+            if (paths.isEmpty()) {
+                qCritical() << QCoreApplication::translate("main", "No file matches %1.").arg(arg);
+                return false;
+            }
+            inputPaths << paths;
+        }
+
+        // The sounds of parameter banks are exported individually
+        QVector<ExportItem> items;
+        for (const auto& inputPath : inputPaths) {
+            ExportItem item;
+            item.url = QUrl::fromUserInput(inputPath, QDir::currentPath(), QUrl::AssumeLocalFile);
+            if (QFileInfo(inputPath).suffix() != ParamBank::EXTENSION) {
+                items << item;
+                continue;
+            }
+            ParamBank bank;
+            auto result = bank.open(item.url.path());
+            if (!result) {
+                qCritical("%s", qUtf8Printable(result.message()));
+                return false;
+            }
+            for (int idx = 0; idx < bank.count(); ++idx) {
+                item.url.setFragment(bank.name(idx));
+                item.params = bank.params(idx);
+                item.tags = bank.tags(idx);
+                items << item;
+            }
+        }
+
+        const auto& specs = instance->outputSpecs;
+        bool haveNamePlaceholders =
+            std::all_of(specs.begin(), specs.end(), [](const OutputSpec& spec) {
+                return spec.path.contains(NAME_PLACEHOLDER);
+            });
+        if (!haveNamePlaceholders && items.size() > 1) {
+            qCritical() << QCoreApplication::translate("main",
+                                                       "--output can only be used with one input "
+                                                       "file, unless its path contains {name}. "
+                                                       "You can also use --output-dir.");
+            return false;
+        }
+
+        QSet<QString> outputPaths;
+        for (auto& item : items) {
+            QStringList itemOutputPaths;
+            if (specs.isEmpty()) {
+                item.outputPath = defaultOutputPath(
+                    item, instance->outputDir, WavSaver::fileExtension(instance->outputFormat));
+            } else {
+                item.outputPath = resolveOutputPath(specs.first(), item);
+                for (int idx = 1; idx < specs.size(); ++idx) {
+                    ExportVariant variant;
+                    variant.outputPath = resolveOutputPath(specs.at(idx), item);
+                    item.variants << variant;
+                }
+            }
+            itemOutputPaths << item.outputPath;
+            for (const auto& variant : item.variants) {
+                itemOutputPaths << variant.outputPath;
+            }
+            // With --bank and --param-bank, the output paths are not used
+            bool checkOutputPaths =
+                instance->bankPath.isEmpty() && instance->paramBankPath.isEmpty();
+            for (const auto& outputPath : itemOutputPaths) {
+                if (checkOutputPaths && outputPaths.contains(outputPath)) {
+                    qCritical() << QCoreApplication::translate(
+                                       "main", "Several input files would be exported to %1.")
+                                       .arg(outputPath);
+                    return false;
+                }
+                outputPaths.insert(outputPath);
+            }
+            instance->items << item;
+        }
+        return true;
+    }
+
+    static bool parseOutputOptions(const QCommandLineParser& parser, Arguments* instance) {
+        if (parser.isSet("output-dir")) {
+            QDir outputDir(parser.value("output-dir"));
+            if (!outputDir.mkpath(".")) {
+                qCritical() << QCoreApplication::translate("main", "Cannot create directory %1.")
+                                   .arg(outputDir.path());
+                return false;
+            }
+            instance->outputDir = outputDir.path();
+        }
+
+        if (parser.isSet("bits")) {
+            int outputBits = parser.value("bits").toInt();
+            if (!checkBits(outputBits)) {
+                return false;
+            }
+            instance->outputBits = outputBits;
+        }
+
+        if (parser.isSet("rate")) {
+            int outputFrequency = parser.value("rate").toInt();
+            if (!checkFrequency(outputFrequency)) {
+                return false;
+            }
+            instance->outputFrequency = outputFrequency;
+        }
+
+        if (parser.isSet("format")) {
+            auto format = parser.value("format");
+            if (format == "wav") {
+                instance->outputFormat = WavSaver::Wav;
+            } else if (format == "raw") {
+                instance->outputFormat = WavSaver::Raw;
+            } else if (format == "flac") {
+                instance->outputFormat = WavSaver::Flac;
+            } else {
+                qCritical() << QCoreApplication::translate(
+                    "main", "Invalid format. Supported values are wav, raw and flac.");
+                return false;
+            }
+        }
+
+        for (const auto& value : parser.values("output")) {
+            auto spec = parseOutputSpec(value);
+            if (!spec.has_value()) {
+                return false;
+            }
+            instance->outputSpecs << spec.value();
+        }
+        return true;
+    }
+
+    static bool parseJobOptions(const QCommandLineParser& parser, Arguments* instance) {
+        if (!CommandLineUtils::parsePositiveInt(parser, "workers", &instance->workerCount)) {
+            return false;
+        }
+        // Share the cores between the workers
+        instance->jobs = qMax(1, instance->jobs / instance->workerCount);
+
+        if (!CommandLineUtils::parsePositiveInt(parser, "jobs", &instance->jobs)) {
+            return false;
+        }
+        instance->shardedExportOptions.jobs = instance->jobs;
+        return true;
+    }
+
+    static bool parseBankOptions(const QCommandLineParser& parser, Arguments* instance) {
+        if (!parser.isSet("bank")) {
+            if (parser.isSet("bank-encoding")) {
+                qCritical() << QCoreApplication::translate(
+                    "main", "--bank-encoding can only be used with --bank.");
+                return false;
+            }
+            return true;
+        }
+        if (parser.isSet("output") || parser.isSet("bits") || parser.isSet("format")
+            || parser.isSet("manifest") || parser.isSet("watch")) {
+            qCritical() << QCoreApplication::translate(
+                "main",
+                "--output, --bits, --format, --manifest and --watch cannot be used with --bank.");
+            return false;
+        }
+        instance->bankPath = parser.value("bank");
+        if (parser.isSet("bank-encoding")) {
+            auto encoding = parser.value("bank-encoding");
+            if (encoding == "pcm16") {
+                instance->bankEncoding = SoundBank::Pcm16;
+            } else if (encoding == "adpcm") {
+                instance->bankEncoding = SoundBank::ImaAdpcm;
+            } else {
+                qCritical() << QCoreApplication::translate(
+                    "main", "Invalid bank encoding. Supported values are pcm16 and adpcm.");
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static bool parseParamBankOptions(const QCommandLineParser& parser, Arguments* instance) {
+        if (!parser.isSet("param-bank")) {
+            if (parser.isSet("tag")) {
+                qCritical() << QCoreApplication::translate(
+                    "main", "--tag can only be used with --param-bank.");
+                return false;
+            }
+            return true;
+        }
+        if (parser.isSet("output") || parser.isSet("bits") || parser.isSet("rate")
+            || parser.isSet("format") || parser.isSet("bank") || parser.isSet("manifest")
+            || parser.isSet("watch")) {
+            qCritical() << QCoreApplication::translate("main",
+                                                       "--output, --bits, --rate, --format, "
+                                                       "--bank, --manifest and --watch cannot be "
+                                                       "used with --param-bank.");
+            return false;
+        }
+        instance->paramBankPath = parser.value("param-bank");
+        for (const auto& tag : parser.values("tag")) {
+            if (tag.contains(',')) {
+                qCritical() << QCoreApplication::translate("main", "Tags cannot contain commas.");
+                return false;
+            }
+            instance->paramBankTags << tag;
+        }
+        return true;
+    }
+
+    static bool parseManifestOptions(const QCommandLineParser& parser, Arguments* instance) {
+        if (!parser.positionalArguments().isEmpty() || parser.isSet("output")) {
+            qCritical() << QCoreApplication::translate(
+                "main", "Input files and --output cannot be used with --manifest.");
+            return false;
+        }
+        auto& options = instance->shardedExportOptions;
+        options.manifestPath = parser.value("manifest");
+        options.outputDir = instance->outputDir;
+        options.workDir = parser.value("work-dir");
+        return CommandLineUtils::parsePositiveInt(parser, "shards", &options.shardCount);
+    }
+
+    /**
+     * Expands wildcards in the file name part of `arg`, for shells which do
+     * not do it (or when the argument is quoted). Returns the matching paths,
+     * sorted by name.
+     */
+    static QStringList expandGlob(const QString& arg) {
+        static const QRegularExpression WILDCARD_RX("[*?[]");
+        QFileInfo info(arg);
+        if (info.exists() || !info.fileName().contains(WILDCARD_RX)) {
+            return {arg};
+        }
+        QDir dir = info.dir();
+        QStringList paths;
+        for (const auto& name : dir.entryList({info.fileName()}, QDir::Files, QDir::Name)) {
+            paths << dir.filePath(name);
+        }
+        return paths;
+    }
+};
+
+void addOptions(QCommandLineParser* parser) {
+    parser->addOption(
+        {{"o", "output"},
+         QCoreApplication::translate(
+             "main",
+             "Specifies the path for the exported file. Use - to write to the standard output. "
+             "{name} is replaced with the name of the input file, which makes it possible to "
+             "export several files. Bits per sample and samplerate can be appended to the path, "
+             "separated by colons, to override --bits and --rate. Can be repeated to create "
+             "several variants of each sound, while synthesizing it only once."),
+         "path[:bits[:rate]]"});
+    parser->addOption(
+        {"output-dir",
+         QCoreApplication::translate(
+             "main",
+             "Specifies the directory for the exported wav files. Defaults to the directory "
+             "of each input file."),
+         "dir"});
+    parser->addOption(
+        {{"b", "bits"},
+         QCoreApplication::translate("main",
+                                     "Specifies the bits per sample for the exported wav files. "
+                                     "Supported values are 8 and 16."),
+         "number"});
+    parser->addOption(
+        {{"r", "rate"},
+         QCoreApplication::translate("main",
+                                     "Specifies the samplerate for the exported wav files. "
+                                     "Supported values are 22050 and 44100."),
+         "number"});
+    parser->addOption(
+        {{"f", "format"},
+         QCoreApplication::translate("main",
+                                     "Specifies the format of the exported files. Supported values "
+                                     "are wav, raw and flac. raw files contain the samples, "
+                                     "without any header. Defaults to wav."),
+         "format"});
+    parser->addOption(
+        {{"j", "jobs"},
+         QCoreApplication::translate(
+             "main", "Number of files to export in parallel. Defaults to the number of cores."),
+         "number"});
+    parser->addOption(
+        {"manifest",
+         QCoreApplication::translate("main",
+                                     "Exports the files listed in the given manifest file, one "
+                                     "per line. The work is split in shards, which can be "
+                                     "shared by several processes. An interrupted export "
+                                     "resumes where it stopped."),
+         "file"});
+    parser->addOption(
+        {"shards",
+         QCoreApplication::translate("main",
+                                     "Number of shards to split the manifest in. Defaults to one "
+                                     "shard per 100 files."),
+         "number"});
+    parser->addOption({"work-dir",
+                       QCoreApplication::translate("main",
+                                                   "Directory used to coordinate the processes "
+                                                   "working on a manifest. Defaults to the "
+                                                   "manifest path followed by \".work\"."),
+                       "dir"});
+    parser->addOption(
+        {"watch",
+         QCoreApplication::translate("main",
+                                     "Watches the given directory and its subdirectories, and "
+                                     "exports the sound files each time they change."),
+         "dir"});
+    parser->addOption(
+        {"bank",
+         QCoreApplication::translate("main",
+                                     "Packs all the exported sounds in the given sound bank file, "
+                                     "instead of creating one file per sound. Sounds are named "
+                                     "after their file, without the extension."),
+         "file"});
+    parser->addOption(
+        {"bank-encoding",
+         QCoreApplication::translate("main",
+                                     "Specifies how samples are stored in the sound bank. "
+                                     "Supported values are pcm16 and adpcm (IMA-ADPCM, 4 bits per "
+                                     "sample). Defaults to pcm16."),
+         "encoding"});
+    parser->addOption(
+        {"param-bank",
+         QCoreApplication::translate("main",
+                                     "Stores the parameters of all the input sounds in the given "
+                                     "parameter bank file (.sfxp), instead of exporting them. "
+                                     "Parameter banks open much faster than individual files, "
+                                     "and can be used as input files."),
+         "file"});
+    parser->addOption(
+        {"tag",
+         QCoreApplication::translate(
+             "main",
+             "Adds a tag to the sounds stored with --param-bank. Can be repeated. Sounds "
+             "coming from another parameter bank keep their tags."),
+         "tag"});
+    parser->addOption(
+        {"cache",
+         QCoreApplication::translate(
+             "main",
+             "Stores the rendered sounds in a cache, and reuses the ones rendered by previous "
+             "exports. The cache is invalidated when the synthesizer changes.")});
+    parser->addOption({"cache-dir",
+                       QCoreApplication::translate(
+                           "main", "Like --cache, but stores the cache in the given directory."),
+                       "dir"});
+    parser->addOption(
+        {"workers",
+         QCoreApplication::translate(
+             "main", "Number of processes to start to work on a manifest. Defaults to 1."),
+         "number"});
+}
+
+/**
+ * Starts `count` processes running the same command line as this one, without
+ * the --workers option. Returns the processes which could be started.
+ */
+static std::vector<std::unique_ptr<QProcess>> startWorkers(int count, int jobs) {
+    QStringList arguments;
+    auto appArguments = QCoreApplication::arguments().mid(1);
+    for (int idx = 0; idx < appArguments.size(); ++idx) {
+        const auto& argument = appArguments.at(idx);
+        if (argument == "--workers") {
+            // Skip the value too
+            ++idx;
+            continue;
+        }
+        if (argument.startsWith("--workers=")) {
+            continue;
+        }
+        arguments << argument;
+    }
+    // Overrides any --jobs option given before
+    arguments << "--jobs" << QString::number(jobs);
+
+    std::vector<std::unique_ptr<QProcess>> workers;
+    for (int idx = 0; idx < count; ++idx) {
+        auto worker = std::make_unique<QProcess>();
+        worker->setProcessChannelMode(QProcess::ForwardedChannels);
+        worker->start(QCoreApplication::applicationFilePath(), arguments);
+        if (!worker->waitForStarted(-1)) {
+            // The workers which are running, including this process, export
+            // all the shards anyway
+            qWarning() << QCoreApplication::translate("main", "Cannot start a worker: %1.")
+                              .arg(worker->errorString());
+            continue;
+        }
+        workers.push_back(std::move(worker));
+    }
+    return workers;
+}
+
+static int runBank(Arguments* args, WavSaver* saver) {
+    saver->setBits(16);
+    saver->setFormat(WavSaver::Raw);
+
+    QElapsedTimer timer;
+    timer.start();
+    auto result =
+        BankExport::run(*saver, &args->items, args->jobs, args->bankEncoding, args->bankPath);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    int failureCount = BatchExport::reportErrors(args->items);
+    if (!result) {
+        qCritical("%s", qUtf8Printable(result.message()));
+        return 1;
+    }
+    if (args->items.size() > 1) {
+        BatchExport::printSummary(args->items, elapsed);
+    }
+    return failureCount > 0 ? 1 : 0;
+}
+
+static int runParamBank(Arguments* args) {
+    QVector<SoundParams> params(args->items.size());
+    args->items.detach();
+    Parallel::forEachIndex(args->items.size(), args->jobs, [args, &params](int index) {
+        auto* item = &args->items[index];
+        item->result = BatchExport::loadParams(*item, &params[index]);
+    });
+
+    ParamBankWriter writer;
+    for (int idx = 0; idx < args->items.size(); ++idx) {
+        const auto& item = args->items.at(idx);
+        if (item.result) {
+            writer.addSound(
+                BatchExport::soundName(item), params.at(idx), item.tags + args->paramBankTags);
+        }
+    }
+    auto result = writer.write(args->paramBankPath);
+
+    int failureCount = BatchExport::reportErrors(args->items);
+    if (!result) {
+        qCritical("%s", qUtf8Printable(result.message()));
+        return 1;
+    }
+    return failureCount > 0 ? 1 : 0;
+}
+
+static int runManifest(const Arguments& args, const WavSaver& saver) {
+    // This process is one of the workers
+    auto workers = startWorkers(args.workerCount - 1, args.jobs);
+    int exitCode = ShardedExport::run(args.shardedExportOptions, saver);
+    for (const auto& worker : workers) {
+        worker->waitForFinished(-1);
+        if (worker->exitStatus() != QProcess::NormalExit || worker->exitCode() != 0) {
+            exitCode = 1;
+        }
+    }
+    return exitCode;
+}
+
+/**
+ * Applies the global output settings to `saver`, then the ones of `spec` if
+ * it is not null
+ */
+static void configureSaver(WavSaver* saver, const Arguments& args, const OutputSpec* spec) {
+    auto bits = spec && spec->bits.has_value() ? spec->bits : args.outputBits;
+    if (bits.has_value()) {
+        saver->setBits(bits.value());
+    }
+    auto frequency = spec && spec->frequency.has_value() ? spec->frequency : args.outputFrequency;
+    if (frequency.has_value()) {
+        saver->setFrequency(frequency.value());
+    }
+    saver->setFormat(spec && spec->format.has_value() ? spec->format.value()
+                                                      : args.outputFormat);
+    // When there is only one sound to export, use the threads to encode it
+    if (args.items.size() == 1) {
+        saver->setJobs(args.jobs);
+    }
+}
+
+int run(const QCommandLineParser& parser) {
+    auto maybeArgs = Arguments::parse(parser);
+    if (!maybeArgs.has_value()) {
+        return 1;
+    }
+    auto& args = maybeArgs.value();
+
+    WavSaver saver;
+    configureSaver(&saver, args, args.outputSpecs.isEmpty() ? nullptr : &args.outputSpecs.first());
+
+    // The first output spec is handled by `saver`, the others are variants
+    std::vector<std::unique_ptr<WavSaver>> variantSavers;
+    for (int idx = 1; idx < args.outputSpecs.size(); ++idx) {
+        auto variantSaver = std::make_unique<WavSaver>();
+        configureSaver(variantSaver.get(), args, &args.outputSpecs.at(idx));
+        variantSavers.push_back(std::move(variantSaver));
+    }
+    for (auto& item : args.items) {
+        for (int idx = 0; idx < item.variants.size(); ++idx) {
+            item.variants[idx].saver = variantSavers.at(idx).get();
+        }
+    }
+
+    RenderCache renderCache;
+    if (!args.cacheDir.isEmpty()) {
+        auto result = renderCache.open(args.cacheDir);
+        if (!result) {
+            qCritical("%s", qUtf8Printable(result.message()));
+            return 1;
+        }
+        saver.setRenderCache(&renderCache);
+        for (auto& variantSaver : variantSavers) {
+            variantSaver->setRenderCache(&renderCache);
+        }
+    }
+
+    if (parser.isSet("manifest")) {
+        return runManifest(args, saver);
+    }
+
+    if (!args.bankPath.isEmpty()) {
+        return runBank(&args, &saver);
+    }
+
+    if (!args.paramBankPath.isEmpty()) {
+        return runParamBank(&args);
+    }
+
+    if (parser.isSet("watch")) {
+        SoundWatcher watcher(parser.value("watch"), args.outputDir, &saver, args.jobs);
+        watcher.start();
+        return QCoreApplication::exec();
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    BatchExport::run(saver, &args.items, args.jobs);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    int failureCount = BatchExport::reportErrors(args.items);
+    if (args.items.size() > 1) {
+        BatchExport::printSummary(args.items, elapsed);
+    }
+    return failureCount > 0 ? 1 : 0;
+}
+
+} // namespace ExportCommand
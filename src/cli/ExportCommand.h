@@ -0,0 +1,26 @@
+#ifndef EXPORTCOMMAND_H
+#define EXPORTCOMMAND_H
+
+class QCommandLineParser;
+
+/**
+ * Implementation of the wav export from the command line, shared by the app
+ * and the sfxr-render tool.
+ *
+ * Only depends on the core library: it does not need a graphical environment
+ * nor an audio device.
+ */
+namespace ExportCommand {
+
+void addOptions(QCommandLineParser* parser);
+
+/**
+ * Exports the sound files passed as positional arguments or listed in a
+ * manifest, or watches a directory with --watch. Returns the exit code of the
+ * process.
+ */
+int run(const QCommandLineParser& parser);
+
+} // namespace ExportCommand
+
+#endif // EXPORTCOMMAND_H
@@ -0,0 +1,150 @@
+#include "FitCommand.h"
+
+#include "CommandLineUtils.h"
+#include "Random.h"
+#include "Sound.h"
+#include "SoundFitter.h"
+#include "SoundIO.h"
+#include "WavReader.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QThread>
+#include <QUrl>
+
+#include <optional>
+
+using std::optional;
+
+namespace FitCommand {
+
+// Minimum delay between two progress messages, in milliseconds
+static const qint64 PROGRESS_INTERVAL = 2000;
+
+struct Arguments {
+    QString targetPath;
+    QString outputPath;
+    SoundFitter::Options options;
+
+    static optional<Arguments> parse(const QCommandLineParser& parser) {
+        Arguments instance;
+        if (!parser.positionalArguments().isEmpty() || parser.isSet("generate")
+            || parser.isSet("library") || parser.isSet("dedup")) {
+            qCritical() << QCoreApplication::translate(
+                "main",
+                "Input files, --generate, --library and --dedup cannot be used with --fit.");
+            return {};
+        }
+        instance.targetPath = parser.value("fit");
+        if (parser.values("output").size() > 1) {
+            qCritical() << QCoreApplication::translate(
+                "main", "--output can only be used once with --fit.");
+            return {};
+        }
+        if (parser.isSet("output")) {
+            instance.outputPath = parser.value("output");
+        } else {
+            QFileInfo info(instance.targetPath);
+            instance.outputPath = info.dir().filePath(info.completeBaseName() + ".sfxj");
+        }
+
+        auto& options = instance.options;
+        options.jobs = QThread::idealThreadCount();
+        if (!CommandLineUtils::parsePositiveInt(parser, "evaluations", &options.maxEvaluations)
+            || !CommandLineUtils::parsePositiveInt(parser, "jobs", &options.jobs)) {
+            return {};
+        }
+        if (parser.isSet("seed")) {
+            bool ok;
+            options.seed = parser.value("seed").toULongLong(&ok);
+            if (!ok) {
+                qCritical() << QCoreApplication::translate("main", "Invalid value for --seed.");
+                return {};
+            }
+        } else {
+            options.seed = Random::randomSeed();
+        }
+        return instance;
+    }
+};
+
+void addOptions(QCommandLineParser* parser) {
+    parser->addOption(
+        {"fit",
+         QCoreApplication::translate(
+             "main",
+             "Searches the sound whose spectrum is the closest to the given wav file, and saves "
+             "it as a sfxj file: the path given with --output, or the path of the wav file with "
+             "a .sfxj extension."),
+         "wav_file"});
+    parser->addOption(
+        {"evaluations",
+         QCoreApplication::translate("main",
+                                     "Number of sounds to synthesize and compare with the wav "
+                                     "file of --fit. Higher values find closer sounds, but take "
+                                     "longer. Defaults to %1.")
+             .arg(SoundFitter::DEFAULT_MAX_EVALUATIONS),
+         "number"});
+}
+
+int run(const QCommandLineParser& parser) {
+    auto maybeArgs = Arguments::parse(parser);
+    if (!maybeArgs.has_value()) {
+        return 1;
+    }
+    auto args = maybeArgs.value();
+
+    QVector<qreal> target;
+    auto result = WavReader::load(args.targetPath, &target);
+    if (!result) {
+        qCritical("%s: %s", qUtf8Printable(args.targetPath), qUtf8Printable(result.message()));
+        return 1;
+    }
+    if (target.isEmpty()) {
+        qCritical() << QCoreApplication::translate("main", "%1 has no samples.")
+                           .arg(args.targetPath);
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    qint64 lastProgress = 0;
+    args.options.progress = [&timer, &lastProgress](int evaluationCount, qreal distance) {
+        if (timer.elapsed() - lastProgress < PROGRESS_INTERVAL) {
+            return;
+        }
+        lastProgress = timer.elapsed();
+        auto message = QCoreApplication::translate("main", "%1 evaluations, distance: %2 dB")
+                           .arg(evaluationCount)
+                           .arg(distance, 0, 'f', 2);
+        qInfo("%s", qUtf8Printable(message));
+    };
+    auto fit = SoundFitter::fit(target, args.options);
+    qreal seconds = qMax(timer.nsecsElapsed(), qint64(1)) / 1e9;
+
+    auto message =
+        QCoreApplication::translate(
+            "main",
+            "Evaluated %1 sounds in %2 s (%3 evaluations/s), with seed %4. Distance: %5 dB.")
+            .arg(fit.evaluationCount)
+            .arg(seconds, 0, 'f', 2)
+            .arg(fit.evaluationCount / seconds, 0, 'f', 1)
+            .arg(args.options.seed)
+            .arg(fit.distance, 0, 'f', 2);
+    qInfo("%s", qUtf8Printable(message));
+
+    Sound sound;
+    fit.params.applyTo(&sound);
+    result = SoundIO::save(&sound, QUrl::fromLocalFile(args.outputPath));
+    if (!result) {
+        qCritical("%s: %s", qUtf8Printable(args.outputPath), qUtf8Printable(result.message()));
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace FitCommand
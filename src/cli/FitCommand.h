@@ -0,0 +1,24 @@
+#ifndef FITCOMMAND_H
+#define FITCOMMAND_H
+
+class QCommandLineParser;
+
+/**
+ * Searches the synthesis parameters which best reproduce a wav file, from the
+ * command line, using SoundFitter, and saves them as a .sfxj file.
+ *
+ * Shares --output and --jobs with ExportCommand, and --seed with
+ * GenerateCommand, so its options must be added to the same parser.
+ */
+namespace FitCommand {
+
+void addOptions(QCommandLineParser* parser);
+
+/**
+ * Returns the exit code of the process
+ */
+int run(const QCommandLineParser& parser);
+
+} // namespace FitCommand
+
+#endif // FITCOMMAND_H
@@ -0,0 +1,245 @@
+#include "GenerateCommand.h"
+
+#include "BatchExport.h"
+#include "BatchGenerator.h"
+#include "CommandLineUtils.h"
+#include "Parallel.h"
+#include "Random.h"
+#include "Sound.h"
+#include "SoundIO.h"
+#include "WavSaver.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <optional>
+
+using std::optional;
+
+namespace GenerateCommand {
+
+static const int DEFAULT_COUNT = 10;
+
+// Default maximum number of attempts per requested sound
+static const int DEFAULT_ATTEMPTS_PER_SOUND = 100;
+
+static bool parseReal(const QCommandLineParser& parser,
+                      const QString& name,
+                      optional<qreal>* value) {
+    if (!parser.isSet(name)) {
+        return true;
+    }
+    bool ok;
+    qreal real = parser.value(name).toDouble(&ok);
+    if (!ok) {
+        qCritical() << QCoreApplication::translate("main", "Invalid value for --%1.").arg(name);
+        return false;
+    }
+    *value = real;
+    return true;
+}
+
+struct Arguments {
+    QString category;
+    QString outputDir;
+    BatchGenerator::Options options;
+
+    static optional<Arguments> parse(const QCommandLineParser& parser) {
+        Arguments instance;
+        if (!parser.positionalArguments().isEmpty() || parser.isSet("output")
+            || parser.isSet("manifest") || parser.isSet("watch")) {
+            qCritical() << QCoreApplication::translate(
+                "main", "Input files, --output, --manifest and --watch cannot be used with "
+                        "--generate.");
+            return {};
+        }
+
+        auto& options = instance.options;
+        instance.category = parser.value("generate");
+        options.generate = BatchGenerator::generateFunction(instance.category);
+        if (!options.generate) {
+            qCritical() << QCoreApplication::translate(
+                               "main", "Invalid category. Supported values are %1.")
+                               .arg(BatchGenerator::categories().join(", "));
+            return {};
+        }
+
+        options.count = DEFAULT_COUNT;
+        options.jobs = QThread::idealThreadCount();
+        if (!CommandLineUtils::parsePositiveInt(parser, "count", &options.count)
+            || !CommandLineUtils::parsePositiveInt(parser, "jobs", &options.jobs)) {
+            return {};
+        }
+        options.maxAttempts = options.count * DEFAULT_ATTEMPTS_PER_SOUND;
+        if (!CommandLineUtils::parsePositiveInt(parser, "max-attempts", &options.maxAttempts)) {
+            return {};
+        }
+
+        if (parser.isSet("seed")) {
+            bool ok;
+            options.seed = parser.value("seed").toULongLong(&ok);
+            if (!ok) {
+                qCritical() << QCoreApplication::translate("main", "Invalid value for --seed.");
+                return {};
+            }
+        } else {
+            options.seed = Random::randomSeed();
+        }
+
+        auto& constraints = options.constraints;
+        if (!parseReal(parser, "min-duration", &constraints.minDuration)
+            || !parseReal(parser, "max-duration", &constraints.maxDuration)
+            || !parseReal(parser, "min-peak", &constraints.minPeak)
+            || !parseReal(parser, "max-peak", &constraints.maxPeak)
+            || !parseReal(parser, "min-centroid", &constraints.minSpectralCentroid)
+            || !parseReal(parser, "max-centroid", &constraints.maxSpectralCentroid)) {
+            return {};
+        }
+        constraints.allowClipping = !parser.isSet("no-clipping");
+
+        QDir outputDir(parser.isSet("output-dir") ? parser.value("output-dir") : ".");
+        if (!outputDir.mkpath(".")) {
+            qCritical() << QCoreApplication::translate("main", "Cannot create directory %1.")
+                               .arg(outputDir.path());
+            return {};
+        }
+        instance.outputDir = outputDir.path();
+        return instance;
+    }
+};
+
+void addOptions(QCommandLineParser* parser) {
+    parser->addOption(
+        {"generate",
+         QCoreApplication::translate("main",
+                                     "Generates random sounds of the given category, instead of "
+                                     "exporting files. Only the sounds matching the --min-* and "
+                                     "--max-* constraints are kept, and saved as sfxj and wav "
+                                     "files. Categories are %1.")
+             .arg(BatchGenerator::categories().join(", ")),
+         "category"});
+    parser->addOption(
+        {"count",
+         QCoreApplication::translate("main", "Number of sounds to generate. Defaults to %1.")
+             .arg(DEFAULT_COUNT),
+         "number"});
+    parser->addOption(
+        {"seed",
+         QCoreApplication::translate("main",
+                                     "Seed of the random generator. The same seed and "
+                                     "constraints generate the same sounds. Defaults to a random "
+                                     "seed, which is printed."),
+         "number"});
+    parser->addOption(
+        {"max-attempts",
+         QCoreApplication::translate("main",
+                                     "Maximum number of sounds to try before giving up. "
+                                     "Defaults to %1 times --count.")
+             .arg(DEFAULT_ATTEMPTS_PER_SOUND),
+         "number"});
+    parser->addOption(
+        {"min-duration",
+         QCoreApplication::translate("main", "Minimum duration of the sounds, in seconds."),
+         "seconds"});
+    parser->addOption(
+        {"max-duration",
+         QCoreApplication::translate("main", "Maximum duration of the sounds, in seconds."),
+         "seconds"});
+    parser->addOption(
+        {"min-peak",
+         QCoreApplication::translate(
+             "main", "Minimum peak level of the sounds, 1 being the highest exported level."),
+         "level"});
+    parser->addOption(
+        {"max-peak",
+         QCoreApplication::translate("main", "Maximum peak level of the sounds."),
+         "level"});
+    parser->addOption(
+        {"min-centroid",
+         QCoreApplication::translate(
+             "main",
+             "Minimum spectral centroid of the sounds, in Hz. Higher values sound brighter."),
+         "hz"});
+    parser->addOption(
+        {"max-centroid",
+         QCoreApplication::translate("main", "Maximum spectral centroid of the sounds, in Hz."),
+         "hz"});
+    parser->addOption(
+        {"no-clipping",
+         QCoreApplication::translate("main", "Rejects the sounds whose samples are clipped.")});
+}
+
+/**
+ * Saves the accepted sounds as sfxj and wav files, in parallel. Returns the
+ * number of failures.
+ */
+static int saveCandidates(const Arguments& args,
+                          const QVector<BatchGenerator::Candidate>& candidates) {
+    QDir dir(args.outputDir);
+    QVector<ExportItem> items(candidates.size());
+    for (int idx = 0; idx < candidates.size(); ++idx) {
+        // Name the files after their attempt, so that they keep their names
+        // when running again with the same seed and a higher count
+        int attempt = candidates.at(idx).attempt;
+        auto name = QString("%1-%2").arg(args.category).arg(attempt, 5, 10, QChar('0'));
+        items[idx].url = QUrl::fromLocalFile(dir.absoluteFilePath(name + ".sfxj"));
+        items[idx].outputPath = dir.absoluteFilePath(name + ".wav");
+    }
+
+    WavSaver saver;
+    ExportItem* itemData = items.data();
+    Parallel::forEachIndex(
+        items.size(), args.options.jobs, [&candidates, &saver, itemData](int index) {
+            auto* item = itemData + index;
+            const auto& params = candidates.at(index).params;
+            Sound sound;
+            params.applyTo(&sound);
+            item->result = SoundIO::save(&sound, item->url);
+            if (item->result) {
+                item->result = saver.save(params, item->outputPath, &item->sampleCount);
+            }
+        });
+    return BatchExport::reportErrors(items);
+}
+
+int run(const QCommandLineParser& parser) {
+    auto maybeArgs = Arguments::parse(parser);
+    if (!maybeArgs.has_value()) {
+        return 1;
+    }
+    const auto& args = maybeArgs.value();
+
+    QElapsedTimer timer;
+    timer.start();
+    int attemptCount;
+    auto candidates = BatchGenerator::run(args.options, &attemptCount);
+    qreal seconds = qMax(timer.nsecsElapsed(), qint64(1)) / 1e9;
+
+    auto message = QCoreApplication::translate(
+                       "main", "Accepted %1 of %2 sounds in %3 s (%4 sounds/s), with seed %5.")
+                       .arg(candidates.size())
+                       .arg(attemptCount)
+                       .arg(seconds, 0, 'f', 2)
+                       .arg(attemptCount / seconds, 0, 'f', 1)
+                       .arg(args.options.seed);
+    qInfo("%s", qUtf8Printable(message));
+
+    if (saveCandidates(args, candidates) > 0) {
+        return 1;
+    }
+    if (candidates.size() < args.options.count) {
+        qCritical() << QCoreApplication::translate(
+                           "main",
+                           "Only %1 sounds match the constraints. Relax them, or increase "
+                           "--max-attempts.")
+                           .arg(candidates.size());
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace GenerateCommand
@@ -0,0 +1,25 @@
+#ifndef GENERATECOMMAND_H
+#define GENERATECOMMAND_H
+
+class QCommandLineParser;
+
+/**
+ * Generates many random sounds from the command line, keeping the ones which
+ * match constraints on their duration, level and spectrum. Accepted sounds are
+ * written as .sfxj files, and exported as wav files.
+ *
+ * Shares --output-dir and --jobs with ExportCommand, so its options must be
+ * added to the same parser.
+ */
+namespace GenerateCommand {
+
+void addOptions(QCommandLineParser* parser);
+
+/**
+ * Returns the exit code of the process
+ */
+int run(const QCommandLineParser& parser);
+
+} // namespace GenerateCommand
+
+#endif // GENERATECOMMAND_H
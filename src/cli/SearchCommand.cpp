@@ -0,0 +1,174 @@
+#include "SearchCommand.h"
+
+#include "CommandLineUtils.h"
+#include "FeatureIndex.h"
+#include "SoundFeatures.h"
+#include "SoundIO.h"
+#include "SoundParams.h"
+#include "WavReader.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <QUrl>
+
+#include <optional>
+
+using std::optional;
+
+namespace SearchCommand {
+
+static const int DEFAULT_NEIGHBOR_COUNT = 20;
+
+struct Arguments {
+    QString libraryDir;
+    QString indexPath;
+    QString queryPath;
+    int neighborCount = DEFAULT_NEIGHBOR_COUNT;
+    int jobs = QThread::idealThreadCount();
+
+    static optional<Arguments> parse(const QCommandLineParser& parser) {
+        Arguments instance;
+        if (!parser.positionalArguments().isEmpty() || parser.isSet("output")
+            || parser.isSet("generate")) {
+            qCritical() << QCoreApplication::translate(
+                "main", "Input files, --output and --generate cannot be used with --library.");
+            return {};
+        }
+        instance.libraryDir = parser.value("library");
+        if (!QFileInfo(instance.libraryDir).isDir()) {
+            qCritical() << QCoreApplication::translate("main", "%1 is not a directory.")
+                               .arg(instance.libraryDir);
+            return {};
+        }
+        instance.indexPath = parser.isSet("index") ? parser.value("index")
+                                                   : FeatureIndex::defaultPath(instance.libraryDir);
+        if (parser.isSet("find-similar")) {
+            instance.queryPath = QFileInfo(parser.value("find-similar")).absoluteFilePath();
+        }
+        if (!CommandLineUtils::parsePositiveInt(parser, "neighbors", &instance.neighborCount)
+            || !CommandLineUtils::parsePositiveInt(parser, "jobs", &instance.jobs)) {
+            return {};
+        }
+        return instance;
+    }
+};
+
+void addOptions(QCommandLineParser* parser) {
+    parser->addOption(
+        {"library",
+         QCoreApplication::translate(
+             "main",
+             "Indexes the acoustic features of the sound files in the given directory and its "
+             "subdirectories, to search them with --find-similar. Only the new and modified "
+             "files are synthesized again."),
+         "dir"});
+    parser->addOption(
+        {"find-similar",
+         QCoreApplication::translate("main",
+                                     "Prints the sounds of --library which sound the closest to "
+                                     "the given sound file or wav file, closest first."),
+         "file"});
+    parser->addOption(
+        {"neighbors",
+         QCoreApplication::translate(
+             "main", "Number of sounds printed by --find-similar. Defaults to %1.")
+             .arg(DEFAULT_NEIGHBOR_COUNT),
+         "number"});
+    parser->addOption(
+        {"index",
+         QCoreApplication::translate("main",
+                                     "Path of the feature index of --library. Defaults to a file "
+                                     "in the cache directory."),
+         "file"});
+}
+
+/**
+ * Computes the features of the sound or wav file at `path`
+ */
+static Result loadQueryFeatures(const QString& path, SoundFeatures* features) {
+    if (QFileInfo(path).suffix().toLower() == "wav") {
+        QVector<qreal> samples;
+        auto result = WavReader::load(path, &samples);
+        if (result) {
+            *features = SoundFeatures::fromSamples(samples);
+        }
+        return result;
+    }
+    SoundParams params;
+    auto result = SoundIO::load(&params, QUrl::fromLocalFile(path));
+    if (result) {
+        *features = SoundFeatures::fromParams(params);
+    }
+    return result;
+}
+
+int run(const QCommandLineParser& parser) {
+    auto maybeArgs = Arguments::parse(parser);
+    if (!maybeArgs.has_value()) {
+        return 1;
+    }
+    const auto& args = maybeArgs.value();
+
+    QElapsedTimer timer;
+    timer.start();
+    FeatureIndex index;
+    if (QFileInfo::exists(args.indexPath)) {
+        auto result = index.load(args.indexPath);
+        if (!result) {
+            // Rebuild it
+            qWarning("%s", qUtf8Printable(result.message()));
+        }
+    }
+    QStringList errors;
+    int updatedCount =
+        index.update(FeatureIndex::findSoundFiles(args.libraryDir), args.jobs, &errors);
+    for (const auto& error : errors) {
+        qCritical("%s", qUtf8Printable(error));
+    }
+    if (updatedCount > 0) {
+        auto result = index.save(args.indexPath);
+        if (!result) {
+            qCritical("%s", qUtf8Printable(result.message()));
+            return 1;
+        }
+    }
+    auto message = QCoreApplication::translate(
+                       "main", "Indexed %1 sounds in %2 s, %3 of them were synthesized.")
+                       .arg(index.count())
+                       .arg(timer.nsecsElapsed() / 1e9, 0, 'f', 2)
+                       .arg(updatedCount);
+    qInfo("%s", qUtf8Printable(message));
+
+    if (args.queryPath.isEmpty()) {
+        return errors.isEmpty() ? 0 : 1;
+    }
+
+    SoundFeatures features;
+    auto result = loadQueryFeatures(args.queryPath, &features);
+    if (!result) {
+        qCritical("%s: %s", qUtf8Printable(args.queryPath), qUtf8Printable(result.message()));
+        return 1;
+    }
+    timer.restart();
+    auto matches = index.findNearest(
+        FeatureIndex::featureVector(features), args.neighborCount, args.queryPath);
+    qint64 elapsed = timer.nsecsElapsed();
+
+    QTextStream out(stdout);
+    for (const auto& match : matches) {
+        out << QString::number(match.distance, 'f', 3) << '\t' << match.path << '\n';
+    }
+    out.flush();
+    message = QCoreApplication::translate("main", "Searched %1 sounds in %2 ms.")
+                  .arg(index.count())
+                  .arg(elapsed / 1e6, 0, 'f', 2);
+    qInfo("%s", qUtf8Printable(message));
+    return errors.isEmpty() ? 0 : 1;
+}
+
+} // namespace SearchCommand
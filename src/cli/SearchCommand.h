@@ -0,0 +1,28 @@
+#ifndef SEARCHCOMMAND_H
+#define SEARCHCOMMAND_H
+
+class QCommandLineParser;
+
+/**
+ * Finds the sounds of a library which sound the closest to a sound file or a
+ * wav file, from the command line.
+ *
+ * The features of the library sounds are stored in a FeatureIndex, which is
+ * updated before each search: only the new and modified files are
+ * synthesized again.
+ *
+ * Shares --jobs with ExportCommand, so its options must be added to the same
+ * parser.
+ */
+namespace SearchCommand {
+
+void addOptions(QCommandLineParser* parser);
+
+/**
+ * Returns the exit code of the process
+ */
+int run(const QCommandLineParser& parser);
+
+} // namespace SearchCommand
+
+#endif // SEARCHCOMMAND_H
@@ -0,0 +1,260 @@
+#include "ShardedExport.h"
+
+#include "BatchExport.h"
+#include "WavSaver.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QLockFile>
+#include <QMutex>
+#include <QSet>
+#include <QSettings>
+
+#include <optional>
+
+using std::optional;
+
+namespace ShardedExport {
+
+// Number of items per shard when the shard count is not specified
+static constexpr int DEFAULT_SHARD_SIZE = 100;
+
+// A shard lock older than this is considered as left by a crashed worker, even
+// if the worker ran on another host. Workers refresh the locks of the shards
+// they export much more often than that.
+static constexpr int STALE_LOCK_TIME_MS = 5 * 60 * 1000;
+static constexpr int LOCK_REFRESH_INTERVAL_MS = 60 * 1000;
+
+static optional<QVector<ExportItem>>
+loadManifest(const QString& path, const QString& outputDir, const QString& extension) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCritical() << QCoreApplication::translate("main", "Cannot open %1: %2.")
+                           .arg(path)
+                           .arg(file.errorString());
+        return {};
+    }
+    QDir baseDir = QFileInfo(path).absoluteDir();
+    QVector<ExportItem> items;
+    QSet<QString> outputPaths;
+    for (int lineNumber = 1; !file.atEnd(); ++lineNumber) {
+        auto line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        auto fields = line.split('\t');
+        if (fields.size() > 2) {
+            qCritical() << QCoreApplication::translate("main", "%1:%2: Invalid line.")
+                               .arg(path)
+                               .arg(lineNumber);
+            return {};
+        }
+        ExportItem item;
+        auto inputPath = baseDir.absoluteFilePath(fields.at(0));
+        item.url = QUrl::fromLocalFile(inputPath);
+        item.outputPath = fields.size() == 2
+                              ? baseDir.absoluteFilePath(fields.at(1))
+                              : BatchExport::defaultOutputPath(inputPath, outputDir, extension);
+        if (outputPaths.contains(item.outputPath)) {
+            qCritical() << QCoreApplication::translate(
+                               "main", "%1:%2: Several input files would be exported to %3.")
+                               .arg(path)
+                               .arg(lineNumber)
+                               .arg(item.outputPath);
+            return {};
+        }
+        outputPaths.insert(item.outputPath);
+        items << item;
+    }
+    return items;
+}
+
+/**
+ * All workers must split the manifest the same way: the first worker stores
+ * the layout in the work directory, the others reuse it.
+ *
+ * Returns the shard count to use.
+ */
+static optional<int> loadLayout(const QDir& workDir, int itemCount, int shardCount) {
+    // Workers usually start at the same time: make sure only one of them
+    // creates the layout
+    auto lockPath = workDir.filePath("layout.lock");
+    QLockFile lock(lockPath);
+    if (!lock.lock()) {
+        qCritical() << QCoreApplication::translate("main", "Cannot lock %1.").arg(lockPath);
+        return {};
+    }
+    QSettings settings(workDir.filePath("layout.ini"), QSettings::IniFormat);
+    if (!settings.contains("itemCount")) {
+        if (shardCount == 0) {
+            shardCount = qMax(1, (itemCount + DEFAULT_SHARD_SIZE - 1) / DEFAULT_SHARD_SIZE);
+        }
+        settings.setValue("itemCount", itemCount);
+        settings.setValue("shardCount", shardCount);
+        settings.sync();
+        return shardCount;
+    }
+    int storedShardCount = settings.value("shardCount").toInt();
+    if (settings.value("itemCount").toInt() != itemCount
+        || (shardCount != 0 && shardCount != storedShardCount)) {
+        qCritical() << QCoreApplication::translate("main",
+                                                   "The work directory %1 has been created for a "
+                                                   "different manifest or shard count. Remove it "
+                                                   "to start from scratch.")
+                           .arg(workDir.path());
+        return {};
+    }
+    return storedShardCount;
+}
+
+static QSet<int> readJournal(const QString& path) {
+    QSet<int> indices;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return indices;
+    }
+    while (!file.atEnd()) {
+        bool ok;
+        int index = file.readLine().trimmed().toInt(&ok);
+        // The last line can be truncated if the worker crashed: ignore it
+        if (ok) {
+            indices.insert(index);
+        }
+    }
+    return indices;
+}
+
+static bool touch(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly);
+}
+
+/**
+ * Updates the modification time of the lock file at `path`, so that other
+ * workers do not consider it as stale
+ */
+static void refreshLock(const QString& path) {
+    QFile file(path);
+    if (file.open(QIODevice::Append)) {
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    }
+}
+
+int run(const Options& options, const WavSaver& saver) {
+    auto extension = WavSaver::fileExtension(saver.format());
+    auto maybeItems = loadManifest(options.manifestPath, options.outputDir, extension);
+    if (!maybeItems.has_value()) {
+        return 1;
+    }
+    const auto& items = maybeItems.value();
+
+    QDir workDir(options.workDir.isEmpty() ? options.manifestPath + ".work" : options.workDir);
+    if (!workDir.mkpath(".")) {
+        qCritical() << QCoreApplication::translate("main", "Cannot create directory %1.")
+                           .arg(workDir.path());
+        return 1;
+    }
+    auto maybeShardCount = loadLayout(workDir, items.size(), options.shardCount);
+    if (!maybeShardCount.has_value()) {
+        return 1;
+    }
+    int shardCount = maybeShardCount.value();
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<ExportItem> exportedItems;
+    int failureCount = 0;
+    int doneShardCount = 0;
+    for (int shard = 0; shard < shardCount; ++shard) {
+        auto shardName = QString("shard-%1").arg(shard);
+        auto donePath = workDir.filePath(shardName + ".done");
+        if (QFile::exists(donePath)) {
+            ++doneShardCount;
+            continue;
+        }
+
+        auto lockPath = workDir.filePath(shardName + ".lock");
+        QLockFile lock(lockPath);
+        lock.setStaleLockTime(STALE_LOCK_TIME_MS);
+        if (!lock.tryLock(0)) {
+            // Another worker is taking care of this shard
+            continue;
+        }
+        if (QFile::exists(donePath)) {
+            // Finished by another worker since we checked
+            ++doneShardCount;
+            continue;
+        }
+
+        auto journalPath = workDir.filePath(shardName + ".journal");
+        QSet<int> journal = readJournal(journalPath);
+        QFile journalFile(journalPath);
+        if (!journalFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
+            qCritical() << QCoreApplication::translate("main", "Cannot open %1: %2.")
+                               .arg(journalPath)
+                               .arg(journalFile.errorString());
+            return 1;
+        }
+
+        // Skip items exported by a previous run
+        int begin = int(qint64(shard) * items.size() / shardCount);
+        int end = int(qint64(shard + 1) * items.size() / shardCount);
+        QVector<ExportItem> shardItems;
+        QVector<int> itemIndices;
+        for (int idx = begin; idx < end; ++idx) {
+            if (journal.contains(idx) && QFile::exists(items.at(idx).outputPath)) {
+                continue;
+            }
+            shardItems << items.at(idx);
+            itemIndices << idx;
+        }
+
+        QMutex journalMutex;
+        QElapsedTimer lockRefreshTimer;
+        lockRefreshTimer.start();
+        BatchExport::run(
+            saver,
+            &shardItems,
+            options.jobs,
+            [&journalFile, &journalMutex, &itemIndices, &lockRefreshTimer, &lockPath](
+                int index, const ExportItem& item) {
+                QMutexLocker locker(&journalMutex);
+                if (lockRefreshTimer.elapsed() > LOCK_REFRESH_INTERVAL_MS) {
+                    refreshLock(lockPath);
+                    lockRefreshTimer.restart();
+                }
+                if (!item.result) {
+                    return;
+                }
+                journalFile.write(QByteArray::number(itemIndices.at(index)) + '\n');
+                journalFile.flush();
+            });
+
+        int shardFailureCount = BatchExport::reportErrors(shardItems);
+        failureCount += shardFailureCount;
+        exportedItems << shardItems;
+        if (shardFailureCount == 0) {
+            // Failed items are retried by the next run
+            if (!touch(donePath)) {
+                qCritical() << QCoreApplication::translate("main", "Cannot create %1.")
+                                   .arg(donePath);
+                return 1;
+            }
+            ++doneShardCount;
+        }
+    }
+
+    BatchExport::printSummary(exportedItems, timer.nsecsElapsed());
+    auto message = QCoreApplication::translate("main", "%1 of %2 shards done.")
+                       .arg(doneShardCount)
+                       .arg(shardCount);
+    qInfo("%s", qUtf8Printable(message));
+    return failureCount > 0 ? 1 : 0;
+}
+
+} // namespace ShardedExport
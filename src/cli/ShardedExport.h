@@ -0,0 +1,44 @@
+#ifndef SHARDEDEXPORT_H
+#define SHARDEDEXPORT_H
+
+#include <QString>
+
+class WavSaver;
+
+/**
+ * Exports the sound files listed in a manifest, split in shards.
+ *
+ * Several worker processes, possibly running on different machines sharing
+ * the work directory, can run on the same manifest: each worker claims
+ * shards by locking them in the work directory, so that a shard is only
+ * exported by one worker. The locks of workers which crashed are reclaimed
+ * after a few minutes.
+ *
+ * Each exported item is recorded in the journal of its shard, and shards
+ * which are fully exported are marked as done. If a run is interrupted, the
+ * next one skips the work which has already been done.
+ *
+ * The manifest is a text file with one input file per line, optionally
+ * followed by a tab and the output path. Relative paths are relative to the
+ * manifest directory. Empty lines and lines starting with '#' are ignored.
+ */
+namespace ShardedExport {
+
+struct Options {
+    QString manifestPath;
+    // Defaults to the manifest path, with a ".work" suffix
+    QString workDir;
+    // 0 means let ShardedExport decide
+    int shardCount = 0;
+    QString outputDir;
+    int jobs = 1;
+};
+
+/**
+ * Runs a worker. Returns the exit code of the process.
+ */
+int run(const Options& options, const WavSaver& saver);
+
+} // namespace ShardedExport
+
+#endif // SHARDEDEXPORT_H
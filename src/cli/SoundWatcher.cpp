@@ -0,0 +1,173 @@
+#include "SoundWatcher.h"
+
+#include "BatchExport.h"
+#include "Result.h"
+#include "SoundIO.h"
+#include "SoundParams.h"
+#include "Synthesizer.h"
+#include "WavSaver.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+
+// Wait for writes to settle before exporting: editors often save a file in
+// several steps
+static constexpr int DEBOUNCE_INTERVAL_MS = 300;
+
+static const QStringList SOUND_NAME_FILTERS = {"*.sfxr", "*.sfxj"};
+
+static const char HASH_SUFFIX[] = ".hash";
+
+static QByteArray readHash(const QString& outputPath) {
+    QFile file(outputPath + HASH_SUFFIX);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return file.readAll().trimmed();
+}
+
+static bool writeHash(const QString& outputPath, const QByteArray& hash) {
+    QFile file(outputPath + HASH_SUFFIX);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    return file.write(hash + '\n') != -1;
+}
+
+SoundWatcher::SoundWatcher(const QString& rootDir,
+                           const QString& outputDir,
+                           const WavSaver* saver,
+                           int jobs,
+                           QObject* parent)
+        : QObject(parent)
+        , mRootDir(rootDir)
+        , mOutputDir(outputDir)
+        , mSaver(saver)
+        , mJobs(jobs) {
+    mDebounceTimer.setInterval(DEBOUNCE_INTERVAL_MS);
+    mDebounceTimer.setSingleShot(true);
+    connect(&mDebounceTimer, &QTimer::timeout, this, &SoundWatcher::processPendingChanges);
+    connect(&mWatcher,
+            &QFileSystemWatcher::directoryChanged,
+            this,
+            &SoundWatcher::onDirectoryChanged);
+    connect(&mWatcher, &QFileSystemWatcher::fileChanged, this, &SoundWatcher::onFileChanged);
+}
+
+void SoundWatcher::start() {
+    mPendingDirs.insert(mRootDir.absolutePath());
+    processPendingChanges();
+}
+
+void SoundWatcher::onDirectoryChanged(const QString& dir) {
+    mPendingDirs.insert(dir);
+    mDebounceTimer.start();
+}
+
+void SoundWatcher::onFileChanged(const QString& path) {
+    mPendingPaths.insert(path);
+    mDebounceTimer.start();
+}
+
+void SoundWatcher::scanDir(const QString& dirPath) {
+    QDir dir(dirPath);
+    if (!dir.exists()) {
+        return;
+    }
+    QStringList watchedDirs = mWatcher.directories();
+    if (!watchedDirs.contains(dirPath)) {
+        mWatcher.addPath(dirPath);
+    }
+    for (const auto& name : dir.entryList(SOUND_NAME_FILTERS, QDir::Files)) {
+        // New files need to be checked, others are cheap to check thanks to
+        // the hashes
+        mPendingPaths.insert(dir.filePath(name));
+    }
+    for (const auto& name : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        auto subDirPath = dir.filePath(name);
+        if (!watchedDirs.contains(subDirPath)) {
+            scanDir(subDirPath);
+        }
+    }
+}
+
+QString SoundWatcher::outputPathFor(const QString& path) const {
+    auto outputPath = path.section('.', 0, -2) + '.' + WavSaver::fileExtension(mSaver->format());
+    if (mOutputDir.isEmpty()) {
+        return outputPath;
+    }
+    return QDir(mOutputDir).filePath(mRootDir.relativeFilePath(outputPath));
+}
+
+QByteArray SoundWatcher::hashFor(const QString& path, QString* errorMessage) const {
+    SoundParams params;
+    if (auto result = SoundIO::load(&params, QUrl::fromLocalFile(path)); !result) {
+        *errorMessage = result.message();
+        return {};
+    }
+    // Include the export settings and the version of the synthesizer, so that
+    // changing them exports everything again
+    return QByteArray::number(params.hash(), 16) + ' ' + QByteArray::number(mSaver->bits()) + ' '
+           + QByteArray::number(mSaver->frequency()) + ' '
+           + QByteArray::number(Synthesizer::VERSION);
+}
+
+void SoundWatcher::processPendingChanges() {
+    auto pendingDirs = mPendingDirs;
+    mPendingDirs.clear();
+    for (const auto& dir : pendingDirs) {
+        scanDir(dir);
+    }
+
+    // Sort the paths to get a predictable output
+    QStringList pendingPaths = mPendingPaths.values();
+    pendingPaths.sort();
+    mPendingPaths.clear();
+    QStringList watchedFiles = mWatcher.files();
+    QVector<ExportItem> items;
+    QVector<QByteArray> hashes;
+    for (const auto& path : pendingPaths) {
+        if (!QFile::exists(path)) {
+            continue;
+        }
+        // Files replaced by a rename are not watched anymore
+        if (!watchedFiles.contains(path)) {
+            mWatcher.addPath(path);
+        }
+        ExportItem item;
+        item.url = QUrl::fromLocalFile(path);
+        item.outputPath = outputPathFor(path);
+
+        QString errorMessage;
+        auto hash = hashFor(path, &errorMessage);
+        if (hash.isEmpty()) {
+            qCritical("%s: %s", qUtf8Printable(path), qUtf8Printable(errorMessage));
+            continue;
+        }
+        if (hash == readHash(item.outputPath) && QFile::exists(item.outputPath)) {
+            continue;
+        }
+        QDir().mkpath(QFileInfo(item.outputPath).path());
+        items << item;
+        hashes << hash;
+    }
+    if (items.isEmpty()) {
+        return;
+    }
+
+    BatchExport::run(*mSaver, &items, mJobs);
+    BatchExport::reportErrors(items);
+    for (int idx = 0; idx < items.size(); ++idx) {
+        const auto& item = items.at(idx);
+        if (!item.result) {
+            continue;
+        }
+        if (!writeHash(item.outputPath, hashes.at(idx))) {
+            qWarning("Could not write the hash of %s.", qUtf8Printable(item.outputPath));
+        }
+        qInfo("%s", qUtf8Printable(QCoreApplication::translate("main", "Exported %1.")
+                                       .arg(item.outputPath)));
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef SOUNDWATCHER_H
+#define SOUNDWATCHER_H
+
+#include <QDir>
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+
+class WavSaver;
+
+/**
+ * Watches a directory tree and exports the sound files it contains each time
+ * they change.
+ *
+ * A hash of the sound parameters, of the export settings and of the
+ * synthesizer version is stored next to each exported file, so a sound is only
+ * exported again if one of them changed, even across runs.
+ */
+class SoundWatcher : public QObject {
+    Q_OBJECT
+public:
+    /**
+     * Exported files are created in `outputDir`, in the same relative
+     * directory as the sound file. If `outputDir` is empty, they are created
+     * next to the sound files.
+     */
+    SoundWatcher(const QString& rootDir,
+                 const QString& outputDir,
+                 const WavSaver* saver,
+                 int jobs,
+                 QObject* parent = nullptr);
+
+    /**
+     * Exports the sound files which changed since the last run and starts
+     * watching for changes
+     */
+    void start();
+
+private:
+    void onDirectoryChanged(const QString& dir);
+    void onFileChanged(const QString& path);
+    void scanDir(const QString& dir);
+    void processPendingChanges();
+    QString outputPathFor(const QString& path) const;
+    QByteArray hashFor(const QString& path, QString* errorMessage) const;
+
+    const QDir mRootDir;
+    const QString mOutputDir;
+    const WavSaver* const mSaver;
+    const int mJobs;
+    QFileSystemWatcher mWatcher;
+    QTimer mDebounceTimer;
+    QSet<QString> mPendingDirs;
+    QSet<QString> mPendingPaths;
+};
+
+#endif // SOUNDWATCHER_H
@@ -0,0 +1,233 @@
+#include "SweepCommand.h"
+
+#include "CommandLineUtils.h"
+#include "ContactSheet.h"
+#include "ParamSweep.h"
+#include "Result.h"
+#include "SoundIO.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThread>
+#include <QUrl>
+
+#include <optional>
+
+using std::optional;
+
+namespace SweepCommand {
+
+static const int DEFAULT_STEPS = 16;
+
+// Limits the size of the contact sheet
+static const int MAX_STEPS = 256;
+
+static const int MAX_AXIS_COUNT = 2;
+
+/**
+ * Parses an axis definition: "field:from:to", optionally followed by
+ * ":steps"
+ */
+static optional<ParamSweep::Axis> parseAxis(const QString& text) {
+    auto tokens = text.split(':');
+    if (tokens.size() < 3 || tokens.size() > 4) {
+        qCritical() << QCoreApplication::translate(
+                           "main", "Invalid axis \"%1\". It must be field:from:to[:steps].")
+                           .arg(text);
+        return {};
+    }
+    ParamSweep::Axis axis;
+    axis.field = tokens.at(0);
+    if (!ParamSweep::findField(axis.field)) {
+        QStringList names;
+        for (const auto& field : SoundParams::realFields()) {
+            names << field.name;
+        }
+        qCritical() << QCoreApplication::translate(
+                           "main", "Invalid field \"%1\". Supported fields are %2.")
+                           .arg(axis.field, names.join(", "));
+        return {};
+    }
+    bool fromOk;
+    bool toOk;
+    axis.from = tokens.at(1).toDouble(&fromOk);
+    axis.to = tokens.at(2).toDouble(&toOk);
+    if (!fromOk || !toOk) {
+        qCritical() << QCoreApplication::translate("main", "Invalid range in axis \"%1\".")
+                           .arg(text);
+        return {};
+    }
+    axis.steps = DEFAULT_STEPS;
+    if (tokens.size() == 4) {
+        bool ok;
+        axis.steps = tokens.at(3).toInt(&ok);
+        if (!ok || axis.steps < 1 || axis.steps > MAX_STEPS) {
+            qCritical() << QCoreApplication::translate(
+                               "main",
+                               "Invalid number of steps in axis \"%1\". It must be between 1 "
+                               "and %2.")
+                               .arg(text)
+                               .arg(MAX_STEPS);
+            return {};
+        }
+    }
+    return axis;
+}
+
+struct Arguments {
+    QString inputPath;
+    QString pngPath;
+    QString csvPath;
+    ParamSweep::Options options;
+
+    static optional<Arguments> parse(const QCommandLineParser& parser) {
+        Arguments instance;
+        if (!parser.positionalArguments().isEmpty() || parser.isSet("output")
+            || parser.isSet("generate") || parser.isSet("library") || parser.isSet("dedup")
+            || parser.isSet("fit")) {
+            qCritical() << QCoreApplication::translate(
+                "main",
+                "Input files, --output, --generate, --library, --dedup and --fit cannot be used "
+                "with --sweep.");
+            return {};
+        }
+        auto& options = instance.options;
+        instance.inputPath = parser.value("sweep");
+        auto result = SoundIO::load(&options.base, QUrl::fromLocalFile(instance.inputPath));
+        if (!result) {
+            qCritical("%s: %s",
+                      qUtf8Printable(instance.inputPath),
+                      qUtf8Printable(result.message()));
+            return {};
+        }
+
+        auto axisTexts = parser.values("axis");
+        if (axisTexts.isEmpty() || axisTexts.size() > MAX_AXIS_COUNT) {
+            qCritical() << QCoreApplication::translate(
+                "main", "--sweep needs one or two --axis options.");
+            return {};
+        }
+        auto columns = parseAxis(axisTexts.at(0));
+        if (!columns.has_value()) {
+            return {};
+        }
+        options.columns = columns.value();
+        if (axisTexts.size() > 1) {
+            options.rows = parseAxis(axisTexts.at(1));
+            if (!options.rows.has_value()) {
+                return {};
+            }
+        }
+
+        options.jobs = QThread::idealThreadCount();
+        if (!CommandLineUtils::parsePositiveInt(parser, "jobs", &options.jobs)) {
+            return {};
+        }
+
+        QDir outputDir(parser.isSet("output-dir") ? parser.value("output-dir") : ".");
+        if (!outputDir.mkpath(".")) {
+            qCritical() << QCoreApplication::translate("main", "Cannot create directory %1.")
+                               .arg(outputDir.path());
+            return {};
+        }
+        auto baseName = QFileInfo(instance.inputPath).completeBaseName() + "-sweep";
+        instance.pngPath = outputDir.filePath(baseName + ".png");
+        instance.csvPath = outputDir.filePath(baseName + ".csv");
+        return instance;
+    }
+};
+
+void addOptions(QCommandLineParser* parser) {
+    parser->addOption(
+        {"sweep",
+         QCoreApplication::translate(
+             "main",
+             "Renders variations of the given sound file, changing the parameters of --axis. "
+             "Writes a contact sheet image of the variations and a CSV file of their features "
+             "in --output-dir."),
+         "sound_file"});
+    parser->addOption(
+        {"axis",
+         QCoreApplication::translate(
+             "main",
+             "Parameter changed by --sweep, with its range: field:from:to[:steps], for example "
+             "slide:-0.5:0.5:32. Steps defaults to %1. The first axis goes along the columns of "
+             "the grid. Can be repeated once, for the rows.")
+             .arg(DEFAULT_STEPS),
+         "axis"});
+}
+
+/**
+ * Writes `data` to `path`. Prints an error and returns false on failure.
+ */
+static bool saveFile(const QString& path, const QByteArray& data) {
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCritical() << QCoreApplication::translate("main", "Cannot open %1: %2.")
+                           .arg(path, file.errorString());
+        return false;
+    }
+    if (file.write(data) != data.size()) {
+        qCritical() << QCoreApplication::translate("main", "Cannot write %1: %2.")
+                           .arg(path, file.errorString());
+        return false;
+    }
+    return true;
+}
+
+static QByteArray createCsv(const ParamSweep::Options& options,
+                            const QVector<ParamSweep::Cell>& cells) {
+    QByteArray csv;
+    QTextStream stream(&csv);
+    stream << "column,row," << options.columns.field;
+    if (options.rows.has_value()) {
+        stream << ',' << options.rows->field;
+    }
+    stream << ",duration,peak,rms,clipped_count,spectral_centroid,spectral_rolloff\n";
+    for (const auto& cell : cells) {
+        stream << cell.column << ',' << cell.row << ','
+               << options.columns.value(cell.column);
+        if (options.rows.has_value()) {
+            stream << ',' << options.rows->value(cell.row);
+        }
+        const auto& features = cell.features;
+        stream << ',' << features.duration << ',' << features.peak << ',' << features.rms << ','
+               << features.clippedCount << ',' << features.spectralCentroid << ','
+               << features.spectralRolloff << '\n';
+    }
+    stream.flush();
+    return csv;
+}
+
+int run(const QCommandLineParser& parser) {
+    auto maybeArgs = Arguments::parse(parser);
+    if (!maybeArgs.has_value()) {
+        return 1;
+    }
+    const auto& args = maybeArgs.value();
+    const auto& options = args.options;
+
+    QElapsedTimer timer;
+    timer.start();
+    ContactSheet sheet(options.columns.steps, options.rows.has_value() ? options.rows->steps : 1);
+    auto cells = ParamSweep::run(options, &sheet);
+    qreal seconds = qMax(timer.nsecsElapsed(), qint64(1)) / 1e9;
+
+    auto message = QCoreApplication::translate("main", "Rendered %1 sounds in %2 s (%3 sounds/s).")
+                       .arg(cells.size())
+                       .arg(seconds, 0, 'f', 2)
+                       .arg(cells.size() / seconds, 0, 'f', 1);
+    qInfo("%s", qUtf8Printable(message));
+
+    bool ok = saveFile(args.pngPath, sheet.toPng());
+    ok = saveFile(args.csvPath, createCsv(options, cells)) && ok;
+    return ok ? 0 : 1;
+}
+
+} // namespace SweepCommand
@@ -0,0 +1,25 @@
+#ifndef SWEEPCOMMAND_H
+#define SWEEPCOMMAND_H
+
+class QCommandLineParser;
+
+/**
+ * Renders a grid of variations of a sound from the command line, using
+ * ParamSweep, and writes a contact sheet image of the grid and a CSV file of
+ * the features of its sounds.
+ *
+ * Shares --output-dir with GenerateCommand, and --jobs with ExportCommand, so
+ * its options must be added to the same parser.
+ */
+namespace SweepCommand {
+
+void addOptions(QCommandLineParser* parser);
+
+/**
+ * Returns the exit code of the process
+ */
+int run(const QCommandLineParser& parser);
+
+} // namespace SweepCommand
+
+#endif // SWEEPCOMMAND_H
@@ -0,0 +1,29 @@
+#include "Commands.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+
+/**
+ * sfxr-render: a headless version of `sfxr-qt --export`.
+ *
+ * It only links with the core library, so it starts quickly and can run on
+ * machines without a graphical environment or an audio device.
+ */
+int main(int argc, char* argv[]) {
+    QCoreApplication app(argc, argv);
+    app.setOrganizationDomain("agateau.com");
+    app.setApplicationName("sfxr-render");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QCoreApplication::translate("main", "Creates wav files from SFXR or SFXJ files."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(
+        "sound_files",
+        QCoreApplication::translate("main", "Files to export. Wildcards are supported."),
+        "sound_file...");
+    Commands::addOptions(&parser);
+    parser.process(app);
+
+    return Commands::run(parser);
+}
@@ -0,0 +1,102 @@
+#include "BatchGenerator.h"
+
+#include "Parallel.h"
+#include "Random.h"
+#include "SoundUtils.h"
+
+#include <utility>
+
+namespace BatchGenerator {
+
+// Number of candidates synthesized per round for each job. Rounds are small,
+// so that few candidates are synthesized past the last accepted one.
+static constexpr int CANDIDATES_PER_JOB = 4;
+
+static const std::pair<const char*, GenerateFunction> CATEGORIES[] = {
+    {"pickup", SoundUtils::generatePickup},
+    {"laser", SoundUtils::generateLaser},
+    {"explosion", SoundUtils::generateExplosion},
+    {"powerup", SoundUtils::generatePowerup},
+    {"hit", SoundUtils::generateHitHurt},
+    {"jump", SoundUtils::generateJump},
+    {"blip", SoundUtils::generateBlipSelect},
+};
+
+QStringList categories() {
+    QStringList list;
+    for (const auto& category : CATEGORIES) {
+        list << category.first;
+    }
+    return list;
+}
+
+GenerateFunction generateFunction(const QString& category) {
+    for (const auto& it : CATEGORIES) {
+        if (category == it.first) {
+            return it.second;
+        }
+    }
+    return nullptr;
+}
+
+static bool isInRange(qreal value,
+                      const std::optional<qreal>& min,
+                      const std::optional<qreal>& max) {
+    return !(min.has_value() && value < min.value()) && !(max.has_value() && value > max.value());
+}
+
+bool Constraints::accepts(const SoundFeatures& features) const {
+    return isInRange(features.duration, minDuration, maxDuration)
+           && isInRange(features.peak, minPeak, maxPeak)
+           && isInRange(features.spectralCentroid, minSpectralCentroid, maxSpectralCentroid)
+           && (allowClipping || features.clippedCount == 0);
+}
+
+SoundParams generate(GenerateFunction function, quint64 seed, int attempt) {
+    // Mix the seed and the attempt (SplitMix64 finalizer), so that the
+    // generators of consecutive attempts are not correlated
+    quint64 value = seed + quint64(attempt) * 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    value ^= value >> 31;
+    Random random(value);
+    return function(&random);
+}
+
+QVector<Candidate> run(const Options& options, int* attemptCount) {
+    Q_ASSERT(options.generate);
+    QVector<Candidate> accepted;
+    int roundSize = qMax(1, options.jobs) * CANDIDATES_PER_JOB;
+    QVector<Candidate> round;
+    int attempt = 0;
+    while (accepted.size() < options.count && attempt < options.maxAttempts) {
+        int size = qMin(roundSize, options.maxAttempts - attempt);
+        round.resize(size);
+        int firstAttempt = attempt;
+        Candidate* candidates = round.data();
+        Parallel::forEachIndex(size, options.jobs, [&options, candidates, firstAttempt](int index) {
+            auto& candidate = candidates[index];
+            candidate.attempt = firstAttempt + index;
+            candidate.params = generate(options.generate, options.seed, candidate.attempt);
+            candidate.features = SoundFeatures::fromParams(candidate.params);
+        });
+        attempt += size;
+
+        // Accept in attempt order, so that the result does not depend on the
+        // round size
+        for (const auto& candidate : round) {
+            if (accepted.size() == options.count) {
+                break;
+            }
+            if (options.constraints.accepts(candidate.features)) {
+                accepted << candidate;
+            }
+        }
+    }
+    if (attemptCount) {
+        *attemptCount = attempt;
+    }
+    return accepted;
+}
+
+} // namespace BatchGenerator
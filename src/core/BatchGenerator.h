@@ -0,0 +1,89 @@
+#ifndef BATCHGENERATOR_H
+#define BATCHGENERATOR_H
+
+#include "SoundFeatures.h"
+#include "SoundParams.h"
+
+#include <QStringList>
+#include <QVector>
+
+#include <optional>
+
+class Random;
+
+/**
+ * Generates many random sounds, and keeps the ones matching constraints on
+ * their features.
+ *
+ * Candidates are synthesized and analyzed on several threads. The accepted
+ * sounds only depend on the seed and the constraints, not on the number of
+ * threads.
+ */
+namespace BatchGenerator {
+
+using GenerateFunction = SoundParams (*)(Random* random);
+
+/**
+ * The names of the sound categories: "pickup", "laser"...
+ */
+QStringList categories();
+
+/**
+ * Returns the SoundUtils function generating sounds of `category`, or null if
+ * the category is unknown
+ */
+GenerateFunction generateFunction(const QString& category);
+
+/**
+ * Bounds on the features of the accepted sounds. Unset bounds are not checked.
+ */
+struct Constraints {
+    std::optional<qreal> minDuration;
+    std::optional<qreal> maxDuration;
+    std::optional<qreal> minPeak;
+    std::optional<qreal> maxPeak;
+    std::optional<qreal> minSpectralCentroid;
+    std::optional<qreal> maxSpectralCentroid;
+    bool allowClipping = true;
+
+    bool accepts(const SoundFeatures& features) const;
+};
+
+struct Candidate {
+    /**
+     * Index of the attempt which generated the sound. The sound can be
+     * generated again by calling generate() with the same seed and index.
+     */
+    int attempt = 0;
+    SoundParams params;
+    SoundFeatures features;
+};
+
+struct Options {
+    GenerateFunction generate = nullptr;
+    int count = 1;
+    quint64 seed = 0;
+    int jobs = 1;
+    /**
+     * Maximum number of candidates to try: fewer than `count` sounds are
+     * returned if the constraints are too strict
+     */
+    int maxAttempts = 1000;
+    Constraints constraints;
+};
+
+/**
+ * Returns the parameters of the candidate generated by attempt `attempt`
+ */
+SoundParams generate(GenerateFunction function, quint64 seed, int attempt);
+
+/**
+ * Returns the first `options.count` candidates accepted by the constraints.
+ * Stores the number of synthesized candidates in `attemptCount`, if it is not
+ * null.
+ */
+QVector<Candidate> run(const Options& options, int* attemptCount = nullptr);
+
+} // namespace BatchGenerator
+
+#endif // BATCHGENERATOR_H
@@ -0,0 +1,43 @@
+#include "Breeder.h"
+
+#include "Random.h"
+#include "SoundUtils.h"
+
+namespace Breeder {
+
+SoundParams crossover(const SoundParams& parent1, const SoundParams& parent2, Random* random) {
+    SoundParams child = parent1;
+    if (random->range(1) == 1) {
+        child.waveForm = parent2.waveForm;
+    }
+    for (const auto& field : SoundParams::realFields()) {
+        if (random->range(1) == 1) {
+            child.*field.member = parent2.*field.member;
+        }
+    }
+    return child;
+}
+
+QVector<SoundParams> breed(const QVector<SoundParams>& parents, int count, Random* random) {
+    QVector<SoundParams> offspring;
+    if (parents.isEmpty()) {
+        return offspring;
+    }
+    offspring.reserve(count);
+    for (int idx = 0; idx < count; ++idx) {
+        SoundParams child;
+        if (parents.size() == 1) {
+            child = parents.first();
+        } else {
+            int index1 = random->range(parents.size() - 1);
+            // Pick another parent
+            int index2 = (index1 + 1 + random->range(parents.size() - 2)) % parents.size();
+            child = crossover(parents.at(index1), parents.at(index2), random);
+        }
+        SoundUtils::mutate(&child, random);
+        offspring << child;
+    }
+    return offspring;
+}
+
+} // namespace Breeder
@@ -0,0 +1,38 @@
+#ifndef BREEDER_H
+#define BREEDER_H
+
+#include "SoundParams.h"
+
+#include <QVector>
+
+class Random;
+
+/**
+ * Functions to breed new sounds from favourite ones: each offspring mixes
+ * the parameters of two parents, then gets mutated.
+ *
+ * Like SoundUtils, the random values come from `random`, so the same seed
+ * produces the same offspring.
+ */
+namespace Breeder {
+
+static constexpr int MIN_OFFSPRING_COUNT = 16;
+static constexpr int MAX_OFFSPRING_COUNT = 64;
+
+/**
+ * Returns a sound whose parameters are each taken from `parent1` or
+ * `parent2`, at random
+ */
+SoundParams crossover(const SoundParams& parent1, const SoundParams& parent2, Random* random);
+
+/**
+ * Returns `count` offspring of `parents`. With a single parent, the offspring
+ * are mutations of it. With several parents, each offspring is a mutated
+ * crossover of two different parents. Returns an empty list if `parents` is
+ * empty.
+ */
+QVector<SoundParams> breed(const QVector<SoundParams>& parents, int count, Random* random);
+
+} // namespace Breeder
+
+#endif // BREEDER_H
@@ -0,0 +1,73 @@
+#ifndef BUFFERSTRATEGY_H
+#define BUFFERSTRATEGY_H
+
+#include "Synthesizer.h"
+
+#include <QVector>
+
+/**
+ * Stores the synthesized samples, clamped to [-1, 1], in a QVector
+ */
+class BufferStrategy : public Synthesizer::SynthStrategy {
+public:
+    explicit BufferStrategy(QVector<qreal>* samples) : mSamples(samples) {
+    }
+
+    void write(qreal sample) override {
+        auto value = qBound(-1., sample, 1.);
+        mSamples->push_back(value);
+    }
+
+private:
+    QVector<qreal>* const mSamples;
+};
+
+/**
+ * Stores the synthesized samples without clamping them, so that clipping can
+ * be detected
+ */
+class RawBufferStrategy : public Synthesizer::SynthStrategy {
+public:
+    explicit RawBufferStrategy(QVector<qreal>* samples) : mSamples(samples) {
+    }
+
+    void write(qreal sample) override {
+        mSamples->push_back(sample);
+    }
+
+private:
+    QVector<qreal>* const mSamples;
+};
+
+/**
+ * Synthesizes `params` and returns the samples stored by `Strategy`, one of
+ * the strategies above. Stops after `maxSampleCount` samples if it is not 0.
+ */
+template <class Strategy = BufferStrategy>
+QVector<qreal> renderSamples(const SoundParams& params, int maxSampleCount = 0) {
+    static constexpr int CHUNK_SIZE = 4096;
+    QVector<qreal> samples;
+    Strategy strategy(&samples);
+    Synthesizer synth;
+    synth.init(params);
+    auto sampleCount = synth.maxSampleCount();
+    if (maxSampleCount > 0) {
+        sampleCount = qMin(sampleCount, qint64(maxSampleCount));
+    }
+    samples.reserve(int(sampleCount));
+    while (true) {
+        int length = CHUNK_SIZE;
+        if (maxSampleCount > 0) {
+            length = qMin(length, maxSampleCount - samples.size());
+            if (length == 0) {
+                break;
+            }
+        }
+        if (!synth.synthSample(length, &strategy)) {
+            break;
+        }
+    }
+    return samples;
+}
+
+#endif // BUFFERSTRATEGY_H
@@ -0,0 +1,128 @@
+#include "ContactSheet.h"
+
+#include "PngEncoder.h"
+#include "Spectrum.h"
+#include "Synthesizer.h"
+
+#include <array>
+#include <cmath>
+
+// Frequency range of the spectrograms, in Hz, on a logarithmic scale
+static constexpr qreal MIN_FREQUENCY = 50;
+static constexpr qreal MAX_FREQUENCY = 16000;
+
+// Levels of the spectrograms, in dB. Levels below MIN_LEVEL are black.
+static constexpr qreal MIN_LEVEL = -70;
+
+// Magnitude of a full scale sine wave, once windowed: it gets a level of 0 dB
+static constexpr qreal FULL_SCALE_MAGNITUDE = Spectrum::FRAME_SIZE / 4;
+
+// Spectrogram columns closer than this many samples share the same frame,
+// which saves computing spectrums for short sounds
+static constexpr int MIN_FRAME_STEP = Spectrum::FRAME_SIZE / 4;
+
+/**
+ * Returns the color of `value`, from 0 to 1: black, red, yellow, then white
+ */
+static quint32 heatColor(qreal value) {
+    auto channel = [value](qreal offset) {
+        return quint32(qBound(0., value * 3 - offset, 1.) * 255);
+    };
+    return (channel(0) << 16) | (channel(1) << 8) | channel(2);
+}
+
+ContactSheet::ContactSheet(int columnCount, int rowCount)
+        : mColumnCount(columnCount)
+        , mRowCount(rowCount)
+        , mCellSampleCount(Synthesizer::SAMPLE_RATE)
+        , mPixels(width() * height(), SPACING_COLOR) {
+}
+
+int ContactSheet::width() const {
+    return SPACING + mColumnCount * (CELL_WIDTH + SPACING);
+}
+
+int ContactSheet::height() const {
+    return SPACING + mRowCount * (CELL_HEIGHT + SPACING);
+}
+
+void ContactSheet::setCellSampleCount(int sampleCount) {
+    mCellSampleCount = qMax(sampleCount, 1);
+}
+
+void ContactSheet::drawCell(int column, int row, const QVector<qreal>& samples) {
+    Q_ASSERT(column >= 0 && column < mColumnCount);
+    Q_ASSERT(row >= 0 && row < mRowCount);
+    int left = SPACING + column * (CELL_WIDTH + SPACING);
+    int top = SPACING + row * (CELL_HEIGHT + SPACING);
+    drawWaveForm(left, top, samples);
+    drawSpectrogram(left, top + WAVE_FORM_HEIGHT, samples);
+}
+
+const QVector<quint32>& ContactSheet::pixels() const {
+    return mPixels;
+}
+
+QByteArray ContactSheet::toPng() const {
+    return PngEncoder::encode(mPixels, width(), height());
+}
+
+void ContactSheet::drawWaveForm(int left, int top, const QVector<qreal>& samples) {
+    int imageWidth = width();
+    auto toY = [](qreal sample) {
+        return int(std::lround((1 - qBound(-1., sample, 1.)) / 2 * (WAVE_FORM_HEIGHT - 1)));
+    };
+    for (int x = 0; x < CELL_WIDTH; ++x) {
+        int start = int(qint64(mCellSampleCount) * x / CELL_WIDTH);
+        int end = qMin(int(qint64(mCellSampleCount) * (x + 1) / CELL_WIDTH), samples.size());
+        int minY = WAVE_FORM_HEIGHT;
+        int maxY = -1;
+        if (start < end) {
+            qreal minSample = samples.at(start);
+            qreal maxSample = minSample;
+            for (int idx = start + 1; idx < end; ++idx) {
+                minSample = qMin(minSample, samples.at(idx));
+                maxSample = qMax(maxSample, samples.at(idx));
+            }
+            minY = toY(maxSample);
+            maxY = toY(minSample);
+        }
+        for (int y = 0; y < WAVE_FORM_HEIGHT; ++y) {
+            bool inWave = y >= minY && y <= maxY;
+            mPixels[(top + y) * imageWidth + left + x] =
+                inWave ? WAVE_FORM_COLOR : WAVE_FORM_BACKGROUND_COLOR;
+        }
+    }
+}
+
+void ContactSheet::drawSpectrogram(int left, int top, const QVector<qreal>& samples) {
+    static const auto bandEdges = Spectrum::logBandEdges(
+        MIN_FREQUENCY, MAX_FREQUENCY, SPECTROGRAM_HEIGHT, Synthesizer::SAMPLE_RATE);
+    int imageWidth = width();
+    std::array<qreal, Spectrum::BIN_COUNT> magnitudes;
+    std::array<quint32, SPECTROGRAM_HEIGHT> colors;
+    int frameStart = -1;
+    for (int x = 0; x < CELL_WIDTH; ++x) {
+        int start = int(qint64(mCellSampleCount) * x / CELL_WIDTH);
+        if (start >= samples.size()) {
+            colors.fill(heatColor(0));
+        } else if (frameStart < 0 || start - frameStart >= MIN_FRAME_STEP) {
+            frameStart = start;
+            int count = qMin(Spectrum::FRAME_SIZE, samples.size() - start);
+            Spectrum::computeMagnitudes(samples.constData() + start, count, magnitudes.data());
+            for (int y = 0; y < SPECTROGRAM_HEIGHT; ++y) {
+                // The top row shows the highest band
+                int band = SPECTROGRAM_HEIGHT - 1 - y;
+                qreal magnitude = 0;
+                for (int bin = bandEdges[band]; bin < bandEdges[band + 1]; ++bin) {
+                    magnitude = qMax(magnitude, magnitudes[bin]);
+                }
+                qreal level = 20 * std::log10(magnitude / FULL_SCALE_MAGNITUDE + 1e-9);
+                colors[y] = heatColor(1 - level / MIN_LEVEL);
+            }
+        }
+        for (int y = 0; y < SPECTROGRAM_HEIGHT; ++y) {
+            mPixels[(top + y) * imageWidth + left + x] = colors[y];
+        }
+    }
+}
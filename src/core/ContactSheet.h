@@ -0,0 +1,61 @@
+#ifndef CONTACTSHEET_H
+#define CONTACTSHEET_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * An image showing a grid of sounds. Each cell shows the wave form of a sound
+ * above its spectrogram, with time going from left to right.
+ *
+ * All cells share the same time scale, so that the durations of the sounds
+ * can be compared. Cells can be drawn by several threads at the same time.
+ */
+class ContactSheet {
+public:
+    static constexpr int CELL_WIDTH = 96;
+    static constexpr int WAVE_FORM_HEIGHT = 32;
+    static constexpr int SPECTROGRAM_HEIGHT = 48;
+    static constexpr int CELL_HEIGHT = WAVE_FORM_HEIGHT + SPECTROGRAM_HEIGHT;
+    /** Width of the lines between the cells, in pixels */
+    static constexpr int SPACING = 2;
+
+    static constexpr quint32 SPACING_COLOR = 0x000000;
+    static constexpr quint32 WAVE_FORM_BACKGROUND_COLOR = 0x202020;
+    static constexpr quint32 WAVE_FORM_COLOR = 0x60c0ff;
+
+    ContactSheet(int columnCount, int rowCount);
+
+    int width() const;
+    int height() const;
+
+    /**
+     * Number of samples covered by the width of a cell. Samples after it are
+     * not shown. Defaults to one second.
+     */
+    void setCellSampleCount(int sampleCount);
+
+    /**
+     * Draws `samples`, synthesized at Synthesizer::SAMPLE_RATE, in the cell at
+     * `column`, `row`
+     */
+    void drawCell(int column, int row, const QVector<qreal>& samples);
+
+    /**
+     * Returns the pixels, row by row, as 0xRRGGBB values
+     */
+    const QVector<quint32>& pixels() const;
+
+    QByteArray toPng() const;
+
+private:
+    void drawWaveForm(int left, int top, const QVector<qreal>& samples);
+    void drawSpectrogram(int left, int top, const QVector<qreal>& samples);
+
+    const int mColumnCount;
+    const int mRowCount;
+    int mCellSampleCount;
+    QVector<quint32> mPixels;
+};
+
+#endif // CONTACTSHEET_H
@@ -0,0 +1,204 @@
+#include "DuplicateFinder.h"
+
+#include "Random.h"
+#include "SoundFingerprint.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// The longest of two near-duplicates is at most this much longer than the
+// other
+static constexpr qreal MAX_DURATION_RATIO = 1.25;
+
+// Fixed, so that the results do not change from one run to the other
+static constexpr quint64 KEY_SEED = 0x5f3759df;
+
+static_assert(DuplicateFinder::KEY_BITS <= 32, "Keys must fit in a quint32");
+
+using KeyPositions = std::array<int, DuplicateFinder::KEY_BITS>;
+
+/**
+ * Returns the bits used as keys by each table. The bits of a key are
+ * different, but tables can share bits.
+ */
+static std::array<KeyPositions, DuplicateFinder::TABLE_COUNT> computeKeyPositions() {
+    Random random(KEY_SEED);
+    std::array<int, SoundFingerprint::BIT_COUNT> bits;
+    std::iota(bits.begin(), bits.end(), 0);
+    std::array<KeyPositions, DuplicateFinder::TABLE_COUNT> positions;
+    for (auto& keyPositions : positions) {
+        // Partial Fisher-Yates shuffle
+        for (int idx = 0; idx < DuplicateFinder::KEY_BITS; ++idx) {
+            int other = idx + random.range(SoundFingerprint::BIT_COUNT - 1 - idx);
+            std::swap(bits[idx], bits[other]);
+            keyPositions[idx] = bits[idx];
+        }
+    }
+    return positions;
+}
+
+/**
+ * Returns a hash of `index`, different for each `table`. Sorting the members
+ * of a bucket by it gives a random but reproducible order.
+ */
+static quint32 scramble(int index, int table) {
+    // The finalizer of SplitMix64
+    quint64 value = (quint64(table) << 32) | quint32(index);
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return quint32(value ^ (value >> 31));
+}
+
+static quint32 computeKey(const SoundFingerprint& fingerprint, const KeyPositions& positions) {
+    quint32 key = 0;
+    for (int position : positions) {
+        key = (key << 1) | (fingerprint.bit(position) ? 1 : 0);
+    }
+    return key;
+}
+
+/**
+ * A union-find structure. The root of a set is its smallest index, so that
+ * the clusters do not depend on the order in which pairs are found.
+ */
+class DisjointSets {
+public:
+    explicit DisjointSets(int count) : mParents(size_t(count)) {
+        std::iota(mParents.begin(), mParents.end(), 0);
+    }
+
+    int find(int index) {
+        while (mParents[index] != index) {
+            // Path halving
+            mParents[index] = mParents[mParents[index]];
+            index = mParents[index];
+        }
+        return index;
+    }
+
+    void merge(int root1, int root2) {
+        if (root1 < root2) {
+            mParents[root2] = root1;
+        } else {
+            mParents[root1] = root2;
+        }
+    }
+
+private:
+    std::vector<int> mParents;
+};
+
+/**
+ * Returns the member of `members` with the smallest sum of distances to the
+ * others. Ties go to the first one.
+ *
+ * Clusters can be large, so instead of computing the distances of all the
+ * pairs, count the members having each bit set: a member differs from
+ * `count` members on each bit it does not have, and from the others on each
+ * bit it has.
+ */
+static int findMedoid(const QVector<SoundFingerprint>& fingerprints, const QVector<int>& members) {
+    std::array<qint64, SoundFingerprint::BIT_COUNT> bitCounts{};
+    for (int member : members) {
+        const auto& fingerprint = fingerprints.at(member);
+        for (int bit = 0; bit < SoundFingerprint::BIT_COUNT; ++bit) {
+            bitCounts[bit] += fingerprint.bit(bit) ? 1 : 0;
+        }
+    }
+    int medoid = members.first();
+    qint64 bestSum = std::numeric_limits<qint64>::max();
+    for (int member : members) {
+        const auto& fingerprint = fingerprints.at(member);
+        qint64 sum = 0;
+        for (int bit = 0; bit < SoundFingerprint::BIT_COUNT; ++bit) {
+            sum += fingerprint.bit(bit) ? members.size() - bitCounts[bit] : bitCounts[bit];
+        }
+        if (sum < bestSum) {
+            bestSum = sum;
+            medoid = member;
+        }
+    }
+    return medoid;
+}
+
+namespace DuplicateFinder {
+
+bool areDuplicates(const SoundFingerprint& fingerprint1,
+                   const SoundFingerprint& fingerprint2,
+                   int maxDistance) {
+    qreal shortest = qMin(fingerprint1.duration, fingerprint2.duration);
+    qreal longest = qMax(fingerprint1.duration, fingerprint2.duration);
+    return longest <= shortest * MAX_DURATION_RATIO
+           && fingerprint1.distance(fingerprint2) <= maxDistance;
+}
+
+QVector<Cluster> findClusters(const QVector<SoundFingerprint>& fingerprints, int maxDistance) {
+    static const auto keyPositions = computeKeyPositions();
+    int count = fingerprints.size();
+    DisjointSets sets(count);
+
+    // Sorting the (key, order, index) tuples puts the fingerprints sharing a
+    // key next to each other, without allocating a hash table per key
+    std::vector<std::tuple<quint32, quint32, int>> keys(static_cast<size_t>(count));
+    for (int table = 0; table < TABLE_COUNT; ++table) {
+        const auto& positions = keyPositions[table];
+        for (int idx = 0; idx < count; ++idx) {
+            keys[idx] = {computeKey(fingerprints.at(idx), positions), scramble(idx, table), idx};
+        }
+        std::sort(keys.begin(), keys.end());
+
+        for (auto bucketBegin = keys.begin(); bucketBegin != keys.end();) {
+            quint32 key = std::get<0>(*bucketBegin);
+            auto bucketEnd = std::find_if(bucketBegin, keys.end(), [key](const auto& entry) {
+                return std::get<0>(entry) != key;
+            });
+            for (auto it1 = bucketBegin; it1 != bucketEnd; ++it1) {
+                auto windowEnd = bucketEnd - it1 > BUCKET_WINDOW ? it1 + 1 + BUCKET_WINDOW
+                                                                 : bucketEnd;
+                int index1 = std::get<2>(*it1);
+                for (auto it2 = it1 + 1; it2 != windowEnd; ++it2) {
+                    int index2 = std::get<2>(*it2);
+                    int root1 = sets.find(index1);
+                    int root2 = sets.find(index2);
+                    // Skip the pairs already known to be in the same cluster
+                    if (root1 != root2
+                        && areDuplicates(
+                            fingerprints.at(index1), fingerprints.at(index2), maxDistance)) {
+                        sets.merge(root1, root2);
+                    }
+                }
+            }
+            bucketBegin = bucketEnd;
+        }
+    }
+
+    // Roots are the smallest index of their set, so clusters come sorted by
+    // their smallest index, and their members are sorted
+    std::vector<QVector<int>> membersForRoot(static_cast<size_t>(count));
+    for (int idx = 0; idx < count; ++idx) {
+        membersForRoot[sets.find(idx)] << idx;
+    }
+
+    QVector<Cluster> clusters;
+    for (const auto& members : membersForRoot) {
+        if (members.size() < 2) {
+            continue;
+        }
+        Cluster cluster;
+        cluster.kept = findMedoid(fingerprints, members);
+        for (int member : members) {
+            if (member != cluster.kept) {
+                cluster.dropped << member;
+            }
+        }
+        clusters << cluster;
+    }
+    return clusters;
+}
+
+} // namespace DuplicateFinder
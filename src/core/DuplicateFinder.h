@@ -0,0 +1,66 @@
+#ifndef DUPLICATEFINDER_H
+#define DUPLICATEFINDER_H
+
+#include <QVector>
+
+struct SoundFingerprint;
+
+/**
+ * Finds clusters of sounds which sound almost the same, from their
+ * fingerprints.
+ *
+ * Comparing all the pairs of fingerprints would take too long for large
+ * libraries, so candidate pairs are found with locality-sensitive hashing:
+ * fingerprints are put in TABLE_COUNT hash tables, each keyed by a different
+ * set of KEY_BITS bits, and only fingerprints sharing a key in at least one
+ * table are compared. Pairs differing by a few bits share a key with a high
+ * probability, while unrelated sounds rarely do. Within a bucket, each
+ * fingerprint is only compared with the next BUCKET_WINDOW ones, in an order
+ * which changes from table to table, so that large buckets of similar sounds
+ * do not take quadratic time.
+ *
+ * Two sounds are near-duplicates if their fingerprints differ by at most
+ * `maxDistance` bits and their durations are close. A cluster contains all the
+ * sounds linked by near-duplicate pairs.
+ */
+namespace DuplicateFinder {
+
+static constexpr int TABLE_COUNT = 32;
+static constexpr int KEY_BITS = 16;
+
+static constexpr int BUCKET_WINDOW = 32;
+
+static constexpr int DEFAULT_MAX_DISTANCE = 32;
+
+/**
+ * The highest supported `maxDistance`. Pairs of fingerprints differing by
+ * this many bits share a key about 85% of the time, and much less often
+ * beyond that: hashing would miss most near-duplicates.
+ */
+static constexpr int MAX_DISTANCE_LIMIT = 40;
+
+struct Cluster {
+    /** The sound to keep: the one closest to the others */
+    int kept;
+    /** The sounds which can be removed, sorted */
+    QVector<int> dropped;
+};
+
+/**
+ * Returns the clusters of near-duplicates of `fingerprints`, as indexes in
+ * `fingerprints`, sorted by their smallest index. Sounds without duplicates
+ * are not part of any cluster.
+ */
+QVector<Cluster> findClusters(const QVector<SoundFingerprint>& fingerprints,
+                              int maxDistance = DEFAULT_MAX_DISTANCE);
+
+/**
+ * Returns true if the two sounds are near-duplicates
+ */
+bool areDuplicates(const SoundFingerprint& fingerprint1,
+                   const SoundFingerprint& fingerprint2,
+                   int maxDistance = DEFAULT_MAX_DISTANCE);
+
+} // namespace DuplicateFinder
+
+#endif // DUPLICATEFINDER_H
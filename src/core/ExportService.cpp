@@ -0,0 +1,132 @@
+#include "ExportService.h"
+
+#include "Sound.h"
+
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThread>
+#include <QUrl>
+
+class ExportJob : public QRunnable {
+public:
+    ExportJob(ExportService* service,
+              int index,
+              const ExportService::Settings& settings,
+              const SoundParams& params,
+              const QString& path,
+              const std::shared_ptr<std::atomic_bool>& cancelled)
+            : mService(service)
+            , mIndex(index)
+            , mSettings(settings)
+            , mParams(params)
+            , mPath(path)
+            , mCancelled(cancelled) {
+    }
+
+    void run() override {
+        bool cancelled = *mCancelled;
+        Result result;
+        if (!cancelled) {
+            WavSaver saver;
+            saver.setBits(mSettings.bits);
+            saver.setFrequency(mSettings.frequency);
+            saver.setFormat(mSettings.format);
+            saver.setRenderCache(mSettings.renderCache);
+            result = saver.save(mParams, mPath);
+        }
+
+        auto* service = mService;
+        auto index = mIndex;
+        auto path = mPath;
+        QMetaObject::invokeMethod(
+            service,
+            [service, index, path, result, cancelled] {
+                service->onItemDone(index, path, result, cancelled);
+            },
+            Qt::QueuedConnection);
+    }
+
+private:
+    ExportService* const mService;
+    const int mIndex;
+    const ExportService::Settings mSettings;
+    const SoundParams mParams;
+    const QString mPath;
+    const std::shared_ptr<std::atomic_bool> mCancelled;
+};
+
+ExportService::ExportService(QObject* parent)
+        : QObject(parent), mCancelled(std::make_shared<std::atomic_bool>(false)) {
+    // Leave a core for the UI and the sound player
+    mThreadPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+ExportService::~ExportService() {
+    cancel();
+    mThreadPool.waitForDone();
+}
+
+int ExportService::add(const WavSaver& saver, const SoundParams& params, const QString& path) {
+    if (!isBusy()) {
+        // Start a new batch
+        mTotalCount = 0;
+        mDoneCount = 0;
+        mFailureCount = 0;
+    }
+    int index = mTotalCount++;
+    Settings settings{saver.bits(), saver.frequency(), saver.format(), saver.renderCache()};
+    mThreadPool.start(new ExportJob(this, index, settings, params, path, mCancelled));
+    if (index == 0) {
+        busyChanged(true);
+    }
+    progressChanged();
+    return index;
+}
+
+int ExportService::exportSound(WavSaver* saver, Sound* sound, const QUrl& url) {
+    return add(*saver, SoundParams::fromSound(sound), url.path());
+}
+
+void ExportService::cancel() {
+    *mCancelled = true;
+    // Sounds added from now on must not be cancelled
+    mCancelled = std::make_shared<std::atomic_bool>(false);
+}
+
+void ExportService::waitForDone() {
+    mThreadPool.waitForDone();
+}
+
+bool ExportService::isBusy() const {
+    return mDoneCount < mTotalCount;
+}
+
+int ExportService::totalCount() const {
+    return mTotalCount;
+}
+
+int ExportService::doneCount() const {
+    return mDoneCount;
+}
+
+int ExportService::failureCount() const {
+    return mFailureCount;
+}
+
+void ExportService::onItemDone(int index,
+                               const QString& path,
+                               const Result& result,
+                               bool cancelled) {
+    ++mDoneCount;
+    if (!cancelled) {
+        if (!result) {
+            ++mFailureCount;
+        }
+        itemFinished(index, path, result);
+    }
+    progressChanged();
+    if (!isBusy()) {
+        busyChanged(false);
+        finished();
+    }
+}
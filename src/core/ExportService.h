@@ -0,0 +1,85 @@
+#ifndef EXPORTSERVICE_H
+#define EXPORTSERVICE_H
+
+#include "Result.h"
+#include "SoundParams.h"
+#include "WavSaver.h"
+
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+class Sound;
+
+/**
+ * Exports sounds in a background thread pool, so that the user interface stays
+ * responsive, even when exporting hundreds of sounds.
+ *
+ * Each call to add() queues a sound and returns its index in the current
+ * batch. itemFinished() is emitted when it has been exported. The batch ends
+ * when all its sounds have been exported or cancelled: finished() is emitted,
+ * and the next call to add() starts a new batch.
+ */
+class ExportService : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool busy READ isBusy NOTIFY busyChanged)
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY progressChanged)
+    Q_PROPERTY(int doneCount READ doneCount NOTIFY progressChanged)
+    Q_PROPERTY(int failureCount READ failureCount NOTIFY progressChanged)
+public:
+    explicit ExportService(QObject* parent = nullptr);
+    ~ExportService();
+
+    /**
+     * Queues the export of `params` to `path`, with the current settings of
+     * `saver`. Returns the index of the sound in the batch.
+     */
+    int add(const WavSaver& saver, const SoundParams& params, const QString& path);
+
+    Q_INVOKABLE int exportSound(WavSaver* saver, Sound* sound, const QUrl& url);
+
+    /**
+     * Cancels the sounds which are not being exported yet. They do not emit
+     * itemFinished(), but they are counted in doneCount.
+     */
+    Q_INVOKABLE void cancel();
+
+    /**
+     * Blocks until all the queued sounds have been exported or cancelled.
+     * The signals are only emitted once the event loop runs.
+     */
+    void waitForDone();
+
+    bool isBusy() const;
+    int totalCount() const;
+    int doneCount() const;
+    int failureCount() const;
+
+signals:
+    void busyChanged(bool busy);
+    void progressChanged();
+    void itemFinished(int index, const QString& path, const Result& result);
+    void finished();
+
+private:
+    friend class ExportJob;
+
+    struct Settings {
+        int bits;
+        int frequency;
+        WavSaver::Format format;
+        RenderCache* renderCache;
+    };
+
+    void onItemDone(int index, const QString& path, const Result& result, bool cancelled);
+
+    QThreadPool mThreadPool;
+    std::shared_ptr<std::atomic_bool> mCancelled;
+    int mTotalCount = 0;
+    int mDoneCount = 0;
+    int mFailureCount = 0;
+};
+
+#endif // EXPORTSERVICE_H
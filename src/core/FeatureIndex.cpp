@@ -0,0 +1,293 @@
+#include "FeatureIndex.h"
+
+#include "Parallel.h"
+#include "SoundFeatures.h"
+#include "SoundIO.h"
+#include "SoundParams.h"
+#include "Synthesizer.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cmath>
+
+#include <string.h>
+
+static constexpr char MAGIC[] = "SFXRFIDX";
+static constexpr int MAGIC_SIZE = 8;
+static constexpr int HEADER_SIZE = 24;
+static constexpr int ENTRY_HEADER_SIZE = 20;
+
+// Offsets of the header fields
+static constexpr int VERSION_OFFSET = 8;
+static constexpr int DIMENSION_OFFSET = 10;
+static constexpr int SYNTHESIZER_VERSION_OFFSET = 12;
+static constexpr int COUNT_OFFSET = 16;
+
+// Scales of the components of the vectors. One unit of the scalar features is
+// a factor of two (an octave for frequencies). Envelopes are spread over
+// SLICE_COUNT components, so their weights are divided by
+// sqrt(SLICE_COUNT): a difference over the whole envelope weighs as much as
+// a difference of a scalar feature.
+static constexpr qreal ENVELOPE_WEIGHT = 8.0 / 4;
+static constexpr qreal PITCH_WEIGHT = 2.0 / 4;
+static_assert(SoundFeatures::SLICE_COUNT == 16, "Update the weights");
+
+// Offsets added before taking logarithms, so that zeros are valid
+static constexpr qreal DURATION_OFFSET = 0.01;
+static constexpr qreal FREQUENCY_OFFSET = 50;
+
+static_assert(FeatureIndex::DIMENSION == 3 + 3 * SoundFeatures::SLICE_COUNT,
+              "DIMENSION does not match featureVector()");
+
+static Result createInvalidError(const QString& path, const QString& reason) {
+    auto message = QCoreApplication::translate("FeatureIndex", "Invalid feature index %1: %2.")
+                       .arg(path, reason);
+    return Result::createError(message);
+}
+
+FeatureIndex::Vector FeatureIndex::featureVector(const SoundFeatures& features) {
+    Vector vector;
+    auto* it = vector.begin();
+    *it++ = float(std::log2(features.duration + DURATION_OFFSET));
+    *it++ = float(std::log2(features.spectralCentroid + FREQUENCY_OFFSET));
+    *it++ = float(std::log2(features.spectralRolloff + FREQUENCY_OFFSET));
+    for (qreal value : features.rmsEnvelope) {
+        *it++ = float(value * ENVELOPE_WEIGHT);
+    }
+    for (qreal value : features.peakEnvelope) {
+        *it++ = float(value * ENVELOPE_WEIGHT);
+    }
+    for (qreal value : features.pitchTrajectory) {
+        *it++ = float(std::log2(value + FREQUENCY_OFFSET) * PITCH_WEIGHT);
+    }
+    return vector;
+}
+
+QString FeatureIndex::defaultPath(const QString& dir) {
+    auto absoluteDir = QDir(dir).absolutePath().toUtf8();
+    auto hash = QCryptographicHash::hash(absoluteDir, QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+           + "/sfxr-qt/indexes/" + QString::fromLatin1(hash) + ".sfxi";
+}
+
+QStringList FeatureIndex::findSoundFiles(const QString& dir) {
+    QStringList paths;
+    QDirIterator it(QDir(dir).absolutePath(),
+                    {"*.sfxr", "*.sfxj"},
+                    QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        paths << it.next();
+    }
+    paths.sort();
+    return paths;
+}
+
+Result FeatureIndex::load(const QString& path) {
+    mEntries.clear();
+    mVectors.clear();
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        auto message = QCoreApplication::translate("FeatureIndex", "Cannot open %1: %2.")
+                           .arg(path, file.errorString());
+        return Result::createError(message);
+    }
+    auto data = file.readAll();
+    auto begin = reinterpret_cast<const uchar*>(data.constData());
+    if (data.size() < HEADER_SIZE || memcmp(begin, MAGIC, MAGIC_SIZE) != 0) {
+        return createInvalidError(path, QCoreApplication::translate("FeatureIndex", "wrong magic"));
+    }
+    if (qFromLittleEndian<quint16>(begin + VERSION_OFFSET) != VERSION
+        || qFromLittleEndian<quint16>(begin + DIMENSION_OFFSET) != DIMENSION
+        || qFromLittleEndian<quint32>(begin + SYNTHESIZER_VERSION_OFFSET)
+               != quint32(Synthesizer::VERSION)) {
+        // Outdated, start from scratch
+        return {};
+    }
+
+    quint32 count = qFromLittleEndian<quint32>(begin + COUNT_OFFSET);
+    constexpr int vectorSize = DIMENSION * int(sizeof(float));
+    qint64 pos = HEADER_SIZE;
+    QVector<Entry> entries;
+    std::vector<float> vectors;
+    for (quint32 idx = 0; idx < count; ++idx) {
+        if (pos + ENTRY_HEADER_SIZE > data.size()) {
+            return createInvalidError(
+                path, QCoreApplication::translate("FeatureIndex", "truncated file"));
+        }
+        Entry entry;
+        entry.modified = qFromLittleEndian<qint64>(begin + pos);
+        entry.size = qFromLittleEndian<qint64>(begin + pos + 8);
+        qint64 pathSize = qFromLittleEndian<quint32>(begin + pos + 16);
+        pos += ENTRY_HEADER_SIZE;
+        if (pos + pathSize + vectorSize > data.size()) {
+            return createInvalidError(
+                path, QCoreApplication::translate("FeatureIndex", "truncated file"));
+        }
+        entry.path = QString::fromUtf8(data.constData() + pos, int(pathSize));
+        pos += pathSize;
+        for (int component = 0; component < DIMENSION; ++component) {
+            quint32 bits = qFromLittleEndian<quint32>(begin + pos + component * sizeof(float));
+            float value;
+            memcpy(&value, &bits, sizeof(value));
+            vectors.push_back(value);
+        }
+        pos += vectorSize;
+        entries << entry;
+    }
+    mEntries = entries;
+    mVectors = std::move(vectors);
+    return {};
+}
+
+template <typename T> static void appendValue(QByteArray* data, T value) {
+    int pos = data->size();
+    data->resize(pos + int(sizeof(T)));
+    qToLittleEndian(value, data->data() + pos);
+}
+
+Result FeatureIndex::save(const QString& path) const {
+    QByteArray data(MAGIC, MAGIC_SIZE);
+    appendValue<quint16>(&data, VERSION);
+    appendValue<quint16>(&data, DIMENSION);
+    appendValue<quint32>(&data, Synthesizer::VERSION);
+    appendValue<quint32>(&data, quint32(mEntries.size()));
+    appendValue<quint32>(&data, 0);
+    for (int idx = 0; idx < mEntries.size(); ++idx) {
+        const auto& entry = mEntries.at(idx);
+        auto utf8Path = entry.path.toUtf8();
+        appendValue<qint64>(&data, entry.modified);
+        appendValue<qint64>(&data, entry.size);
+        appendValue<quint32>(&data, quint32(utf8Path.size()));
+        data.append(utf8Path);
+        for (int component = 0; component < DIMENSION; ++component) {
+            float value = mVectors[size_t(idx) * DIMENSION + component];
+            quint32 bits;
+            memcpy(&bits, &value, sizeof(bits));
+            appendValue<quint32>(&data, bits);
+        }
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        auto message = QCoreApplication::translate("FeatureIndex", "Cannot write %1: %2.")
+                           .arg(path, file.errorString());
+        return Result::createError(message);
+    }
+    return {};
+}
+
+int FeatureIndex::count() const {
+    return mEntries.size();
+}
+
+QString FeatureIndex::path(int index) const {
+    return mEntries.at(index).path;
+}
+
+int FeatureIndex::update(const QStringList& paths, int jobs, QStringList* errors) {
+    QHash<QString, int> indexForPath;
+    for (int idx = 0; idx < mEntries.size(); ++idx) {
+        indexForPath.insert(mEntries.at(idx).path, idx);
+    }
+
+    // Reuse the vectors of the unchanged files
+    QVector<Entry> entries(paths.size());
+    std::vector<float> vectors(size_t(paths.size()) * DIMENSION);
+    QVector<int> outdated;
+    for (int idx = 0; idx < paths.size(); ++idx) {
+        auto& entry = entries[idx];
+        QFileInfo info(paths.at(idx));
+        entry.path = paths.at(idx);
+        entry.modified = info.lastModified().toMSecsSinceEpoch();
+        entry.size = info.size();
+        auto it = indexForPath.constFind(entry.path);
+        if (it != indexForPath.constEnd() && mEntries.at(it.value()).modified == entry.modified
+            && mEntries.at(it.value()).size == entry.size) {
+            std::copy_n(mVectors.begin() + qint64(it.value()) * DIMENSION,
+                        DIMENSION,
+                        vectors.begin() + qint64(idx) * DIMENSION);
+        } else {
+            outdated << idx;
+        }
+    }
+
+    QVector<Result> results(outdated.size());
+    Result* resultData = results.data();
+    Entry* entryData = entries.data();
+    float* vectorData = vectors.data();
+    Parallel::forEachIndex(
+        outdated.size(), jobs, [&outdated, resultData, entryData, vectorData](int index) {
+            int entryIndex = outdated.at(index);
+            SoundParams params;
+            resultData[index] =
+                SoundIO::load(&params, QUrl::fromLocalFile(entryData[entryIndex].path));
+            if (resultData[index]) {
+                auto vector = featureVector(SoundFeatures::fromParams(params));
+                std::copy(vector.begin(), vector.end(), vectorData + entryIndex * DIMENSION);
+            }
+        });
+
+    // Drop the files which could not be loaded
+    mEntries.clear();
+    mVectors.clear();
+    int failedIndex = 0;
+    for (int idx = 0; idx < entries.size(); ++idx) {
+        if (failedIndex < outdated.size() && outdated.at(failedIndex) == idx) {
+            const auto& result = results.at(failedIndex++);
+            if (!result) {
+                if (errors) {
+                    *errors << QString("%1: %2").arg(entries.at(idx).path, result.message());
+                }
+                continue;
+            }
+        }
+        mEntries << entries.at(idx);
+        auto begin = vectors.begin() + qint64(idx) * DIMENSION;
+        mVectors.insert(mVectors.end(), begin, begin + DIMENSION);
+    }
+    return outdated.size();
+}
+
+QVector<FeatureIndex::Match>
+FeatureIndex::findNearest(const Vector& query, int count, const QString& excludedPath) const {
+    std::vector<std::pair<float, int>> distances;
+    distances.reserve(size_t(mEntries.size()));
+    const float* vector = mVectors.data();
+    for (int idx = 0; idx < mEntries.size(); ++idx, vector += DIMENSION) {
+        float sum = 0;
+        for (int component = 0; component < DIMENSION; ++component) {
+            float delta = vector[component] - query[component];
+            sum += delta * delta;
+        }
+        distances.emplace_back(sum, idx);
+    }
+    if (!excludedPath.isEmpty()) {
+        auto it = std::remove_if(distances.begin(), distances.end(), [&](const auto& pair) {
+            return mEntries.at(pair.second).path == excludedPath;
+        });
+        distances.erase(it, distances.end());
+    }
+
+    auto middle = distances.begin() + qMin(size_t(qMax(count, 0)), distances.size());
+    std::partial_sort(distances.begin(), middle, distances.end());
+    QVector<Match> matches;
+    for (auto it = distances.begin(); it != middle; ++it) {
+        matches << Match{mEntries.at(it->second).path, std::sqrt(qreal(it->first))};
+    }
+    return matches;
+}
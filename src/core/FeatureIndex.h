@@ -0,0 +1,104 @@
+#ifndef FEATUREINDEX_H
+#define FEATUREINDEX_H
+
+#include "Result.h"
+
+#include <QStringList>
+#include <QVector>
+
+#include <array>
+#include <vector>
+
+struct SoundFeatures;
+
+/**
+ * A persistent index of the acoustic features of a library of sound files,
+ * to find the sounds which sound the closest to a given one.
+ *
+ * Each sound is described by a vector, made of its duration, spectral
+ * centroid and rolloff, RMS and peak envelopes, and pitch trajectory, scaled
+ * so that the euclidean distance between two vectors roughly matches how
+ * different the sounds are. Vectors are stored contiguously: a search scans
+ * them all, which takes a few milliseconds for tens of thousands of sounds.
+ *
+ * File layout, all values little-endian:
+ *
+ * - header (24 bytes): magic "SFXRFIDX", version (u16), dimension (u16),
+ *   synthesizer version (u32), entry count (u32), padding (u32)
+ * - entries: modification time in ms since epoch (i64), file size (i64), path
+ *   size (u32), path (UTF-8), then the vector, as floats
+ */
+class FeatureIndex {
+public:
+    static constexpr int VERSION = 1;
+    static constexpr int DIMENSION = 51;
+
+    using Vector = std::array<float, DIMENSION>;
+
+    struct Match {
+        QString path;
+        qreal distance;
+    };
+
+    /**
+     * Returns the vector describing a sound with these features
+     */
+    static Vector featureVector(const SoundFeatures& features);
+
+    /**
+     * The default location of the index of the sounds of `dir`. Indexes are
+     * stored in the cache directory shared by sfxr-qt and sfxr-render.
+     */
+    static QString defaultPath(const QString& dir);
+
+    /**
+     * Returns the absolute paths of the .sfxr and .sfxj files of `dir` and its
+     * subdirectories, sorted
+     */
+    static QStringList findSoundFiles(const QString& dir);
+
+    /**
+     * Loads the index stored in `path`. An index created by another version
+     * of the synthesizer or of the index is not an error: it is loaded empty,
+     * so that update() computes all the features again.
+     */
+    Result load(const QString& path);
+
+    Result save(const QString& path) const;
+
+    int count() const;
+
+    QString path(int index) const;
+
+    /**
+     * Makes the index match the sound files in `paths`: computes the features
+     * of the files which are not indexed yet or changed since they were, using
+     * up to `jobs` threads, and removes the other entries.
+     *
+     * Files which cannot be loaded are not indexed, and their errors are
+     * appended to `errors` if it is not null. Returns the number of files
+     * whose features were computed.
+     */
+    int update(const QStringList& paths, int jobs, QStringList* errors = nullptr);
+
+    /**
+     * Returns the `count` entries closest to `query`, closest first. The
+     * entry of `excludedPath` is skipped, so that searching for a sound of
+     * the index does not return itself.
+     */
+    QVector<Match>
+    findNearest(const Vector& query, int count, const QString& excludedPath = {}) const;
+
+private:
+    struct Entry {
+        QString path;
+        qint64 modified = 0;
+        qint64 size = 0;
+    };
+
+    QVector<Entry> mEntries;
+    // The vectors of mEntries, one after the other
+    std::vector<float> mVectors;
+};
+
+#endif // FEATUREINDEX_H
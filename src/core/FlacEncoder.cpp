@@ -0,0 +1,652 @@
+#include "FlacEncoder.h"
+
+#include "Parallel.h"
+
+#include <QCryptographicHash>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <math.h>
+
+// Format reference: https://xiph.org/flac/format.html
+
+static constexpr int MAX_FIXED_ORDER = 4;
+
+static constexpr int MAX_LPC_ORDER = 8;
+
+// Precision of the quantized LPC coefficients. With 16 bits samples and
+// MAX_LPC_ORDER, predictions fit in 32 bits, which lets decoders use their
+// fast path.
+static constexpr int LPC_PRECISION = 12;
+
+static constexpr int MAX_PARTITION_ORDER = 6;
+
+// Rice parameters use 4 bits, or 5 bits with the RICE2 coding method. The
+// highest value is reserved for escape codes.
+static constexpr int MAX_RICE_PARAMETER = 14;
+static constexpr int MAX_RICE2_PARAMETER = 30;
+
+// Escaped partitions store their values verbatim, with a number of bits coded
+// on 5 bits
+static constexpr int ESCAPE_BITS_SIZE = 5;
+static constexpr int MAX_ESCAPE_BITS = 31;
+
+static constexpr int SUBFRAME_HEADER_BITS = 8;
+
+static constexpr int STREAMINFO_SIZE = 34;
+
+namespace {
+
+class BitWriter {
+public:
+    /**
+     * Writes the `bits` low bits of `value`, `bits` must be at most 32
+     */
+    void write(quint32 value, int bits) {
+        if (bits == 0) {
+            return;
+        }
+        mAccumulator = (mAccumulator << bits) | (value & (quint64(0xffffffff) >> (32 - bits)));
+        mAccumulatorBits += bits;
+        while (mAccumulatorBits >= 8) {
+            mAccumulatorBits -= 8;
+            mBytes.append(char(mAccumulator >> mAccumulatorBits));
+        }
+    }
+
+    void writeSigned(qint32 value, int bits) {
+        write(quint32(value), bits);
+    }
+
+    /**
+     * Writes `zeros` zero bits, followed by a one bit
+     */
+    void writeUnary(quint32 zeros) {
+        for (; zeros >= 32; zeros -= 32) {
+            write(0, 32);
+        }
+        write(1, zeros + 1);
+    }
+
+    void writeRice(qint32 value, int parameter) {
+        // Fold negative values: 0, -1, 1, -2... become 0, 1, 2, 3...
+        quint32 folded = (quint32(value) << 1) ^ quint32(value >> 31);
+        writeUnary(folded >> parameter);
+        write(folded, parameter);
+    }
+
+    /**
+     * Writes `value` with the UTF-8 like coding used for frame numbers
+     */
+    void writeUtf8(quint32 value) {
+        if (value < 0x80) {
+            write(value, 8);
+            return;
+        }
+        int extraBytes = 1;
+        while (extraBytes < 5 && value >= (quint32(1) << (6 + 5 * extraBytes))) {
+            ++extraBytes;
+        }
+        int firstByteBits = 6 - extraBytes;
+        quint32 prefix = (0xff00 >> (extraBytes + 1)) & 0xff;
+        write(prefix | (value >> (6 * extraBytes)), 8);
+        Q_ASSERT((value >> (6 * extraBytes)) < (quint32(1) << firstByteBits));
+        for (int idx = extraBytes - 1; idx >= 0; --idx) {
+            write(0x80 | ((value >> (6 * idx)) & 0x3f), 8);
+        }
+    }
+
+    void alignToByte() {
+        if (mAccumulatorBits > 0) {
+            write(0, 8 - mAccumulatorBits);
+        }
+    }
+
+    /**
+     * The bytes written so far. Only contains all the data after
+     * alignToByte().
+     */
+    const QByteArray& bytes() const {
+        return mBytes;
+    }
+
+private:
+    QByteArray mBytes;
+    quint64 mAccumulator = 0;
+    int mAccumulatorBits = 0;
+};
+
+quint8 crc8(const QByteArray& data) {
+    quint8 crc = 0;
+    for (char byte : data) {
+        crc ^= quint8(byte);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? quint8((crc << 1) ^ 0x07) : quint8(crc << 1);
+        }
+    }
+    return crc;
+}
+
+quint16 crc16(const QByteArray& data) {
+    static const auto TABLE = [] {
+        std::array<quint16, 256> table;
+        for (int idx = 0; idx < 256; ++idx) {
+            quint16 crc = quint16(idx << 8);
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x8000) ? quint16((crc << 1) ^ 0x8005) : quint16(crc << 1);
+            }
+            table[idx] = crc;
+        }
+        return table;
+    }();
+    quint16 crc = 0;
+    for (char byte : data) {
+        crc = quint16(crc << 8) ^ TABLE[(crc >> 8) ^ quint8(byte)];
+    }
+    return crc;
+}
+
+/**
+ * Returns the number of bits needed to store `value` as a two's complement
+ * number. 0 needs no bits.
+ */
+int signedBitCount(qint32 value) {
+    quint32 magnitude = value < 0 ? ~quint32(value) : quint32(value);
+    int bits = value == 0 ? 0 : 1;
+    for (; magnitude != 0; magnitude >>= 1) {
+        ++bits;
+    }
+    return bits;
+}
+
+/**
+ * Returns the number of bits needed to Rice code the values of `residual` from
+ * `begin` to `end` with `parameter`
+ */
+qint64 riceBits(const QVector<qint32>& residual, int begin, int end, int parameter) {
+    qint64 bits = qint64(end - begin) * (parameter + 1);
+    for (int idx = begin; idx < end; ++idx) {
+        qint32 value = residual.at(idx);
+        quint32 folded = (quint32(value) << 1) ^ quint32(value >> 31);
+        bits += folded >> parameter;
+    }
+    return bits;
+}
+
+/**
+ * How to Rice code a residual
+ */
+struct RiceCoding {
+    // Marks partitions which are escaped instead of being Rice coded
+    static constexpr int ESCAPE = -1;
+
+    int partitionOrder = 0;
+    int parameterBits = 4;
+    // The Rice parameter of each partition, or ESCAPE
+    QVector<int> parameters;
+    // The number of bits of each value, for escaped partitions
+    QVector<int> escapeBits;
+    qint64 bits = std::numeric_limits<qint64>::max();
+};
+
+/**
+ * Finds the partition order and the Rice parameters which give the smallest
+ * output for `residual`. The residual of a block of `blockSize` samples starts
+ * after the `predictorOrder` warm-up samples.
+ */
+RiceCoding findRiceCoding(const QVector<qint32>& residual, int blockSize, int predictorOrder) {
+    int maxOrder = 0;
+    while (maxOrder < MAX_PARTITION_ORDER && blockSize % (2 << maxOrder) == 0
+           && (blockSize >> (maxOrder + 1)) > predictorOrder) {
+        ++maxOrder;
+    }
+
+    // Sum of the folded values and bits needed to store the values verbatim,
+    // for each partition of the highest order, then merge them to get the ones
+    // of the lower orders
+    QVector<quint64> sums(1 << maxOrder, 0);
+    QVector<int> valueBits(1 << maxOrder, 0);
+    int partitionSize = blockSize >> maxOrder;
+    for (int idx = 0; idx < residual.size(); ++idx) {
+        qint32 value = residual.at(idx);
+        quint32 folded = (quint32(value) << 1) ^ quint32(value >> 31);
+        int partition = (idx + predictorOrder) / partitionSize;
+        sums[partition] += folded;
+        valueBits[partition] = qMax(valueBits.at(partition), signedBitCount(value));
+    }
+
+    RiceCoding best;
+    for (int order = maxOrder; order >= 0; --order) {
+        int partitionCount = 1 << order;
+        int size = blockSize >> order;
+        RiceCoding coding;
+        coding.partitionOrder = order;
+        coding.escapeBits.resize(partitionCount);
+        coding.bits = 2 + 4;
+        int maxParameter = 0;
+        for (int partition = 0; partition < partitionCount; ++partition) {
+            quint64 sum = sums.at(partition);
+            qint64 count = partition == 0 ? size - predictorOrder : size;
+            // Each value takes parameter + 1 bits, plus the high bits in unary
+            int parameter = 0;
+            qint64 bits = count + qint64(sum);
+            for (int candidate = 1; candidate <= MAX_RICE2_PARAMETER; ++candidate) {
+                qint64 candidateBits = count * (candidate + 1) + qint64(sum >> candidate);
+                if (candidateBits >= bits) {
+                    break;
+                }
+                parameter = candidate;
+                bits = candidateBits;
+            }
+            // Values which are spread evenly, like noise, can be smaller when
+            // stored verbatim. The size above is an upper bound, so compare
+            // with the exact size before escaping.
+            int escapeBits = valueBits.at(partition);
+            qint64 escapedBits = ESCAPE_BITS_SIZE + count * escapeBits;
+            if (escapeBits <= MAX_ESCAPE_BITS && escapedBits < bits) {
+                int begin = partition == 0 ? 0 : partition * size - predictorOrder;
+                if (escapedBits < riceBits(residual, begin, begin + int(count), parameter)) {
+                    coding.parameters << RiceCoding::ESCAPE;
+                    coding.escapeBits[partition] = escapeBits;
+                    // Keep counting the upper bound, the codings are compared
+                    // with each other using upper bounds
+                    coding.bits += bits;
+                    continue;
+                }
+            }
+            coding.parameters << parameter;
+            coding.bits += bits;
+            maxParameter = qMax(maxParameter, parameter);
+        }
+        coding.parameterBits = maxParameter > MAX_RICE_PARAMETER ? 5 : 4;
+        coding.bits += partitionCount * coding.parameterBits;
+        if (coding.bits < best.bits) {
+            best = coding;
+        }
+
+        for (int partition = 0; partition < partitionCount / 2; ++partition) {
+            sums[partition] = sums.at(2 * partition) + sums.at(2 * partition + 1);
+            valueBits[partition] =
+                qMax(valueBits.at(2 * partition), valueBits.at(2 * partition + 1));
+        }
+    }
+    return best;
+}
+
+void writeResidual(BitWriter* writer,
+                   const QVector<qint32>& residual,
+                   int blockSize,
+                   int predictorOrder,
+                   const RiceCoding& coding) {
+    writer->write(coding.parameterBits == 5 ? 1 : 0, 2);
+    writer->write(coding.partitionOrder, 4);
+    int size = blockSize >> coding.partitionOrder;
+    int idx = 0;
+    for (int partition = 0; partition < coding.parameters.size(); ++partition) {
+        int parameter = coding.parameters.at(partition);
+        int end = (partition + 1) * size - predictorOrder;
+        if (parameter == RiceCoding::ESCAPE) {
+            int escapeBits = coding.escapeBits.at(partition);
+            writer->write((1 << coding.parameterBits) - 1, coding.parameterBits);
+            writer->write(escapeBits, ESCAPE_BITS_SIZE);
+            for (; idx < end; ++idx) {
+                writer->writeSigned(residual.at(idx), escapeBits);
+            }
+            continue;
+        }
+        writer->write(parameter, coding.parameterBits);
+        for (; idx < end; ++idx) {
+            writer->writeRice(residual.at(idx), parameter);
+        }
+    }
+}
+
+/**
+ * A candidate encoding for a subframe
+ */
+struct Subframe {
+    enum Type {
+        Constant,
+        Verbatim,
+        Fixed,
+        Lpc,
+    };
+    Type type = Verbatim;
+    int order = 0;
+    QVector<qint32> coefficients;
+    int shift = 0;
+    QVector<qint32> residual;
+    RiceCoding coding;
+    qint64 bits = std::numeric_limits<qint64>::max();
+};
+
+Subframe fixedSubframe(const qint32* samples, int count, int bits, int order) {
+    Subframe subframe;
+    subframe.type = Subframe::Fixed;
+    subframe.order = order;
+    subframe.residual.resize(count - order);
+    for (int idx = order; idx < count; ++idx) {
+        const qint32* x = samples + idx;
+        qint64 value = 0;
+        switch (order) {
+        case 0:
+            value = x[0];
+            break;
+        case 1:
+            value = qint64(x[0]) - x[-1];
+            break;
+        case 2:
+            value = qint64(x[0]) - 2 * qint64(x[-1]) + x[-2];
+            break;
+        case 3:
+            value = qint64(x[0]) - 3 * qint64(x[-1]) + 3 * qint64(x[-2]) - x[-3];
+            break;
+        case 4:
+            value = qint64(x[0]) - 4 * qint64(x[-1]) + 6 * qint64(x[-2]) - 4 * qint64(x[-3])
+                    + x[-4];
+            break;
+        }
+        subframe.residual[idx - order] = qint32(value);
+    }
+    subframe.coding = findRiceCoding(subframe.residual, count, order);
+    subframe.bits = SUBFRAME_HEADER_BITS + order * bits + subframe.coding.bits;
+    return subframe;
+}
+
+/**
+ * Computes the LPC coefficients for all orders up to `maxOrder` with the
+ * Levinson-Durbin recursion. Element `n - 1` of the result holds the
+ * coefficients of order `n`, such that sample `i` is predicted as the sum of
+ * `coefficients[j] * sample[i - 1 - j]`.
+ */
+QVector<QVector<double>> computeLpcCoefficients(const qint32* samples, int count, int maxOrder) {
+    // Welch window, to reduce the effect of the block edges
+    QVector<double> windowed(count);
+    double halfCount = (count - 1) / 2.;
+    for (int idx = 0; idx < count; ++idx) {
+        double k = halfCount > 0 ? (idx - halfCount) / halfCount : 0;
+        windowed[idx] = samples[idx] * (1 - k * k);
+    }
+
+    QVector<double> autocorrelation(maxOrder + 1, 0.);
+    for (int lag = 0; lag <= maxOrder; ++lag) {
+        double sum = 0;
+        for (int idx = lag; idx < count; ++idx) {
+            sum += windowed.at(idx) * windowed.at(idx - lag);
+        }
+        autocorrelation[lag] = sum;
+    }
+
+    QVector<QVector<double>> result;
+    double error = autocorrelation.at(0);
+    QVector<double> coefficients;
+    for (int order = 1; order <= maxOrder && error > 0; ++order) {
+        double reflection = autocorrelation.at(order);
+        for (int idx = 0; idx < order - 1; ++idx) {
+            reflection -= coefficients.at(idx) * autocorrelation.at(order - 1 - idx);
+        }
+        reflection /= error;
+
+        QVector<double> next(order);
+        for (int idx = 0; idx < order - 1; ++idx) {
+            next[idx] = coefficients.at(idx) - reflection * coefficients.at(order - 2 - idx);
+        }
+        next[order - 1] = reflection;
+        coefficients = next;
+        result << coefficients;
+        error *= 1 - reflection * reflection;
+    }
+    return result;
+}
+
+/**
+ * Returns an LPC subframe for `coefficients`, or a subframe with a maximum
+ * size if they cannot be quantized
+ */
+Subframe lpcSubframe(const qint32* samples,
+                     int count,
+                     int bits,
+                     const QVector<double>& coefficients) {
+    Subframe subframe;
+    int order = coefficients.size();
+
+    double maxCoefficient = 0;
+    for (double coefficient : coefficients) {
+        maxCoefficient = qMax(maxCoefficient, fabs(coefficient));
+    }
+    if (maxCoefficient <= 0) {
+        return subframe;
+    }
+    int exponent;
+    frexp(maxCoefficient, &exponent);
+    // Leave one bit for the sign. The shift is a 5 bits signed value, and
+    // negative values are not supported by decoders.
+    int shift = qMin(LPC_PRECISION - 1 - exponent, 15);
+    if (shift < 0) {
+        return subframe;
+    }
+
+    // Quantize, carrying the rounding error over to the next coefficient
+    qint32 maxQuantized = (1 << (LPC_PRECISION - 1)) - 1;
+    double error = 0;
+    subframe.coefficients.resize(order);
+    for (int idx = 0; idx < order; ++idx) {
+        error += coefficients.at(idx) * (1 << shift);
+        qint32 quantized = qBound(-maxQuantized - 1, qint32(lround(error)), maxQuantized);
+        subframe.coefficients[idx] = quantized;
+        error -= quantized;
+    }
+
+    subframe.residual.resize(count - order);
+    for (int idx = order; idx < count; ++idx) {
+        qint64 prediction = 0;
+        for (int coef = 0; coef < order; ++coef) {
+            prediction += qint64(subframe.coefficients.at(coef)) * samples[idx - 1 - coef];
+        }
+        qint64 value = samples[idx] - (prediction >> shift);
+        if (value < std::numeric_limits<qint32>::min()
+            || value > std::numeric_limits<qint32>::max()) {
+            return {};
+        }
+        subframe.residual[idx - order] = qint32(value);
+    }
+
+    subframe.type = Subframe::Lpc;
+    subframe.order = order;
+    subframe.shift = shift;
+    subframe.coding = findRiceCoding(subframe.residual, count, order);
+    subframe.bits = SUBFRAME_HEADER_BITS + order * bits + 4 + 5 + order * LPC_PRECISION
+                    + subframe.coding.bits;
+    return subframe;
+}
+
+Subframe findBestSubframe(const qint32* samples, int count, int bits) {
+    if (std::all_of(samples, samples + count, [samples](qint32 x) { return x == samples[0]; })) {
+        Subframe subframe;
+        subframe.type = Subframe::Constant;
+        return subframe;
+    }
+
+    Subframe best;
+    best.bits = SUBFRAME_HEADER_BITS + qint64(count) * bits;
+
+    for (int order = 0; order <= MAX_FIXED_ORDER && order < count; ++order) {
+        auto subframe = fixedSubframe(samples, count, bits, order);
+        if (subframe.bits < best.bits) {
+            best = subframe;
+        }
+    }
+
+    int maxLpcOrder = qMin(MAX_LPC_ORDER, count - 1);
+    for (const auto& coefficients : computeLpcCoefficients(samples, count, maxLpcOrder)) {
+        auto subframe = lpcSubframe(samples, count, bits, coefficients);
+        if (subframe.bits < best.bits) {
+            best = subframe;
+        }
+    }
+    return best;
+}
+
+void writeSubframe(BitWriter* writer,
+                   const Subframe& subframe,
+                   const qint32* samples,
+                   int count,
+                   int bits) {
+    // Zero padding bit, then the type, then the "wasted bits" flag
+    switch (subframe.type) {
+    case Subframe::Constant:
+        writer->write(0b00000000, 8);
+        writer->writeSigned(samples[0], bits);
+        return;
+    case Subframe::Verbatim:
+        writer->write(0b00000010, 8);
+        for (int idx = 0; idx < count; ++idx) {
+            writer->writeSigned(samples[idx], bits);
+        }
+        return;
+    case Subframe::Fixed:
+        writer->write(0b00010000 | (subframe.order << 1), 8);
+        break;
+    case Subframe::Lpc:
+        writer->write(0b01000000 | ((subframe.order - 1) << 1), 8);
+        break;
+    }
+
+    for (int idx = 0; idx < subframe.order; ++idx) {
+        writer->writeSigned(samples[idx], bits);
+    }
+    if (subframe.type == Subframe::Lpc) {
+        writer->write(LPC_PRECISION - 1, 4);
+        writer->writeSigned(subframe.shift, 5);
+        for (qint32 coefficient : subframe.coefficients) {
+            writer->writeSigned(coefficient, LPC_PRECISION);
+        }
+    }
+    writeResidual(writer, subframe.residual, count, subframe.order, subframe.coding);
+}
+
+int sampleRateCode(int sampleRate) {
+    switch (sampleRate) {
+    case 22050:
+        return 0b0110;
+    case 44100:
+        return 0b1001;
+    default:
+        // Read it from STREAMINFO
+        return 0;
+    }
+}
+
+int sampleSizeCode(int bits) {
+    switch (bits) {
+    case 8:
+        return 0b001;
+    case 16:
+        return 0b100;
+    default:
+        // Read it from STREAMINFO
+        return 0;
+    }
+}
+
+QByteArray encodeFrame(const qint32* samples,
+                       int count,
+                       quint32 frameNumber,
+                       int bits,
+                       int sampleRate) {
+    BitWriter writer;
+    writer.write(0b11111111111110, 14); // sync code
+    writer.write(0, 1);                 // reserved
+    writer.write(0, 1);                 // fixed block size
+    writer.write(0b0111, 4);            // block size is stored at the end of the header
+    writer.write(sampleRateCode(sampleRate), 4);
+    writer.write(0, 4); // mono
+    writer.write(sampleSizeCode(bits), 3);
+    writer.write(0, 1); // reserved
+    writer.writeUtf8(frameNumber);
+    writer.write(count - 1, 16);
+    writer.write(crc8(writer.bytes()), 8);
+
+    auto subframe = findBestSubframe(samples, count, bits);
+    writeSubframe(&writer, subframe, samples, count, bits);
+
+    writer.alignToByte();
+    writer.write(crc16(writer.bytes()), 16);
+    return writer.bytes();
+}
+
+QByteArray md5(const QVector<qint32>& samples, int bits) {
+    // The MD5 of the samples, as signed little-endian values
+    int bytesPerSample = (bits + 7) / 8;
+    QByteArray data;
+    data.reserve(samples.size() * bytesPerSample);
+    for (qint32 sample : samples) {
+        for (int idx = 0; idx < bytesPerSample; ++idx) {
+            data.append(char(sample >> (8 * idx)));
+        }
+    }
+    return QCryptographicHash::hash(data, QCryptographicHash::Md5);
+}
+
+} // namespace
+
+FlacEncoder::FlacEncoder(int bits, int sampleRate) : mBits(bits), mSampleRate(sampleRate) {
+}
+
+void FlacEncoder::setJobs(int jobs) {
+    mJobs = qMax(1, jobs);
+}
+
+void FlacEncoder::setBlockSize(int blockSize) {
+    Q_ASSERT(blockSize >= 16 && blockSize <= 65535);
+    mBlockSize = blockSize;
+}
+
+QByteArray FlacEncoder::encode(const QVector<qint32>& samples) const {
+    int frameCount = (samples.size() + mBlockSize - 1) / mBlockSize;
+    QVector<QByteArray> frames(frameCount);
+    auto encodeAt = [this, &samples, &frames](int index) {
+        int start = index * mBlockSize;
+        int count = qMin(mBlockSize, samples.size() - start);
+        frames[index] = encodeFrame(samples.constData() + start, count, index, mBits, mSampleRate);
+    };
+
+    Parallel::forEachIndex(frameCount, mJobs, encodeAt);
+
+    int minFrameSize = 0;
+    int maxFrameSize = 0;
+    for (const auto& frame : frames) {
+        minFrameSize = minFrameSize == 0 ? frame.size() : qMin(minFrameSize, frame.size());
+        maxFrameSize = qMax(maxFrameSize, frame.size());
+    }
+
+    BitWriter writer;
+    writer.write('f', 8);
+    writer.write('L', 8);
+    writer.write('a', 8);
+    writer.write('C', 8);
+
+    // STREAMINFO metadata block, the only one
+    writer.write(1, 1); // last metadata block
+    writer.write(0, 7); // STREAMINFO
+    writer.write(STREAMINFO_SIZE, 24);
+    writer.write(mBlockSize, 16); // min block size
+    writer.write(mBlockSize, 16); // max block size
+    writer.write(minFrameSize, 24);
+    writer.write(maxFrameSize, 24);
+    writer.write(mSampleRate, 20);
+    writer.write(0, 3); // channels - 1
+    writer.write(mBits - 1, 5);
+    writer.write(0, 4); // high bits of the sample count
+    writer.write(samples.size(), 32);
+    for (char byte : md5(samples, mBits)) {
+        writer.write(quint8(byte), 8);
+    }
+
+    QByteArray data = writer.bytes();
+    for (const auto& frame : frames) {
+        data.append(frame);
+    }
+    return data;
+}
@@ -0,0 +1,44 @@
+#ifndef FLACENCODER_H
+#define FLACENCODER_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * Encodes mono sounds to FLAC.
+ *
+ * Each block of samples is predicted either with one of the fixed polynomials
+ * of the format or with an LPC filter, whichever gives the smallest output,
+ * and the prediction residual is Rice coded. Blocks are independent, so they
+ * can be encoded by several threads.
+ */
+class FlacEncoder {
+public:
+    static constexpr int DEFAULT_BLOCK_SIZE = 4096;
+
+    FlacEncoder(int bits, int sampleRate);
+
+    /**
+     * Number of threads used to encode the blocks. Defaults to 1.
+     */
+    void setJobs(int jobs);
+
+    /**
+     * Number of samples per block. Must be between 16 and 65535.
+     */
+    void setBlockSize(int blockSize);
+
+    /**
+     * Returns a complete FLAC file for `samples`. The samples are signed and
+     * must fit in the bits per sample passed to the constructor.
+     */
+    QByteArray encode(const QVector<qint32>& samples) const;
+
+private:
+    const int mBits;
+    const int mSampleRate;
+    int mJobs = 1;
+    int mBlockSize = DEFAULT_BLOCK_SIZE;
+};
+
+#endif // FLACENCODER_H
@@ -1,24 +1,16 @@
 #include "NoiseGenerator.h"
 
-#include <stdlib.h>
-
-NoiseGenerator::NoiseGenerator(int sampleCount) : mSampleCount(sampleCount) {
+NoiseGenerator::NoiseGenerator() {
+    reset();
 }
 
 void NoiseGenerator::reset() {
-    mRandomSeed = 0;
-    mLastIndex = -1;
+    mRandom.reset(0);
+    nextPeriod();
 }
 
-qreal NoiseGenerator::get(qreal alpha) {
-    int index = int(mSampleCount * alpha);
-    if (index != mLastIndex) {
-        mLastIndex = index;
-        mLastValue = randomRange(2.0) - 1.0;
+void NoiseGenerator::nextPeriod() {
+    for (auto& value : mValues) {
+        value = mRandom.real(2.0) - 1.0;
     }
-    return mLastValue;
-}
-
-qreal NoiseGenerator::randomRange(qreal range) {
-    return rand_r(&mRandomSeed) / qreal(RAND_MAX) * range;
 }
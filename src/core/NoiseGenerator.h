@@ -1,14 +1,18 @@
 #ifndef NOISEGENERATOR_H
 #define NOISEGENERATOR_H
 
+#include "Random.h"
+
 #include <QtGlobal>
 
+#include <array>
+
 /**
  * Generates a reproducible sequence of random values between -1 and 1
  * for a period.
  *
- * The generator returns `sampleCount` (the constructor argument) different
- * values, stretched on the period.
+ * Each period is made of SAMPLE_COUNT random values, stretched on the period.
+ * They are computed in advance: call nextPeriod() when a new period starts.
  *
  * `alpha` the argument of the get() method, is a number between 0 and 1,
  * where 0 represents the start of the period and 1 the end.
@@ -17,17 +21,19 @@
  */
 class NoiseGenerator {
 public:
-    explicit NoiseGenerator(int sampleCount);
+    static constexpr int SAMPLE_COUNT = 32;
+
+    NoiseGenerator();
     void reset();
-    qreal get(qreal alpha);
+    void nextPeriod();
 
-private:
-    const int mSampleCount;
-    unsigned int mRandomSeed = 0;
-    int mLastIndex = -1;
-    qreal mLastValue = 0;
+    qreal get(qreal alpha) const {
+        return mValues[int(alpha * SAMPLE_COUNT)];
+    }
 
-    qreal randomRange(qreal range);
+private:
+    Random mRandom;
+    std::array<qreal, SAMPLE_COUNT> mValues;
 };
 
 #endif // NOISEGENERATOR_H
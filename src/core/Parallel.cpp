@@ -0,0 +1,46 @@
+#include "Parallel.h"
+
+#include <QRunnable>
+#include <QThreadPool>
+
+#include <atomic>
+
+namespace Parallel {
+
+class Runnable : public QRunnable {
+public:
+    explicit Runnable(const std::function<void()>& function) : mFunction(function) {
+    }
+
+    void run() override {
+        mFunction();
+    }
+
+private:
+    const std::function<void()> mFunction;
+};
+
+void forEachIndex(int count, int jobs, const std::function<void(int index)>& function) {
+    jobs = qMin(jobs, count);
+    if (jobs <= 1) {
+        for (int idx = 0; idx < count; ++idx) {
+            function(idx);
+        }
+        return;
+    }
+
+    std::atomic_int nextIndex{0};
+    auto worker = [&nextIndex, &function, count] {
+        for (int index = nextIndex++; index < count; index = nextIndex++) {
+            function(index);
+        }
+    };
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+    for (int idx = 0; idx < jobs; ++idx) {
+        pool.start(new Runnable(worker));
+    }
+    pool.waitForDone();
+}
+
+} // namespace Parallel
@@ -0,0 +1,22 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+/**
+ * Helpers to spread work over several threads, using only QtCore
+ */
+namespace Parallel {
+
+/**
+ * Calls `function` for each index from 0 to `count` - 1, using up to `jobs`
+ * threads. Returns once all the calls are done.
+ *
+ * Each thread takes the next index until there are none left, so a few long
+ * calls do not hold back the others.
+ */
+void forEachIndex(int count, int jobs, const std::function<void(int index)>& function);
+
+} // namespace Parallel
+
+#endif // PARALLEL_H
@@ -0,0 +1,228 @@
+#include "ParamBank.h"
+
+#include <QCoreApplication>
+#include <QtEndian>
+
+#include <limits>
+
+#include <string.h>
+
+static constexpr char MAGIC[] = "SFXRPARM";
+static constexpr int MAGIC_SIZE = 8;
+static constexpr int HEADER_SIZE = 32;
+static constexpr int RECORD_HEADER_SIZE = 24;
+static constexpr int RECORD_SIZE = RECORD_HEADER_SIZE + 8 * SoundParams::REAL_FIELD_COUNT;
+static constexpr char TAG_SEPARATOR = ',';
+
+// Offsets of the header fields
+static constexpr int VERSION_OFFSET = 8;
+static constexpr int FIELD_COUNT_OFFSET = 10;
+static constexpr int COUNT_OFFSET = 12;
+static constexpr int RECORD_SIZE_OFFSET = 16;
+static constexpr int RECORDS_OFFSET_OFFSET = 20;
+static constexpr int FILE_SIZE_OFFSET = 24;
+
+// Offsets of the record fields
+static constexpr int NAME_OFFSET = 0;
+static constexpr int TAGS_OFFSET = 8;
+static constexpr int WAVE_FORM_OFFSET = 16;
+
+template <typename T> static T readValue(const uchar* ptr) {
+    return qFromLittleEndian<T>(ptr);
+}
+
+template <typename T> static void appendValue(QByteArray* data, T value) {
+    int pos = data->size();
+    data->resize(pos + int(sizeof(T)));
+    qToLittleEndian(value, data->data() + pos);
+}
+
+static double readDouble(const uchar* ptr) {
+    quint64 bits = readValue<quint64>(ptr);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void appendDouble(QByteArray* data, double value) {
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    appendValue<quint64>(data, bits);
+}
+
+static Result createInvalidError(const QString& path, const QString& reason) {
+    auto message = QCoreApplication::translate("ParamBank", "Invalid parameter bank %1: %2.")
+                       .arg(path, reason);
+    return Result::createError(message);
+}
+
+ParamBank::ParamBank() {
+}
+
+ParamBank::~ParamBank() {
+    close();
+}
+
+Result ParamBank::open(const QString& path) {
+    close();
+    mFile.setFileName(path);
+    if (!mFile.open(QIODevice::ReadOnly)) {
+        auto message = QCoreApplication::translate("ParamBank", "Cannot open %1: %2.")
+                           .arg(path, mFile.errorString());
+        return Result::createError(message);
+    }
+    qint64 fileSize = mFile.size();
+    if (fileSize < HEADER_SIZE) {
+        close();
+        return createInvalidError(path, QCoreApplication::translate("ParamBank", "too short"));
+    }
+    mData = mFile.map(0, fileSize);
+    if (!mData) {
+        auto message = QCoreApplication::translate("ParamBank", "Cannot map %1: %2.")
+                           .arg(path, mFile.errorString());
+        close();
+        return Result::createError(message);
+    }
+
+    Result result;
+    int version = readValue<quint16>(mData + VERSION_OFFSET);
+    int fieldCount = readValue<quint16>(mData + FIELD_COUNT_OFFSET);
+    quint32 count = readValue<quint32>(mData + COUNT_OFFSET);
+    quint32 recordSize = readValue<quint32>(mData + RECORD_SIZE_OFFSET);
+    quint32 recordsOffset = readValue<quint32>(mData + RECORDS_OFFSET_OFFSET);
+    if (memcmp(mData, MAGIC, MAGIC_SIZE) != 0) {
+        result = createInvalidError(path, QCoreApplication::translate("ParamBank", "wrong magic"));
+    } else if (version != VERSION) {
+        result = createInvalidError(
+            path, QCoreApplication::translate("ParamBank", "unsupported version %1").arg(version));
+    } else if (readValue<quint64>(mData + FILE_SIZE_OFFSET) != quint64(fileSize)) {
+        result =
+            createInvalidError(path, QCoreApplication::translate("ParamBank", "truncated file"));
+    } else if (fieldCount != SoundParams::REAL_FIELD_COUNT || recordSize != RECORD_SIZE
+               || count > quint32(std::numeric_limits<int>::max())
+               || recordsOffset + quint64(count) * recordSize > quint64(fileSize)) {
+        result =
+            createInvalidError(path, QCoreApplication::translate("ParamBank", "invalid index"));
+    }
+    if (!result) {
+        close();
+        return result;
+    }
+    mCount = int(count);
+    mRecords = mData + recordsOffset;
+
+    // Check the strings once, so that accessors do not need to
+    for (int idx = 0; idx < mCount; ++idx) {
+        for (int offset : {NAME_OFFSET, TAGS_OFFSET}) {
+            const uchar* ptr = record(idx) + offset;
+            if (quint64(readValue<quint32>(ptr)) + readValue<quint32>(ptr + 4)
+                > quint64(fileSize)) {
+                close();
+                return createInvalidError(
+                    path, QCoreApplication::translate("ParamBank", "invalid record %1").arg(idx));
+            }
+        }
+    }
+    return {};
+}
+
+void ParamBank::close() {
+    if (mData) {
+        mFile.unmap(const_cast<uchar*>(mData));
+        mData = nullptr;
+    }
+    mFile.close();
+    mRecords = nullptr;
+    mCount = 0;
+}
+
+int ParamBank::count() const {
+    return mCount;
+}
+
+QString ParamBank::name(int index) const {
+    return string(record(index) + NAME_OFFSET);
+}
+
+QStringList ParamBank::tags(int index) const {
+    auto tags = string(record(index) + TAGS_OFFSET);
+    if (tags.isEmpty()) {
+        return {};
+    }
+    return tags.split(TAG_SEPARATOR);
+}
+
+SoundParams ParamBank::params(int index) const {
+    const uchar* ptr = record(index);
+    SoundParams params;
+    params.waveForm = WaveForm::Enum(readValue<quint32>(ptr + WAVE_FORM_OFFSET));
+    ptr += RECORD_HEADER_SIZE;
+    for (const auto& field : SoundParams::realFields()) {
+        params.*field.member = readDouble(ptr);
+        ptr += 8;
+    }
+    return params;
+}
+
+const uchar* ParamBank::record(int index) const {
+    Q_ASSERT(index >= 0 && index < mCount);
+    return mRecords + qint64(index) * RECORD_SIZE;
+}
+
+QString ParamBank::string(const uchar* offsetPtr) const {
+    auto str = reinterpret_cast<const char*>(mData + readValue<quint32>(offsetPtr));
+    return QString::fromUtf8(str, int(readValue<quint32>(offsetPtr + 4)));
+}
+
+void ParamBankWriter::addSound(const QString& name,
+                               const SoundParams& params,
+                               const QStringList& tags) {
+    Entry entry;
+    entry.name = name.toUtf8();
+    entry.tags = tags.join(TAG_SEPARATOR).toUtf8();
+    entry.params = params;
+    mEntries << entry;
+}
+
+Result ParamBankWriter::write(const QString& path) const {
+    qint64 stringsOffset = HEADER_SIZE + qint64(RECORD_SIZE) * mEntries.size();
+    QByteArray records;
+    QByteArray strings;
+    records.reserve(RECORD_SIZE * mEntries.size());
+    for (const auto& entry : mEntries) {
+        for (const auto& str : {entry.name, entry.tags}) {
+            appendValue<quint32>(&records, quint32(stringsOffset + strings.size()));
+            appendValue<quint32>(&records, quint32(str.size()));
+            strings.append(str);
+        }
+        appendValue<quint32>(&records, quint32(entry.params.waveForm));
+        appendValue<quint32>(&records, 0);
+        for (const auto& field : SoundParams::realFields()) {
+            appendDouble(&records, entry.params.*field.member);
+        }
+    }
+
+    QByteArray data;
+    data.append(MAGIC, MAGIC_SIZE);
+    appendValue<quint16>(&data, quint16(ParamBank::VERSION));
+    appendValue<quint16>(&data, quint16(SoundParams::REAL_FIELD_COUNT));
+    appendValue<quint32>(&data, quint32(mEntries.size()));
+    appendValue<quint32>(&data, quint32(RECORD_SIZE));
+    appendValue<quint32>(&data, quint32(HEADER_SIZE));
+    appendValue<quint64>(&data, quint64(stringsOffset + strings.size()));
+    data.append(records);
+    data.append(strings);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        auto message = QCoreApplication::translate("ParamBank", "Cannot open %1: %2.")
+                           .arg(path, file.errorString());
+        return Result::createError(message);
+    }
+    if (file.write(data) != data.size()) {
+        auto message = QCoreApplication::translate("ParamBank", "Cannot write %1: %2.")
+                           .arg(path, file.errorString());
+        return Result::createError(message);
+    }
+    return {};
+}
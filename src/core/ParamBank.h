@@ -0,0 +1,82 @@
+#ifndef PARAMBANK_H
+#define PARAMBANK_H
+
+#include "Result.h"
+#include "SoundParams.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QVector>
+
+/**
+ * A read-only library of sound parameters, stored in a single .sfxp file.
+ *
+ * Each sound has a name, a list of tags and its parameters. Sounds are stored
+ * as fixed-size records, so any of them can be read directly. The file is
+ * mapped in memory: opening it only checks the index, it does not allocate
+ * anything per sound, so libraries of many thousands of sounds open
+ * instantly.
+ *
+ * File layout, all values little-endian:
+ *
+ * - header (32 bytes): magic "SFXRPARM", version (u16), field count (u16),
+ *   record count (u32), record size (u32), records offset (u32), file size
+ *   (u64)
+ * - records: name offset (u32), name size (u32), tags offset (u32), tags
+ *   size (u32), wave form (u32), padding (u32), then the parameters in the
+ *   order of SoundParams::realFields(), as doubles
+ * - strings: names and tags, UTF-8. The tags of a sound are separated by
+ *   commas.
+ */
+class ParamBank {
+public:
+    static constexpr int VERSION = 1;
+    static constexpr char EXTENSION[] = "sfxp";
+
+    ParamBank();
+    ~ParamBank();
+    ParamBank(const ParamBank&) = delete;
+    ParamBank& operator=(const ParamBank&) = delete;
+
+    Result open(const QString& path);
+    void close();
+
+    int count() const;
+
+    QString name(int index) const;
+    QStringList tags(int index) const;
+    SoundParams params(int index) const;
+
+private:
+    QFile mFile;
+    const uchar* mData = nullptr;
+    const uchar* mRecords = nullptr;
+    int mCount = 0;
+
+    const uchar* record(int index) const;
+    QString string(const uchar* offsetPtr) const;
+};
+
+/**
+ * Creates ParamBank files
+ */
+class ParamBankWriter {
+public:
+    /**
+     * Adds a sound. Tags must not contain commas.
+     */
+    void addSound(const QString& name, const SoundParams& params, const QStringList& tags = {});
+
+    Result write(const QString& path) const;
+
+private:
+    struct Entry {
+        QByteArray name;
+        QByteArray tags;
+        SoundParams params;
+    };
+
+    QVector<Entry> mEntries;
+};
+
+#endif // PARAMBANK_H
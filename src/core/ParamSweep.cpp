@@ -0,0 +1,66 @@
+#include "ParamSweep.h"
+
+#include "BufferStrategy.h"
+#include "ContactSheet.h"
+#include "Parallel.h"
+#include "Synthesizer.h"
+
+namespace ParamSweep {
+
+qreal Axis::value(int step) const {
+    if (steps <= 1) {
+        return from;
+    }
+    return from + (to - from) * step / (steps - 1);
+}
+
+qreal SoundParams::*findField(const QString& name) {
+    for (const auto& field : SoundParams::realFields()) {
+        if (name == QLatin1String(field.name)) {
+            return field.member;
+        }
+    }
+    return nullptr;
+}
+
+QVector<Cell> run(const Options& options, ContactSheet* sheet) {
+    auto columnMember = findField(options.columns.field);
+    Q_ASSERT(columnMember);
+    auto rowMember = options.rows.has_value() ? findField(options.rows->field) : nullptr;
+    Q_ASSERT(!options.rows.has_value() || rowMember);
+    int rowCount = options.rows.has_value() ? options.rows->steps : 1;
+
+    QVector<Cell> cells;
+    cells.reserve(options.columns.steps * rowCount);
+    qint64 maxSampleCount = 0;
+    for (int row = 0; row < rowCount; ++row) {
+        for (int column = 0; column < options.columns.steps; ++column) {
+            Cell cell;
+            cell.column = column;
+            cell.row = row;
+            cell.params = options.base;
+            cell.params.*columnMember = options.columns.value(column);
+            if (rowMember) {
+                cell.params.*rowMember = options.rows->value(row);
+            }
+            maxSampleCount = qMax(maxSampleCount, Synthesizer::maxSampleCount(cell.params));
+            cells << cell;
+        }
+    }
+    if (sheet) {
+        sheet->setCellSampleCount(int(maxSampleCount));
+    }
+
+    auto* cellData = cells.data();
+    Parallel::forEachIndex(cells.size(), options.jobs, [cellData, sheet](int index) {
+        auto* cell = cellData + index;
+        auto samples = renderSamples<RawBufferStrategy>(cell->params);
+        cell->features = SoundFeatures::fromSamples(samples);
+        if (sheet) {
+            sheet->drawCell(cell->column, cell->row, samples);
+        }
+    });
+    return cells;
+}
+
+} // namespace ParamSweep
@@ -0,0 +1,67 @@
+#ifndef PARAMSWEEP_H
+#define PARAMSWEEP_H
+
+#include "SoundFeatures.h"
+#include "SoundParams.h"
+
+#include <QString>
+#include <QVector>
+
+#include <optional>
+
+class ContactSheet;
+
+/**
+ * Renders a grid of variations of a sound, where one or two parameters change
+ * along the columns and the rows, to see how sensitive the sound is to them.
+ *
+ * The cells are synthesized and analyzed on several threads.
+ */
+namespace ParamSweep {
+
+/**
+ * The values taken by a parameter along the columns or the rows of the grid
+ */
+struct Axis {
+    /** Name of one of SoundParams::realFields() */
+    QString field;
+    qreal from = 0;
+    qreal to = 1;
+    int steps = 1;
+
+    /**
+     * Returns the value at step `step`. The first step is `from` and the last
+     * one is `to`.
+     */
+    qreal value(int step) const;
+};
+
+/**
+ * Returns the member of SoundParams named `name`, or null if there is none
+ */
+qreal SoundParams::*findField(const QString& name);
+
+struct Cell {
+    int column = 0;
+    int row = 0;
+    SoundParams params;
+    SoundFeatures features;
+};
+
+struct Options {
+    SoundParams base;
+    Axis columns;
+    /** If not set, the grid has a single row */
+    std::optional<Axis> rows;
+    int jobs = 1;
+};
+
+/**
+ * Returns the cells of the grid, row by row. If `sheet` is not null, also
+ * draws the cells on it. It must have as many columns and rows as the grid.
+ */
+QVector<Cell> run(const Options& options, ContactSheet* sheet = nullptr);
+
+} // namespace ParamSweep
+
+#endif // PARAMSWEEP_H
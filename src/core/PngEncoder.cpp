@@ -0,0 +1,87 @@
+#include "PngEncoder.h"
+
+#include <QtEndian>
+
+#include <array>
+
+namespace PngEncoder {
+
+static const char SIGNATURE[] = "\x89PNG\r\n\x1a\n";
+
+static constexpr quint8 BIT_DEPTH = 8;
+static constexpr quint8 COLOR_TYPE_RGB = 2;
+
+// Each row starts with the filter applied to it. The Sub filter stores the
+// difference with the pixel on the left, which turns the flat areas of the
+// images into runs of zeros.
+static constexpr char FILTER_SUB = 1;
+
+static quint32 crc32(const QByteArray& data) {
+    static const auto TABLE = [] {
+        std::array<quint32, 256> table;
+        for (quint32 idx = 0; idx < 256; ++idx) {
+            quint32 crc = idx;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+            }
+            table[idx] = crc;
+        }
+        return table;
+    }();
+    quint32 crc = 0xffffffff;
+    for (char byte : data) {
+        crc = (crc >> 8) ^ TABLE[(crc ^ quint8(byte)) & 0xff];
+    }
+    return crc ^ 0xffffffff;
+}
+
+static void appendUInt32(QByteArray* data, quint32 value) {
+    char bytes[4];
+    qToBigEndian(value, bytes);
+    data->append(bytes, 4);
+}
+
+static void appendChunk(QByteArray* png, const char* type, const QByteArray& content) {
+    QByteArray chunk(type);
+    chunk.append(content);
+    appendUInt32(png, quint32(content.size()));
+    png->append(chunk);
+    // The CRC covers the type and the content, but not the length
+    appendUInt32(png, crc32(chunk));
+}
+
+QByteArray encode(const QVector<quint32>& pixels, int width, int height) {
+    Q_ASSERT(pixels.size() == width * height);
+    QByteArray header;
+    appendUInt32(&header, quint32(width));
+    appendUInt32(&header, quint32(height));
+    header.append(char(BIT_DEPTH));
+    header.append(char(COLOR_TYPE_RGB));
+    // Compression, filter and interlace methods: the only ones defined
+    header.append(3, '\0');
+
+    QByteArray rows;
+    rows.reserve(height * (1 + width * 3));
+    for (int y = 0; y < height; ++y) {
+        rows.append(FILTER_SUB);
+        quint32 previous = 0;
+        for (int x = 0; x < width; ++x) {
+            quint32 pixel = pixels.at(y * width + x);
+            for (int shift = 16; shift >= 0; shift -= 8) {
+                rows.append(char(quint8((pixel >> shift) - (previous >> shift))));
+            }
+            previous = pixel;
+        }
+    }
+    // qCompress() prefixes the zlib stream with the size of the uncompressed
+    // data, which PNG does not want
+    QByteArray compressed = qCompress(rows).mid(4);
+
+    QByteArray png(SIGNATURE, sizeof(SIGNATURE) - 1);
+    appendChunk(&png, "IHDR", header);
+    appendChunk(&png, "IDAT", compressed);
+    appendChunk(&png, "IEND", {});
+    return png;
+}
+
+} // namespace PngEncoder
@@ -0,0 +1,23 @@
+#ifndef PNGENCODER_H
+#define PNGENCODER_H
+
+#include <QByteArray>
+#include <QVector>
+
+/**
+ * Encodes RGB images to PNG.
+ *
+ * Only depends on QtCore, which compresses the pixels, so that the command
+ * line tool can write images without linking with QtGui.
+ */
+namespace PngEncoder {
+
+/**
+ * Returns a complete PNG file for an image of `width` x `height` pixels.
+ * `pixels` stores the rows from top to bottom, each pixel as a 0xRRGGBB value.
+ */
+QByteArray encode(const QVector<quint32>& pixels, int width, int height);
+
+} // namespace PngEncoder
+
+#endif // PNGENCODER_H
@@ -0,0 +1,8 @@
+#include "Random.h"
+
+#include <random>
+
+quint64 Random::randomSeed() {
+    std::random_device device;
+    return (quint64(device()) << 32) | device();
+}
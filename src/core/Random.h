@@ -0,0 +1,66 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <QtGlobal>
+
+/**
+ * A small and fast pseudo-random number generator, implementing PCG32 (see
+ * https://www.pcg-random.org).
+ *
+ * Unlike std::rand(), it has no global state: each thread can use its own
+ * generator, without locking. A given seed produces the same sequence on all
+ * platforms, so random sounds can be reproduced from their seed.
+ */
+class Random {
+public:
+    explicit Random(quint64 seed = 0) {
+        reset(seed);
+    }
+
+    /**
+     * Restarts the sequence, from `seed`
+     */
+    void reset(quint64 seed) {
+        mState = 0;
+        next();
+        mState += seed;
+        next();
+    }
+
+    quint32 next() {
+        quint64 oldState = mState;
+        mState = oldState * MULTIPLIER + INCREMENT;
+        auto xorShifted = quint32(((oldState >> 18) ^ oldState) >> 27);
+        auto rotation = int(oldState >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((-rotation) & 31));
+    }
+
+    /**
+     * Returns an integer between 0 and `max`, inclusive
+     */
+    int range(int max) {
+        return int((quint64(next()) * quint64(max + 1)) >> 32);
+    }
+
+    /**
+     * Returns a real between 0 (inclusive) and `max` (exclusive)
+     */
+    qreal real(qreal max) {
+        return next() * (max / 4294967296.0);
+    }
+
+    /**
+     * Returns a seed which is different each time, to get a different
+     * sequence on each run
+     */
+    static quint64 randomSeed();
+
+private:
+    static constexpr quint64 MULTIPLIER = 6364136223846793005ULL;
+    // The default stream of the reference implementation
+    static constexpr quint64 INCREMENT = 1442695040888963407ULL;
+
+    quint64 mState;
+};
+
+#endif // RANDOM_H
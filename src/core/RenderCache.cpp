@@ -0,0 +1,201 @@
+#include "RenderCache.h"
+
+#include "SoundParams.h"
+#include "Synthesizer.h"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QtEndian>
+
+#include <string.h>
+
+static constexpr char MAGIC[] = "SFXRPCM1";
+static constexpr int MAGIC_SIZE = 8;
+static constexpr int HEADER_SIZE = 16;
+static constexpr char ENTRY_SUFFIX[] = ".pcm";
+static const QStringList ENTRY_FILTERS = {QStringLiteral("*.pcm")};
+static constexpr char VERSION_DIR_PREFIX[] = "engine-";
+
+// The settings of the entries used by findSamples() and insertSamples(). Must
+// match the default settings of WavSaver, and the conversion it does.
+static constexpr int SAMPLES_BITS = 16;
+static constexpr int SAMPLES_FREQUENCY = 44100;
+static constexpr qreal SAMPLES_SCALE = 32000;
+
+// Once the cache is full, evict entries until it is down to this ratio of the
+// maximum size, so that the directory is not scanned for each new entry
+static constexpr qreal EVICTION_RATIO = 0.75;
+
+RenderCache::RenderCache() {
+}
+
+Result RenderCache::open(const QString& dir, qint64 maxSize) {
+    QDir rootDir(dir);
+    auto versionDirName = VERSION_DIR_PREFIX + QString::number(Synthesizer::VERSION);
+    if (!rootDir.mkpath(versionDirName)) {
+        auto message = QCoreApplication::translate("RenderCache", "Cannot create directory %1.")
+                           .arg(rootDir.filePath(versionDirName));
+        return Result::createError(message);
+    }
+
+    // Renders from other versions of the synthesizer are not valid anymore
+    auto filters = QStringList{QString(VERSION_DIR_PREFIX) + "*"};
+    for (const auto& name : rootDir.entryList(filters, QDir::Dirs | QDir::NoDotAndDotDot)) {
+        if (name != versionDirName) {
+            QDir(rootDir.filePath(name)).removeRecursively();
+        }
+    }
+
+    QMutexLocker lock(&mMutex);
+    mDir = rootDir.filePath(versionDirName);
+    mMaxSize = maxSize;
+    mSize = 0;
+    for (const auto& info : QDir(mDir).entryInfoList(ENTRY_FILTERS, QDir::Files)) {
+        mSize += info.size();
+    }
+    return {};
+}
+
+bool RenderCache::isOpen() const {
+    return !mDir.isEmpty();
+}
+
+QString RenderCache::defaultDir() {
+    // Not CacheLocation: it depends on the application name, and the cache is
+    // shared by the app and sfxr-render
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+           + "/sfxr-qt/renders";
+}
+
+RenderCache* RenderCache::instance() {
+    static RenderCache* instance = [] {
+        auto* cache = new RenderCache;
+        auto result = cache->open(defaultDir());
+        if (!result) {
+            qWarning("%s", qUtf8Printable(result.message()));
+        }
+        return cache;
+    }();
+    return instance->isOpen() ? instance : nullptr;
+}
+
+QString RenderCache::key(const SoundParams& params, int bits, int frequency) {
+    return QString("%1-%2-%3").arg(params.hash(), 16, 16, QChar('0')).arg(bits).arg(frequency);
+}
+
+bool RenderCache::find(const QString& key, QByteArray* pcm) const {
+    if (!isOpen()) {
+        return false;
+    }
+    QFile file(entryPath(key));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    auto data = file.readAll();
+    if (data.size() < HEADER_SIZE || memcmp(data.constData(), MAGIC, MAGIC_SIZE) != 0
+        || qFromLittleEndian<quint64>(data.constData() + MAGIC_SIZE)
+               != quint64(data.size() - HEADER_SIZE)) {
+        // Entries are written atomically, so this can only be a corrupted
+        // file: remove it
+        file.close();
+        file.remove();
+        return false;
+    }
+    // Mark the entry as recently used
+    file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    *pcm = data.mid(HEADER_SIZE);
+    return true;
+}
+
+void RenderCache::insert(const QString& key, const QByteArray& pcm) {
+    if (!isOpen()) {
+        return;
+    }
+    QByteArray header(HEADER_SIZE, Qt::Uninitialized);
+    memcpy(header.data(), MAGIC, MAGIC_SIZE);
+    qToLittleEndian<quint64>(quint64(pcm.size()), header.data() + MAGIC_SIZE);
+
+    // QSaveFile writes to a temporary file, then renames it: readers never
+    // see partial entries, even from other processes
+    QSaveFile file(entryPath(key));
+    if (!file.open(QIODevice::WriteOnly) || file.write(header) != header.size()
+        || file.write(pcm) != pcm.size() || !file.commit()) {
+        // The cache is only an optimization, failing to fill it is not an
+        // error
+        return;
+    }
+
+    QMutexLocker lock(&mMutex);
+    mSize += HEADER_SIZE + pcm.size();
+    if (mSize > mMaxSize) {
+        evict();
+    }
+}
+
+bool RenderCache::findSamples(const SoundParams& params, QVector<qreal>* samples) const {
+    QByteArray pcm;
+    if (!find(key(params, SAMPLES_BITS, SAMPLES_FREQUENCY), &pcm)) {
+        return false;
+    }
+    auto ptr = reinterpret_cast<const uchar*>(pcm.constData());
+    int count = pcm.size() / 2;
+    samples->resize(count);
+    for (int idx = 0; idx < count; ++idx) {
+        (*samples)[idx] = qFromLittleEndian<qint16>(ptr + 2 * idx) / SAMPLES_SCALE;
+    }
+    return true;
+}
+
+void RenderCache::insertSamples(const SoundParams& params, const QVector<qreal>& samples) {
+    QByteArray pcm(samples.size() * 2, Qt::Uninitialized);
+    auto ptr = reinterpret_cast<uchar*>(pcm.data());
+    for (int idx = 0; idx < samples.size(); ++idx) {
+        qToLittleEndian(qint16(samples.at(idx) * SAMPLES_SCALE), ptr + 2 * idx);
+    }
+    insert(key(params, SAMPLES_BITS, SAMPLES_FREQUENCY), pcm);
+}
+
+qint64 RenderCache::size() const {
+    QMutexLocker lock(&mMutex);
+    return mSize;
+}
+
+void RenderCache::clear() {
+    QMutexLocker lock(&mMutex);
+    if (!isOpen()) {
+        return;
+    }
+    QDir dir(mDir);
+    for (const auto& name : dir.entryList(ENTRY_FILTERS, QDir::Files)) {
+        dir.remove(name);
+    }
+    mSize = 0;
+}
+
+QString RenderCache::entryPath(const QString& key) const {
+    return mDir + '/' + key + ENTRY_SUFFIX;
+}
+
+void RenderCache::evict() {
+    // Scan the directory rather than trusting mSize: other processes may have
+    // added or removed entries
+    QDir dir(mDir);
+    auto infos = dir.entryInfoList(ENTRY_FILTERS, QDir::Files, QDir::Time);
+    mSize = 0;
+    for (const auto& info : infos) {
+        mSize += info.size();
+    }
+    // QDir::Time sorts the most recent entries first
+    auto targetSize = qint64(mMaxSize * EVICTION_RATIO);
+    for (auto it = infos.crbegin(); it != infos.crend() && mSize > targetSize; ++it) {
+        if (dir.remove(it->fileName())) {
+            mSize -= it->size();
+        }
+    }
+}
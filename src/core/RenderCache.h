@@ -0,0 +1,97 @@
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include "Result.h"
+
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+struct SoundParams;
+
+/**
+ * A persistent cache of rendered sounds, reused across runs.
+ *
+ * Each entry holds the PCM data rendered for a sound with some render
+ * settings (bits per sample and sample rate), as WavSaver produces it. Entries
+ * are identified by a hash of the sound parameters and of the settings, and
+ * are stored in a subdirectory specific to the version of the synthesizer, so
+ * changing the synthesizer invalidates them.
+ *
+ * When the entries take more than the maximum size, the least recently used
+ * ones are removed.
+ *
+ * All methods can be called from several threads at the same time, and
+ * several processes can share the same directory.
+ *
+ * Entry layout, all values little-endian: magic "SFXRPCM1", data size (u64),
+ * then the PCM data.
+ */
+class RenderCache {
+public:
+    static constexpr qint64 DEFAULT_MAX_SIZE = 512 * 1024 * 1024;
+
+    RenderCache();
+
+    /**
+     * Opens the cache stored in `dir`, creating it if necessary. Removes
+     * the entries created by other versions of the synthesizer.
+     */
+    Result open(const QString& dir, qint64 maxSize = DEFAULT_MAX_SIZE);
+
+    bool isOpen() const;
+
+    /**
+     * The default location of the cache. It is shared by sfxr-qt and
+     * sfxr-render.
+     */
+    static QString defaultDir();
+
+    /**
+     * The cache used by the user interface, opened in defaultDir(). Returns
+     * null if it cannot be opened.
+     */
+    static RenderCache* instance();
+
+    /**
+     * Identifies the render of `params` with the given settings
+     */
+    static QString key(const SoundParams& params, int bits, int frequency);
+
+    /**
+     * Returns true and sets `pcm` if there is an entry for `key`
+     */
+    bool find(const QString& key, QByteArray* pcm) const;
+
+    void insert(const QString& key, const QByteArray& pcm);
+
+    /**
+     * Looks for the samples of `params`, as a WavSaver with the default
+     * settings renders them, and converts them back to synthesizer samples
+     */
+    bool findSamples(const SoundParams& params, QVector<qreal>* samples) const;
+
+    /**
+     * Stores samples produced by the synthesizer for `params`. They must be
+     * clamped to [-1, 1].
+     */
+    void insertSamples(const SoundParams& params, const QVector<qreal>& samples);
+
+    /**
+     * Total size of the entries, in bytes
+     */
+    qint64 size() const;
+
+    void clear();
+
+private:
+    QString mDir;
+    qint64 mMaxSize = 0;
+    mutable QMutex mMutex;
+    qint64 mSize = 0;
+
+    QString entryPath(const QString& key) const;
+    void evict();
+};
+
+#endif // RENDERCACHE_H
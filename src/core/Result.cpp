@@ -1,6 +1,6 @@
 #include "Result.h"
 
-#include <QQmlApplicationEngine>
+#include <QMetaType>
 
 Result::Result() {
 }
@@ -0,0 +1,100 @@
+#include "SimilarSoundFinder.h"
+
+#include "FeatureIndex.h"
+#include "Sound.h"
+#include "SoundFeatures.h"
+#include "SoundParams.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+#include <QUrl>
+#include <QVariantMap>
+
+class SimilarSoundJob : public QRunnable {
+public:
+    SimilarSoundJob(SimilarSoundFinder* finder,
+                    const SoundParams& params,
+                    const QString& soundPath,
+                    const QString& dir,
+                    int count)
+            : mFinder(finder), mParams(params), mSoundPath(soundPath), mDir(dir), mCount(count) {
+    }
+
+    void run() override {
+        auto indexPath = FeatureIndex::defaultPath(mDir);
+        FeatureIndex index;
+        if (QFileInfo::exists(indexPath)) {
+            // If the index is invalid, update() rebuilds it
+            index.load(indexPath);
+        }
+        QStringList errors;
+        int updatedCount = index.update(
+            FeatureIndex::findSoundFiles(mDir), QThread::idealThreadCount(), &errors);
+        if (updatedCount > 0) {
+            auto result = index.save(indexPath);
+            if (!result) {
+                // Not fatal, the next search computes the features again
+                qWarning("%s", qUtf8Printable(result.message()));
+            }
+        }
+
+        auto query = FeatureIndex::featureVector(SoundFeatures::fromParams(mParams));
+        QVariantList matches;
+        for (const auto& match : index.findNearest(query, mCount, mSoundPath)) {
+            matches << QVariantMap{{"url", QUrl::fromLocalFile(match.path)},
+                                   {"name", QFileInfo(match.path).completeBaseName()},
+                                   {"distance", match.distance}};
+        }
+
+        Result result;
+        if (!errors.isEmpty()) {
+            auto message = QCoreApplication::translate(
+                               "SimilarSoundFinder", "%n sound(s) could not be loaded:\n%1", "",
+                               errors.size())
+                               .arg(errors.mid(0, 10).join('\n'));
+            result = Result::createError(message);
+        }
+        auto* finder = mFinder;
+        QMetaObject::invokeMethod(
+            finder, [finder, matches, result] { finder->onJobDone(matches, result); },
+            Qt::QueuedConnection);
+    }
+
+private:
+    SimilarSoundFinder* const mFinder;
+    const SoundParams mParams;
+    const QString mSoundPath;
+    const QString mDir;
+    const int mCount;
+};
+
+SimilarSoundFinder::SimilarSoundFinder(QObject* parent) : QObject(parent) {
+    mThreadPool.setMaxThreadCount(1);
+}
+
+SimilarSoundFinder::~SimilarSoundFinder() {
+    mThreadPool.waitForDone();
+}
+
+void SimilarSoundFinder::find(Sound* sound, const QUrl& dirUrl, int count) {
+    if (mBusy) {
+        return;
+    }
+    auto soundPath = sound->hasRealUrl() ? sound->url().toLocalFile() : QString();
+    mThreadPool.start(new SimilarSoundJob(
+        this, SoundParams::fromSound(sound), soundPath, dirUrl.toLocalFile(), count));
+    mBusy = true;
+    busyChanged(true);
+}
+
+bool SimilarSoundFinder::isBusy() const {
+    return mBusy;
+}
+
+void SimilarSoundFinder::onJobDone(const QVariantList& matches, const Result& result) {
+    mBusy = false;
+    busyChanged(false);
+    finished(matches, result);
+}
@@ -0,0 +1,56 @@
+#ifndef SIMILARSOUNDFINDER_H
+#define SIMILARSOUNDFINDER_H
+
+#include "Result.h"
+
+#include <QObject>
+#include <QThreadPool>
+#include <QVariantList>
+
+class QUrl;
+class Sound;
+
+/**
+ * Finds the sounds of a directory which sound the closest to a sound, in a
+ * background thread, for the user interface.
+ *
+ * The feature index of the directory is stored at FeatureIndex::defaultPath()
+ * and shared with `sfxr-render --library`: only the first search in a
+ * directory has to synthesize all its sounds.
+ */
+class SimilarSoundFinder : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool busy READ isBusy NOTIFY busyChanged)
+public:
+    explicit SimilarSoundFinder(QObject* parent = nullptr);
+    ~SimilarSoundFinder();
+
+    /**
+     * Starts looking for the `count` sounds of the directory at `dirUrl`
+     * closest to `sound`, and emits finished() once done. Does nothing if a
+     * search is already running.
+     */
+    Q_INVOKABLE void find(Sound* sound, const QUrl& dirUrl, int count);
+
+    bool isBusy() const;
+
+signals:
+    void busyChanged(bool busy);
+
+    /**
+     * `matches` is a list of objects with `url`, `name` and `distance`
+     * properties, closest first. `result` holds the error if some sounds of
+     * the directory could not be loaded: the other sounds are still searched.
+     */
+    void finished(const QVariantList& matches, const Result& result);
+
+private:
+    friend class SimilarSoundJob;
+
+    void onJobDone(const QVariantList& matches, const Result& result);
+
+    QThreadPool mThreadPool;
+    bool mBusy = false;
+};
+
+#endif // SIMILARSOUNDFINDER_H
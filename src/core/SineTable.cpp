@@ -0,0 +1,26 @@
+#include "SineTable.h"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr qreal TWO_PI = 6.28318530717958647692;
+
+SineTable::SineTable() {
+    for (int idx = 0; idx < int(mValues.size()); ++idx) {
+        mValues[idx] = std::sin(TWO_PI * idx / SIZE);
+    }
+}
+
+const SineTable& SineTable::instance() {
+    static const SineTable table;
+    return table;
+}
+
+qreal SineTable::maxError(int count) const {
+    qreal error = 0;
+    for (int idx = 0; idx < count; ++idx) {
+        qreal x = TWO_PI * idx / count;
+        error = std::max(error, std::abs(sin(x) - std::sin(x)));
+    }
+    return error;
+}
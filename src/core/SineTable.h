@@ -0,0 +1,57 @@
+#ifndef SINETABLE_H
+#define SINETABLE_H
+
+#include <QtGlobal>
+
+#include <array>
+#include <cmath>
+
+/**
+ * Computes sines by linear interpolation in a table, which is several times
+ * faster than the libm sin() function. The maximum error is below 5e-6, less
+ * than the resolution of 16-bit samples.
+ */
+class SineTable {
+public:
+    static constexpr int SIZE = 1024;
+
+    /**
+     * Returns the shared table
+     */
+    static const SineTable& instance();
+
+    /**
+     * Returns sin(2 * pi * turns), for `turns` in [0, 1)
+     */
+    qreal sinTurns(qreal turns) const {
+        qreal pos = turns * SIZE;
+        int idx = int(pos);
+        qreal delta = pos - idx;
+        return mValues[idx] + delta * (mValues[idx + 1] - mValues[idx]);
+    }
+
+    /**
+     * Returns sin(x), for any finite `x`
+     */
+    qreal sin(qreal x) const {
+        qreal turns = x * INV_TWO_PI;
+        return sinTurns(turns - std::floor(turns));
+    }
+
+    /**
+     * Returns the maximum difference between sin() and the libm sin(), on
+     * `count` values evenly distributed over a period
+     */
+    qreal maxError(int count) const;
+
+private:
+    SineTable();
+
+    static constexpr qreal INV_TWO_PI = 0.15915494309189533577;
+
+    // Two more values than SIZE: one for the interpolation of the last
+    // interval, one in case rounding makes sin() ask for 1 turn
+    std::array<qreal, SIZE + 2> mValues;
+};
+
+#endif // SINETABLE_H
@@ -1,6 +1,7 @@
 #include "Sound.h"
 
 #include "SoundIO.h"
+#include "SoundParams.h"
 
 #include <QDebug>
 #include <QFile>
@@ -129,3 +130,77 @@ void Sound::setUnsavedName(const QString& name) {
 void Sound::scheduleEmitModified() {
     mModifiedTimer.start();
 }
+
+// Defined here rather than in SoundParams.cpp, so that libsfxr can use
+// SoundParams without Sound
+SoundParams SoundParams::fromSound(const Sound* sound) {
+    SoundParams params;
+    params.waveForm = sound->waveForm();
+
+    params.attackTime = sound->attackTime();
+    params.sustainTime = sound->sustainTime();
+    params.sustainPunch = sound->sustainPunch();
+    params.decayTime = sound->decayTime();
+
+    params.baseFrequency = sound->baseFrequency();
+    params.minFrequency = sound->minFrequency();
+    params.slide = sound->slide();
+    params.deltaSlide = sound->deltaSlide();
+    params.vibratoDepth = sound->vibratoDepth();
+    params.vibratoSpeed = sound->vibratoSpeed();
+
+    params.changeAmount = sound->changeAmount();
+    params.changeSpeed = sound->changeSpeed();
+
+    params.squareDuty = sound->squareDuty();
+    params.dutySweep = sound->dutySweep();
+
+    params.repeatSpeed = sound->repeatSpeed();
+
+    params.phaserOffset = sound->phaserOffset();
+    params.phaserSweep = sound->phaserSweep();
+
+    params.lpFilterCutoff = sound->lpFilterCutoff();
+    params.lpFilterCutoffSweep = sound->lpFilterCutoffSweep();
+    params.lpFilterResonance = sound->lpFilterResonance();
+    params.hpFilterCutoff = sound->hpFilterCutoff();
+    params.hpFilterCutoffSweep = sound->hpFilterCutoffSweep();
+
+    params.volume = sound->volume();
+    return params;
+}
+
+void SoundParams::applyTo(Sound* sound) const {
+    sound->setWaveForm(waveForm);
+
+    sound->setAttackTime(attackTime);
+    sound->setSustainTime(sustainTime);
+    sound->setSustainPunch(sustainPunch);
+    sound->setDecayTime(decayTime);
+
+    sound->setBaseFrequency(baseFrequency);
+    sound->setMinFrequency(minFrequency);
+    sound->setSlide(slide);
+    sound->setDeltaSlide(deltaSlide);
+    sound->setVibratoDepth(vibratoDepth);
+    sound->setVibratoSpeed(vibratoSpeed);
+
+    sound->setChangeAmount(changeAmount);
+    sound->setChangeSpeed(changeSpeed);
+
+    sound->setSquareDuty(squareDuty);
+    sound->setDutySweep(dutySweep);
+
+    sound->setRepeatSpeed(repeatSpeed);
+
+    sound->setPhaserOffset(phaserOffset);
+    sound->setPhaserSweep(phaserSweep);
+
+    sound->setLpFilterCutoff(lpFilterCutoff);
+    sound->setLpFilterCutoffSweep(lpFilterCutoffSweep);
+    sound->setLpFilterResonance(lpFilterResonance);
+    sound->setHpFilterCutoff(hpFilterCutoff);
+    sound->setHpFilterCutoffSweep(hpFilterCutoffSweep);
+
+    sound->setVolume(volume);
+}
@@ -0,0 +1,444 @@
+#include "SoundBank.h"
+
+#include <QCoreApplication>
+#include <QtEndian>
+
+#include <string.h>
+
+static constexpr char MAGIC[] = "SFXRBANK";
+static constexpr int MAGIC_SIZE = 8;
+static constexpr int HEADER_SIZE = 32;
+static constexpr int ENTRY_SIZE = 32;
+static constexpr int ADPCM_HEADER_SIZE = 4;
+
+// Offsets of the header fields
+static constexpr int VERSION_OFFSET = 8;
+static constexpr int ENCODING_OFFSET = 10;
+static constexpr int SAMPLE_RATE_OFFSET = 12;
+static constexpr int COUNT_OFFSET = 16;
+static constexpr int BUCKET_COUNT_OFFSET = 20;
+static constexpr int FILE_SIZE_OFFSET = 24;
+
+// Offsets of the entry fields
+static constexpr int NAME_HASH_OFFSET = 0;
+static constexpr int NAME_OFFSET_OFFSET = 4;
+static constexpr int NAME_SIZE_OFFSET = 8;
+static constexpr int SAMPLE_COUNT_OFFSET = 12;
+static constexpr int DATA_OFFSET_OFFSET = 16;
+static constexpr int DATA_SIZE_OFFSET = 24;
+
+static Result createInvalidError(const QString& path, const QString& reason) {
+    auto message =
+        QCoreApplication::translate("SoundBank", "Invalid sound bank %1: %2.").arg(path, reason);
+    return Result::createError(message);
+}
+
+template <typename T> static T readValue(const uchar* ptr) {
+    return qFromLittleEndian<T>(ptr);
+}
+
+template <typename T> static void appendValue(QByteArray* data, T value) {
+    int pos = data->size();
+    data->resize(pos + int(sizeof(T)));
+    qToLittleEndian(value, data->data() + pos);
+}
+
+static qint64 alignUp(qint64 value, int alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+namespace ImaAdpcm {
+
+static const int STEPS[89] = {
+    7,     8,     9,     10,    11,    12,    13,    14,    16,    17,    19,    21,    23,
+    25,    28,    31,    34,    37,    41,    45,    50,    55,    60,    66,    73,    80,
+    88,    97,    107,   118,   130,   143,   157,   173,   190,   209,   230,   253,   279,
+    307,   337,   371,   408,   449,   494,   544,   598,   658,   724,   796,   876,   963,
+    1060,  1166,  1282,  1411,  1552,  1707,  1878,  2066,  2272,  2499,  2749,  3024,  3327,
+    3660,  4026,  4428,  4871,  5358,  5894,  6484,  7132,  7845,  8630,  9493,  10442, 11487,
+    12635, 13899, 15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767};
+
+static const int INDEX_ADJUSTMENTS[8] = {-1, -1, -1, -1, 2, 4, 6, 8};
+
+/**
+ * State shared by the encoder and the decoder, so that they make the same
+ * predictions
+ */
+struct State {
+    int predictor = 0;
+    int index = 0;
+
+    void update(int nibble) {
+        int step = STEPS[index];
+        int diff = step >> 3;
+        if (nibble & 4) {
+            diff += step;
+        }
+        if (nibble & 2) {
+            diff += step >> 1;
+        }
+        if (nibble & 1) {
+            diff += step >> 2;
+        }
+        predictor = qBound(-32768, nibble & 8 ? predictor - diff : predictor + diff, 32767);
+        index = qBound(0, index + INDEX_ADJUSTMENTS[nibble & 7], 88);
+    }
+};
+
+static int encodeSample(State* state, int sample) {
+    int step = STEPS[state->index];
+    int diff = sample - state->predictor;
+    int nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    for (int bit = 4; bit > 0; bit >>= 1) {
+        if (diff >= step) {
+            nibble |= bit;
+            diff -= step;
+        }
+        step >>= 1;
+    }
+    state->update(nibble);
+    return nibble;
+}
+
+static QByteArray encode(const QVector<qint16>& samples) {
+    QByteArray data;
+    State state;
+    if (!samples.isEmpty()) {
+        state.predictor = samples.first();
+    }
+    appendValue<qint16>(&data, qint16(state.predictor));
+    data.append(char(state.index));
+    data.append('\0');
+    for (int idx = 0; idx < samples.size(); idx += 2) {
+        int low = encodeSample(&state, samples.at(idx));
+        int high = idx + 1 < samples.size() ? encodeSample(&state, samples.at(idx + 1)) : 0;
+        data.append(char(low | (high << 4)));
+    }
+    return data;
+}
+
+static void decode(const uchar* data, qint64 sampleCount, qint16* out) {
+    State state;
+    state.predictor = readValue<qint16>(data);
+    state.index = qBound(0, int(data[2]), 88);
+    const uchar* ptr = data + ADPCM_HEADER_SIZE;
+    for (qint64 idx = 0; idx < sampleCount; ++idx) {
+        int nibble = idx % 2 == 0 ? (*ptr & 0xf) : (*ptr++ >> 4);
+        state.update(nibble);
+        out[idx] = qint16(state.predictor);
+    }
+}
+
+static qint64 dataSize(qint64 sampleCount) {
+    return ADPCM_HEADER_SIZE + (sampleCount + 1) / 2;
+}
+
+} // namespace ImaAdpcm
+
+SoundBank::SoundBank() {
+}
+
+SoundBank::~SoundBank() {
+    close();
+}
+
+Result SoundBank::open(const QString& path) {
+    close();
+    if (Q_BYTE_ORDER != Q_LITTLE_ENDIAN) {
+        // The samples are used in place
+        auto message = QCoreApplication::translate(
+            "SoundBank", "Sound banks are not supported on big-endian machines.");
+        return Result::createError(message);
+    }
+    mFile.setFileName(path);
+    if (!mFile.open(QIODevice::ReadOnly)) {
+        auto message = QCoreApplication::translate("SoundBank", "Cannot open %1: %2.")
+                           .arg(path, mFile.errorString());
+        return Result::createError(message);
+    }
+    qint64 fileSize = mFile.size();
+    if (fileSize < HEADER_SIZE) {
+        close();
+        return createInvalidError(path, QCoreApplication::translate("SoundBank", "too short"));
+    }
+    mData = mFile.map(0, fileSize);
+    if (!mData) {
+        auto message = QCoreApplication::translate("SoundBank", "Cannot map %1: %2.")
+                           .arg(path, mFile.errorString());
+        close();
+        return Result::createError(message);
+    }
+
+    if (memcmp(mData, MAGIC, MAGIC_SIZE) != 0) {
+        close();
+        return createInvalidError(path, QCoreApplication::translate("SoundBank", "wrong magic"));
+    }
+    int version = readValue<quint16>(mData + VERSION_OFFSET);
+    if (version != VERSION) {
+        close();
+        return createInvalidError(
+            path, QCoreApplication::translate("SoundBank", "unsupported version %1").arg(version));
+    }
+    int encoding = readValue<quint16>(mData + ENCODING_OFFSET);
+    quint32 bucketCount = readValue<quint32>(mData + BUCKET_COUNT_OFFSET);
+    mCount = int(readValue<quint32>(mData + COUNT_OFFSET));
+    Result result;
+    if (encoding != Pcm16 && encoding != ImaAdpcm) {
+        result = createInvalidError(
+            path, QCoreApplication::translate("SoundBank", "unknown encoding %1").arg(encoding));
+    } else if (readValue<quint64>(mData + FILE_SIZE_OFFSET) != quint64(fileSize)) {
+        result = createInvalidError(path,
+                                    QCoreApplication::translate("SoundBank", "truncated file"));
+    } else if (bucketCount == 0 || (bucketCount & (bucketCount - 1)) != 0 || mCount < 0
+               || quint64(mCount) >= bucketCount
+               || HEADER_SIZE + 4 * quint64(bucketCount) + ENTRY_SIZE * quint64(mCount)
+                      > quint64(fileSize)) {
+        result = createInvalidError(path,
+                                    QCoreApplication::translate("SoundBank", "invalid index"));
+    }
+    if (!result) {
+        close();
+        return result;
+    }
+
+    mEncoding = Encoding(encoding);
+    mSampleRate = int(readValue<quint32>(mData + SAMPLE_RATE_OFFSET));
+    mBucketMask = bucketCount - 1;
+    mBuckets = mData + HEADER_SIZE;
+    mEntries = mBuckets + 4 * bucketCount;
+
+    result = checkEntries(fileSize);
+    if (!result) {
+        close();
+        return createInvalidError(path, result.message());
+    }
+    return {};
+}
+
+Result SoundBank::checkEntries(qint64 fileSize) const {
+    for (int idx = 0; idx < mCount; ++idx) {
+        const uchar* ptr = entry(idx);
+        quint64 nameEnd = quint64(readValue<quint32>(ptr + NAME_OFFSET_OFFSET))
+                          + readValue<quint32>(ptr + NAME_SIZE_OFFSET);
+        quint64 dataOffset = readValue<quint64>(ptr + DATA_OFFSET_OFFSET);
+        quint64 dataSize = readValue<quint64>(ptr + DATA_SIZE_OFFSET);
+        quint64 sampleCount = readValue<quint32>(ptr + SAMPLE_COUNT_OFFSET);
+        quint64 expectedDataSize = mEncoding == Pcm16 ? 2 * sampleCount
+                                                      : ImaAdpcm::dataSize(qint64(sampleCount));
+        if (nameEnd > quint64(fileSize) || dataOffset % DATA_ALIGNMENT != 0
+            || dataSize != expectedDataSize || dataOffset > quint64(fileSize)
+            || dataSize > quint64(fileSize) - dataOffset) {
+            return Result::createError(
+                QCoreApplication::translate("SoundBank", "invalid entry %1").arg(idx));
+        }
+    }
+    return {};
+}
+
+void SoundBank::close() {
+    if (mData) {
+        mFile.unmap(const_cast<uchar*>(mData));
+        mData = nullptr;
+    }
+    mFile.close();
+    mCount = 0;
+    mBucketMask = 0;
+    mBuckets = nullptr;
+    mEntries = nullptr;
+}
+
+SoundBank::Encoding SoundBank::encoding() const {
+    return mEncoding;
+}
+
+int SoundBank::sampleRate() const {
+    return mSampleRate;
+}
+
+int SoundBank::count() const {
+    return mCount;
+}
+
+int SoundBank::indexOf(const QString& name) const {
+    auto utf8Name = name.toUtf8();
+    return indexOf(utf8Name.constData(), utf8Name.size());
+}
+
+int SoundBank::indexOf(const char* utf8Name, int size) const {
+    if (mCount == 0) {
+        return -1;
+    }
+    quint32 hash = hashName(utf8Name, size);
+    quint32 bucket = hash & mBucketMask;
+    for (quint32 probe = 0; probe <= mBucketMask; ++probe, bucket = (bucket + 1) & mBucketMask) {
+        quint32 value = readValue<quint32>(mBuckets + 4 * bucket);
+        if (value == 0 || value > quint32(mCount)) {
+            return -1;
+        }
+        int index = int(value - 1);
+        const uchar* ptr = entry(index);
+        if (readValue<quint32>(ptr + NAME_HASH_OFFSET) == hash
+            && readValue<quint32>(ptr + NAME_SIZE_OFFSET) == quint32(size)
+            && memcmp(mData + readValue<quint32>(ptr + NAME_OFFSET_OFFSET), utf8Name, size) == 0) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+QString SoundBank::name(int index) const {
+    const uchar* ptr = entry(index);
+    auto name = reinterpret_cast<const char*>(mData + readValue<quint32>(ptr + NAME_OFFSET_OFFSET));
+    return QString::fromUtf8(name, int(readValue<quint32>(ptr + NAME_SIZE_OFFSET)));
+}
+
+qint64 SoundBank::sampleCount(int index) const {
+    return readValue<quint32>(entry(index) + SAMPLE_COUNT_OFFSET);
+}
+
+SoundBank::Samples SoundBank::samples(int index) const {
+    Q_ASSERT(mEncoding == Pcm16);
+    const uchar* ptr = entry(index);
+    Samples samples;
+    samples.data =
+        reinterpret_cast<const qint16*>(mData + readValue<quint64>(ptr + DATA_OFFSET_OFFSET));
+    samples.size = readValue<quint32>(ptr + SAMPLE_COUNT_OFFSET);
+    return samples;
+}
+
+SoundBank::Samples SoundBank::samples(const QString& name) const {
+    int index = indexOf(name);
+    return index >= 0 ? samples(index) : Samples();
+}
+
+void SoundBank::decode(int index, qint16* out) const {
+    const uchar* ptr = entry(index);
+    const uchar* data = mData + readValue<quint64>(ptr + DATA_OFFSET_OFFSET);
+    qint64 count = readValue<quint32>(ptr + SAMPLE_COUNT_OFFSET);
+    if (count == 0) {
+        return;
+    }
+    if (mEncoding == Pcm16) {
+        memcpy(out, data, count * 2);
+    } else {
+        ImaAdpcm::decode(data, count, out);
+    }
+}
+
+quint32 SoundBank::hashName(const char* utf8Name, int size) {
+    quint32 hash = 2166136261u;
+    for (int idx = 0; idx < size; ++idx) {
+        hash = (hash ^ quint8(utf8Name[idx])) * 16777619u;
+    }
+    return hash;
+}
+
+const uchar* SoundBank::entry(int index) const {
+    Q_ASSERT(index >= 0 && index < mCount);
+    return mEntries + ENTRY_SIZE * index;
+}
+
+SoundBankWriter::SoundBankWriter(SoundBank::Encoding encoding, int sampleRate)
+        : mEncoding(encoding), mSampleRate(sampleRate) {
+}
+
+bool SoundBankWriter::addSound(const QString& name, const QVector<qint16>& samples) {
+    Entry entry;
+    entry.name = name.toUtf8();
+    if (mNames.contains(entry.name)) {
+        return false;
+    }
+    entry.sampleCount = samples.size();
+    if (mEncoding == SoundBank::Pcm16) {
+        entry.data.resize(samples.size() * 2);
+        for (int idx = 0; idx < samples.size(); ++idx) {
+            qToLittleEndian(samples.at(idx), entry.data.data() + 2 * idx);
+        }
+    } else {
+        entry.data = ImaAdpcm::encode(samples);
+    }
+    mNames.insert(entry.name);
+    mEntries << entry;
+    return true;
+}
+
+Result SoundBankWriter::write(const QString& path) const {
+    // Keep the table at most half full, so that probing sequences are short
+    int bucketCount = 2;
+    while (bucketCount < 2 * mEntries.size()) {
+        bucketCount *= 2;
+    }
+
+    QVector<quint32> buckets(bucketCount);
+    qint64 namesOffset = HEADER_SIZE + 4 * qint64(bucketCount) + ENTRY_SIZE * mEntries.size();
+    qint64 nameOffset = namesOffset;
+    for (int idx = 0; idx < mEntries.size(); ++idx) {
+        nameOffset += mEntries.at(idx).name.size();
+    }
+    qint64 dataOffset = alignUp(nameOffset, SoundBank::DATA_ALIGNMENT);
+
+    QByteArray index;
+    QByteArray names;
+    for (int idx = 0; idx < mEntries.size(); ++idx) {
+        const auto& entry = mEntries.at(idx);
+        quint32 hash = SoundBank::hashName(entry.name.constData(), entry.name.size());
+        int bucket = int(hash & quint32(bucketCount - 1));
+        while (buckets.at(bucket) != 0) {
+            bucket = (bucket + 1) & (bucketCount - 1);
+        }
+        buckets[bucket] = quint32(idx + 1);
+
+        appendValue<quint32>(&index, hash);
+        appendValue<quint32>(&index, quint32(namesOffset + names.size()));
+        appendValue<quint32>(&index, quint32(entry.name.size()));
+        appendValue<quint32>(&index, quint32(entry.sampleCount));
+        appendValue<quint64>(&index, quint64(dataOffset));
+        appendValue<quint64>(&index, quint64(entry.data.size()));
+        names.append(entry.name);
+        dataOffset = alignUp(dataOffset + entry.data.size(), SoundBank::DATA_ALIGNMENT);
+    }
+
+    QByteArray header;
+    header.append(MAGIC, MAGIC_SIZE);
+    appendValue<quint16>(&header, quint16(SoundBank::VERSION));
+    appendValue<quint16>(&header, quint16(mEncoding));
+    appendValue<quint32>(&header, quint32(mSampleRate));
+    appendValue<quint32>(&header, quint32(mEntries.size()));
+    appendValue<quint32>(&header, quint32(bucketCount));
+    appendValue<quint64>(&header, quint64(dataOffset));
+    for (quint32 value : buckets) {
+        appendValue<quint32>(&header, value);
+    }
+    header.append(index);
+    header.append(names);
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        auto message = QCoreApplication::translate("SoundBank", "Cannot open %1: %2.")
+                           .arg(path, file.errorString());
+        return Result::createError(message);
+    }
+    // Banks can be larger than a QByteArray, so write the sounds one by one
+    qint64 position = 0;
+    auto write = [&file, &position](const QByteArray& bytes) {
+        position += bytes.size();
+        return file.write(bytes) == bytes.size();
+    };
+    auto padTo = [&position, &write](qint64 offset) {
+        return write(QByteArray(int(offset - position), '\0'));
+    };
+    bool ok = write(header);
+    for (int idx = 0; ok && idx < mEntries.size(); ++idx) {
+        ok = padTo(alignUp(position, SoundBank::DATA_ALIGNMENT)) && write(mEntries.at(idx).data);
+    }
+    if (!ok || !padTo(dataOffset)) {
+        auto message = QCoreApplication::translate("SoundBank", "Cannot write %1: %2.")
+                           .arg(path, file.errorString());
+        return Result::createError(message);
+    }
+    return {};
+}
@@ -0,0 +1,137 @@
+#ifndef SOUNDBANK_H
+#define SOUNDBANK_H
+
+#include "Result.h"
+
+#include <QFile>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+/**
+ * A read-only bank of rendered sounds, packed in a single file.
+ *
+ * The file is mapped in memory: opening it does not read nor copy the
+ * samples, and looking up a sound by its UTF-8 name does not allocate. Samples are
+ * mono, stored either as 16-bit PCM, which can be used in place, or as
+ * IMA-ADPCM, which must be decoded with decode().
+ *
+ * File layout, all values little-endian:
+ *
+ * - header (32 bytes): magic "SFXRBANK", version (u16), encoding (u16),
+ *   sample rate (u32), entry count (u32), bucket count (u32), file size (u64)
+ * - name hash table: bucket count u32 values, each being 0 for an empty
+ *   bucket or an entry index + 1. Buckets are found with linear probing, the
+ *   bucket count is a power of two.
+ * - entries (32 bytes each): name hash (u32), name offset (u32), name size
+ *   (u32), sample count (u32), data offset (u64), data size (u64)
+ * - names, UTF-8
+ * - sample data of each entry, aligned to DATA_ALIGNMENT bytes
+ */
+class SoundBank {
+public:
+    enum Encoding {
+        Pcm16,
+        // 4 bits per sample. The data starts with the first sample (i16) and
+        // the initial step index (u8, followed by a padding byte), then each
+        // byte holds two samples, low nibble first.
+        ImaAdpcm,
+    };
+
+    /**
+     * Samples of a Pcm16 entry, pointing inside the mapped file
+     */
+    struct Samples {
+        const qint16* data = nullptr;
+        qint64 size = 0;
+    };
+
+    static constexpr int VERSION = 1;
+    static constexpr int DATA_ALIGNMENT = 16;
+
+    SoundBank();
+    ~SoundBank();
+    SoundBank(const SoundBank&) = delete;
+    SoundBank& operator=(const SoundBank&) = delete;
+
+    Result open(const QString& path);
+    void close();
+
+    Encoding encoding() const;
+    int sampleRate() const;
+    int count() const;
+
+    /**
+     * Returns the index of the sound called `name`, or -1 if there is none
+     */
+    int indexOf(const QString& name) const;
+    int indexOf(const char* utf8Name, int size) const;
+
+    QString name(int index) const;
+    qint64 sampleCount(int index) const;
+
+    /**
+     * Returns the samples of entry `index`, without copying them. Only valid
+     * for Pcm16 banks, and as long as the bank is open.
+     */
+    Samples samples(int index) const;
+
+    /**
+     * Returns the samples of entry `index` by name, or empty Samples if there
+     * is no such entry
+     */
+    Samples samples(const QString& name) const;
+
+    /**
+     * Writes the sampleCount(index) samples of entry `index` to `out`,
+     * decoding them if needed
+     */
+    void decode(int index, qint16* out) const;
+
+    /**
+     * Hash function used for the name index: 32-bit FNV-1a
+     */
+    static quint32 hashName(const char* utf8Name, int size);
+
+private:
+    QFile mFile;
+    const uchar* mData = nullptr;
+    Encoding mEncoding = Pcm16;
+    int mSampleRate = 0;
+    int mCount = 0;
+    quint32 mBucketMask = 0;
+    const uchar* mBuckets = nullptr;
+    const uchar* mEntries = nullptr;
+
+    Result checkEntries(qint64 fileSize) const;
+    const uchar* entry(int index) const;
+};
+
+/**
+ * Creates SoundBank files
+ */
+class SoundBankWriter {
+public:
+    SoundBankWriter(SoundBank::Encoding encoding, int sampleRate);
+
+    /**
+     * Adds a sound. Returns false if there is already a sound with this name.
+     */
+    bool addSound(const QString& name, const QVector<qint16>& samples);
+
+    Result write(const QString& path) const;
+
+private:
+    struct Entry {
+        QByteArray name;
+        qint64 sampleCount;
+        QByteArray data;
+    };
+
+    const SoundBank::Encoding mEncoding;
+    const int mSampleRate;
+    QVector<Entry> mEntries;
+    QSet<QByteArray> mNames;
+};
+
+#endif // SOUNDBANK_H
@@ -0,0 +1,125 @@
+#include "SoundFeatures.h"
+
+#include "BufferStrategy.h"
+#include "SoundParams.h"
+#include "Spectrum.h"
+#include "Synthesizer.h"
+
+#include <cmath>
+
+using Magnitudes = std::array<qreal, Spectrum::BIN_COUNT>;
+
+static constexpr qreal ROLLOFF_RATIO = 0.85;
+
+// Slices quieter than this have no pitch
+static constexpr qreal SILENCE_RMS = 0.001;
+
+// Lowest bin considered for the pitch: lower frequencies are mostly the DC
+// offset of asymmetric wave forms
+static constexpr int MIN_PITCH_BIN = 2;
+
+static qreal frequency(qreal bin) {
+    return Spectrum::binFrequency(bin, Synthesizer::SAMPLE_RATE);
+}
+
+static void computeSpectralFeatures(const QVector<qreal>& samples, SoundFeatures* features) {
+    // Sum the spectra of all the frames: loud frames weigh more than quiet
+    // ones
+    Magnitudes magnitudes;
+    Magnitudes sums{};
+    for (int start = 0; start < samples.size(); start += Spectrum::FRAME_SIZE) {
+        int count = qMin(Spectrum::FRAME_SIZE, samples.size() - start);
+        Spectrum::computeMagnitudes(samples.constData() + start, count, magnitudes.data());
+        for (int bin = 0; bin < Spectrum::BIN_COUNT; ++bin) {
+            sums[bin] += magnitudes[bin];
+        }
+    }
+
+    qreal weightedSum = 0;
+    qreal sum = 0;
+    for (int bin = 0; bin < Spectrum::BIN_COUNT; ++bin) {
+        weightedSum += sums[bin] * frequency(bin);
+        sum += sums[bin];
+    }
+    if (sum == 0) {
+        return;
+    }
+    features->spectralCentroid = weightedSum / sum;
+
+    qreal rolloffSum = 0;
+    for (int bin = 0; bin < Spectrum::BIN_COUNT; ++bin) {
+        rolloffSum += sums[bin];
+        if (rolloffSum >= sum * ROLLOFF_RATIO) {
+            features->spectralRolloff = frequency(bin);
+            break;
+        }
+    }
+}
+
+/**
+ * Returns the strongest frequency of the frame centered on `center`
+ */
+static qreal computePitch(const QVector<qreal>& samples, int center) {
+    int start = qBound(0, center - Spectrum::FRAME_SIZE / 2, samples.size());
+    int count = qMin(Spectrum::FRAME_SIZE, samples.size() - start);
+    Magnitudes magnitudes;
+    Spectrum::computeMagnitudes(samples.constData() + start, count, magnitudes.data());
+    int peakBin = MIN_PITCH_BIN;
+    for (int bin = MIN_PITCH_BIN + 1; bin < Spectrum::BIN_COUNT - 1; ++bin) {
+        if (magnitudes[bin] > magnitudes[peakBin]) {
+            peakBin = bin;
+        }
+    }
+    // Refine the peak position with a parabola through the peak bin and its
+    // neighbours
+    qreal left = magnitudes[peakBin - 1];
+    qreal middle = magnitudes[peakBin];
+    qreal right = magnitudes[peakBin + 1];
+    qreal denominator = left - 2 * middle + right;
+    qreal offset = denominator < 0 ? 0.5 * (left - right) / denominator : 0;
+    return frequency(peakBin + offset);
+}
+
+static void computeSliceFeatures(const QVector<qreal>& samples, SoundFeatures* features) {
+    int size = samples.size();
+    for (int slice = 0; slice < SoundFeatures::SLICE_COUNT; ++slice) {
+        int start = int(qint64(size) * slice / SoundFeatures::SLICE_COUNT);
+        int end = int(qint64(size) * (slice + 1) / SoundFeatures::SLICE_COUNT);
+        qreal peak = 0;
+        qreal squareSum = 0;
+        for (int idx = start; idx < end; ++idx) {
+            peak = qMax(peak, std::abs(samples.at(idx)));
+            squareSum += samples.at(idx) * samples.at(idx);
+        }
+        qreal rms = end > start ? std::sqrt(squareSum / (end - start)) : 0;
+        features->peakEnvelope[slice] = peak;
+        features->rmsEnvelope[slice] = rms;
+        features->pitchTrajectory[slice] =
+            rms > SILENCE_RMS ? computePitch(samples, (start + end) / 2) : 0;
+    }
+}
+
+SoundFeatures SoundFeatures::fromSamples(const QVector<qreal>& samples) {
+    SoundFeatures features;
+    if (samples.isEmpty()) {
+        return features;
+    }
+    features.duration = qreal(samples.size()) / Synthesizer::SAMPLE_RATE;
+    qreal squareSum = 0;
+    for (qreal sample : samples) {
+        qreal value = std::abs(sample);
+        features.peak = qMax(features.peak, value);
+        if (value > 1) {
+            ++features.clippedCount;
+        }
+        squareSum += sample * sample;
+    }
+    features.rms = std::sqrt(squareSum / samples.size());
+    computeSpectralFeatures(samples, &features);
+    computeSliceFeatures(samples, &features);
+    return features;
+}
+
+SoundFeatures SoundFeatures::fromParams(const SoundParams& params) {
+    return fromSamples(renderSamples<RawBufferStrategy>(params));
+}
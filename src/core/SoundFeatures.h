@@ -0,0 +1,60 @@
+#ifndef SOUNDFEATURES_H
+#define SOUNDFEATURES_H
+
+#include <QVector>
+
+#include <array>
+
+struct SoundParams;
+
+/**
+ * Measures of a synthesized sound, used to pick sounds matching some
+ * constraints, or to find similar sounds
+ */
+struct SoundFeatures {
+    /**
+     * Number of slices the sound is split in, for the features which change
+     * over time
+     */
+    static constexpr int SLICE_COUNT = 16;
+
+    using Envelope = std::array<qreal, SLICE_COUNT>;
+
+    /** In seconds */
+    qreal duration = 0;
+    /** Highest absolute value of the samples, before clamping */
+    qreal peak = 0;
+    qreal rms = 0;
+    /** Number of samples outside of [-1, 1], which are clamped on export */
+    int clippedCount = 0;
+    /** In Hz, 0 for a silent sound */
+    qreal spectralCentroid = 0;
+    /**
+     * Frequency in Hz below which 85% of the spectrum is, 0 for a silent
+     * sound
+     */
+    qreal spectralRolloff = 0;
+
+    /** RMS of each slice */
+    Envelope rmsEnvelope{};
+    /** Highest absolute value of each slice */
+    Envelope peakEnvelope{};
+    /**
+     * Strongest frequency in Hz of each slice, 0 for silent slices. For the
+     * wave forms of sfxr, this is usually the pitch of the sound.
+     */
+    Envelope pitchTrajectory{};
+
+    /**
+     * Computes the features of `samples`, synthesized at
+     * Synthesizer::SAMPLE_RATE
+     */
+    static SoundFeatures fromSamples(const QVector<qreal>& samples);
+
+    /**
+     * Synthesizes the sound of `params` and computes its features
+     */
+    static SoundFeatures fromParams(const SoundParams& params);
+};
+
+#endif // SOUNDFEATURES_H
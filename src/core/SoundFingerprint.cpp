@@ -0,0 +1,145 @@
+#include "SoundFingerprint.h"
+
+#include "BufferStrategy.h"
+#include "Random.h"
+#include "SoundParams.h"
+#include "Spectrum.h"
+#include "Synthesizer.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+static constexpr int LEVEL_COUNT = SoundFingerprint::SLICE_COUNT * SoundFingerprint::BAND_COUNT;
+
+using BandEnergies = std::array<qreal, SoundFingerprint::BAND_COUNT>;
+using Levels = std::array<qreal, LEVEL_COUNT>;
+using Hyperplane = std::array<float, LEVEL_COUNT>;
+
+// Frequency range covered by the bands, in Hz
+static constexpr qreal MIN_FREQUENCY = 200;
+static constexpr qreal MAX_FREQUENCY = 16000;
+
+// Levels more than this many dB below the loudest one are raised to it: the
+// differences between very quiet parts of sounds cannot be heard
+static constexpr qreal DYNAMIC_RANGE = 40;
+
+// Avoids computing the logarithm of 0
+static constexpr qreal MIN_ENERGY = 1e-12;
+
+// Fixed, so that fingerprints can be compared across runs
+static constexpr quint64 HYPERPLANE_SEED = 0x9e3779b9;
+
+static const qreal PI = 3.14159265358979323846;
+
+/**
+ * Returns random hyperplanes, one per bit, with normally distributed
+ * components, so that their directions are uniformly distributed
+ */
+static std::vector<Hyperplane> computeHyperplanes() {
+    Random random(HYPERPLANE_SEED);
+    std::vector<Hyperplane> hyperplanes(SoundFingerprint::BIT_COUNT);
+    for (auto& hyperplane : hyperplanes) {
+        for (auto& component : hyperplane) {
+            // Box-Muller transform
+            qreal radius = std::sqrt(-2 * std::log(1 - random.real(1)));
+            component = float(radius * std::cos(2 * PI * random.real(1)));
+        }
+    }
+    return hyperplanes;
+}
+
+/**
+ * Returns the mean energy of each band over the frames from `start` to `end`
+ */
+static BandEnergies
+computeBandEnergies(const QVector<qreal>& samples, int start, int end, qreal* magnitudes) {
+    static const auto edges = Spectrum::logBandEdges(
+        MIN_FREQUENCY, MAX_FREQUENCY, SoundFingerprint::BAND_COUNT, Synthesizer::SAMPLE_RATE);
+    BandEnergies energies{};
+    int frameCount = 0;
+    // Slices shorter than a frame still get one
+    int frameStart = start;
+    do {
+        int count = qMin(Spectrum::FRAME_SIZE, samples.size() - frameStart);
+        Spectrum::computeMagnitudes(samples.constData() + frameStart, count, magnitudes);
+        for (int band = 0; band < SoundFingerprint::BAND_COUNT; ++band) {
+            for (int bin = edges[band]; bin < edges[band + 1]; ++bin) {
+                energies[band] += magnitudes[bin] * magnitudes[bin];
+            }
+        }
+        ++frameCount;
+        frameStart += Spectrum::FRAME_SIZE;
+    } while (frameStart < end);
+    for (auto& energy : energies) {
+        energy /= frameCount;
+    }
+    return energies;
+}
+
+/**
+ * Returns the level in dB of each band of each slice, relative to the mean
+ * level, so that the volume of the sound does not change them
+ */
+static Levels computeLevels(const QVector<qreal>& samples) {
+    std::array<qreal, Spectrum::BIN_COUNT> magnitudes;
+    Levels levels;
+    int size = samples.size();
+    for (int slice = 0; slice < SoundFingerprint::SLICE_COUNT; ++slice) {
+        int start = int(qint64(size) * slice / SoundFingerprint::SLICE_COUNT);
+        int end = int(qint64(size) * (slice + 1) / SoundFingerprint::SLICE_COUNT);
+        auto energies = computeBandEnergies(samples, start, end, magnitudes.data());
+        for (int band = 0; band < SoundFingerprint::BAND_COUNT; ++band) {
+            levels[slice * SoundFingerprint::BAND_COUNT + band] =
+                10 * std::log10(energies[band] + MIN_ENERGY);
+        }
+    }
+
+    qreal minLevel = *std::max_element(levels.begin(), levels.end()) - DYNAMIC_RANGE;
+    qreal sum = 0;
+    for (auto& level : levels) {
+        level = qMax(level, minLevel);
+        sum += level;
+    }
+    qreal mean = sum / LEVEL_COUNT;
+    for (auto& level : levels) {
+        level -= mean;
+    }
+    return levels;
+}
+
+int SoundFingerprint::distance(const SoundFingerprint& other) const {
+    int count = 0;
+    for (size_t idx = 0; idx < bits.size(); ++idx) {
+        count += int(qPopulationCount(bits[idx] ^ other.bits[idx]));
+    }
+    return count;
+}
+
+SoundFingerprint SoundFingerprint::fromSamples(const QVector<qreal>& samples) {
+    static const auto hyperplanes = computeHyperplanes();
+    SoundFingerprint fingerprint;
+    if (samples.isEmpty()) {
+        return fingerprint;
+    }
+    fingerprint.duration = qreal(samples.size()) / Synthesizer::SAMPLE_RATE;
+
+    auto levels = computeLevels(samples);
+    for (int bit = 0; bit < BIT_COUNT; ++bit) {
+        const auto& hyperplane = hyperplanes[bit];
+        qreal dot = 0;
+        for (int idx = 0; idx < LEVEL_COUNT; ++idx) {
+            dot += hyperplane[idx] * levels[idx];
+        }
+        if (dot > 0) {
+            fingerprint.bits[bit / 64] |= quint64(1) << (bit % 64);
+        }
+    }
+    return fingerprint;
+}
+
+SoundFingerprint SoundFingerprint::fromParams(const SoundParams& params) {
+    return fromSamples(renderSamples(params));
+}
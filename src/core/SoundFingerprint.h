@@ -0,0 +1,51 @@
+#ifndef SOUNDFINGERPRINT_H
+#define SOUNDFINGERPRINT_H
+
+#include <QVector>
+
+#include <array>
+
+struct SoundParams;
+
+/**
+ * A compact description of how a sound sounds, to detect near-duplicates.
+ *
+ * The sound is split in SLICE_COUNT slices, and the spectrum of each slice in
+ * BAND_COUNT logarithmic frequency bands. The levels of the bands, in dB,
+ * form the spectral envelope of the sound. This envelope is binarized by
+ * random projections: each bit tells on which side of a random hyperplane the
+ * envelope is. The number of bits which differ between two fingerprints is
+ * then proportional to the angle between the two envelopes, so sounds which
+ * sound almost the same differ by a few bits, whatever their volume.
+ */
+struct SoundFingerprint {
+    static constexpr int SLICE_COUNT = 16;
+    static constexpr int BAND_COUNT = 32;
+    static constexpr int BIT_COUNT = 256;
+
+    std::array<quint64, BIT_COUNT / 64> bits{};
+    /** In seconds */
+    qreal duration = 0;
+
+    bool bit(int index) const {
+        return (bits[index / 64] >> (index % 64)) & 1;
+    }
+
+    /**
+     * Returns the number of bits which differ between the two fingerprints
+     */
+    int distance(const SoundFingerprint& other) const;
+
+    /**
+     * Computes the fingerprint of `samples`, synthesized at
+     * Synthesizer::SAMPLE_RATE
+     */
+    static SoundFingerprint fromSamples(const QVector<qreal>& samples);
+
+    /**
+     * Synthesizes the sound of `params` and computes its fingerprint
+     */
+    static SoundFingerprint fromParams(const SoundParams& params);
+};
+
+#endif // SOUNDFINGERPRINT_H
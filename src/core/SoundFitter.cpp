@@ -0,0 +1,338 @@
+#include "SoundFitter.h"
+
+#include "BufferStrategy.h"
+#include "Parallel.h"
+#include "Random.h"
+#include "SoundUtils.h"
+#include "Spectrum.h"
+#include "Synthesizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace SoundFitter {
+
+// Frequency range covered by the bands, in Hz
+static constexpr qreal MIN_FREQUENCY = 100;
+static constexpr qreal MAX_FREQUENCY = 16000;
+
+// Level of silent bands, in dB. Quieter bands are raised to it, so that
+// differences which cannot be heard do not count.
+static constexpr qreal SILENCE_LEVEL = -60;
+
+// Magnitude of a full scale sine wave, once windowed: it gets a level of 0 dB
+static constexpr qreal FULL_SCALE_MAGNITUDE = Spectrum::FRAME_SIZE / 4;
+
+// The first gene is the wave form, the others are the real fields
+static constexpr int GENE_COUNT = 1 + SoundParams::REAL_FIELD_COUNT;
+
+// Differential evolution settings. The weight is drawn between
+// MIN_DIFFERENTIAL_WEIGHT and 1 for each generation ("dither"), which avoids
+// tuning it for each target.
+static constexpr qreal MIN_DIFFERENTIAL_WEIGHT = 0.5;
+static constexpr qreal CROSSOVER_RATE = 0.9;
+// Trials move toward one of the best candidates, picked among this fraction of
+// the population
+static constexpr qreal BEST_FRACTION = 0.1;
+
+static constexpr int MIN_POPULATION_SIZE = 4;
+
+using Genes = std::array<qreal, GENE_COUNT>;
+
+struct Candidate {
+    Genes genes;
+    qreal distance = 0;
+};
+
+struct GeneRange {
+    qreal min;
+    qreal max;
+};
+
+/**
+ * Returns the range of each gene. Fields which can go both ways, like the
+ * slides and sweeps, go from -1 to 1, the others from 0 to 1.
+ */
+static std::array<GeneRange, GENE_COUNT> computeGeneRanges() {
+    static const char* const BIPOLAR_FIELDS[] = {
+        "slide",
+        "deltaSlide",
+        "changeAmount",
+        "dutySweep",
+        "phaserOffset",
+        "phaserSweep",
+        "lpFilterCutoffSweep",
+        "hpFilterCutoffSweep",
+    };
+    std::array<GeneRange, GENE_COUNT> ranges;
+    ranges[0] = {0, qreal(WaveForm::Triangle + 1)};
+    const auto& fields = SoundParams::realFields();
+    for (int idx = 0; idx < SoundParams::REAL_FIELD_COUNT; ++idx) {
+        bool bipolar = std::any_of(
+            std::begin(BIPOLAR_FIELDS), std::end(BIPOLAR_FIELDS), [&fields, idx](const char* name) {
+                return std::strcmp(name, fields[idx].name) == 0;
+            });
+        ranges[idx + 1] = {bipolar ? qreal(-1) : qreal(0), 1};
+    }
+    return ranges;
+}
+
+static const std::array<GeneRange, GENE_COUNT>& geneRanges() {
+    static const auto ranges = computeGeneRanges();
+    return ranges;
+}
+
+static SoundParams paramsFromGenes(const Genes& genes) {
+    SoundParams params;
+    int waveForm = qMin(int(genes[0]), int(WaveForm::Triangle));
+    params.waveForm = static_cast<WaveForm::Enum>(waveForm);
+    const auto& fields = SoundParams::realFields();
+    for (int idx = 0; idx < SoundParams::REAL_FIELD_COUNT; ++idx) {
+        params.*fields[idx].member = genes[idx + 1];
+    }
+    return params;
+}
+
+static Genes genesFromParams(const SoundParams& params) {
+    const auto& ranges = geneRanges();
+    Genes genes;
+    // Center the gene in the range of the wave form
+    genes[0] = params.waveForm + 0.5;
+    const auto& fields = SoundParams::realFields();
+    for (int idx = 0; idx < SoundParams::REAL_FIELD_COUNT; ++idx) {
+        const auto& range = ranges[idx + 1];
+        genes[idx + 1] = qBound(range.min, params.*fields[idx].member, range.max);
+    }
+    return genes;
+}
+
+static Genes randomGenes(Random* random) {
+    Genes genes;
+    const auto& ranges = geneRanges();
+    for (int idx = 0; idx < GENE_COUNT; ++idx) {
+        const auto& range = ranges[idx];
+        genes[idx] = range.min + random->real(range.max - range.min);
+    }
+    return genes;
+}
+
+Spectrogram Spectrogram::fromSamples(const QVector<qreal>& samples) {
+    static const auto edges = Spectrum::logBandEdges(
+        MIN_FREQUENCY, MAX_FREQUENCY, BAND_COUNT, Synthesizer::SAMPLE_RATE);
+    static const qreal minEnergy = FULL_SCALE_MAGNITUDE * FULL_SCALE_MAGNITUDE
+                                   * std::pow(10., SILENCE_LEVEL / 10);
+    Spectrogram spectrogram;
+    int frameCount = (samples.size() + Spectrum::FRAME_SIZE - 1) / Spectrum::FRAME_SIZE;
+    spectrogram.mLevels.resize(frameCount * BAND_COUNT);
+    std::array<qreal, Spectrum::BIN_COUNT> magnitudes;
+    for (int frame = 0; frame < frameCount; ++frame) {
+        int start = frame * Spectrum::FRAME_SIZE;
+        int count = qMin(Spectrum::FRAME_SIZE, samples.size() - start);
+        Spectrum::computeMagnitudes(samples.constData() + start, count, magnitudes.data());
+        for (int band = 0; band < BAND_COUNT; ++band) {
+            qreal energy = 0;
+            for (int bin = edges[band]; bin < edges[band + 1]; ++bin) {
+                energy += magnitudes[bin] * magnitudes[bin];
+            }
+            energy = qMax(energy, minEnergy);
+            spectrogram.mLevels[frame * BAND_COUNT + band] = float(
+                10 * std::log10(energy / (FULL_SCALE_MAGNITUDE * FULL_SCALE_MAGNITUDE)));
+        }
+    }
+    return spectrogram;
+}
+
+int Spectrogram::frameCount() const {
+    return mLevels.size() / BAND_COUNT;
+}
+
+qreal Spectrogram::distance(const Spectrogram& other) const {
+    const auto& shortest = mLevels.size() <= other.mLevels.size() ? mLevels : other.mLevels;
+    const auto& longest = mLevels.size() <= other.mLevels.size() ? other.mLevels : mLevels;
+    if (longest.isEmpty()) {
+        return 0;
+    }
+    qreal sum = 0;
+    for (int idx = 0; idx < shortest.size(); ++idx) {
+        qreal difference = shortest.at(idx) - longest.at(idx);
+        sum += difference * difference;
+    }
+    for (int idx = shortest.size(); idx < longest.size(); ++idx) {
+        qreal difference = SILENCE_LEVEL - longest.at(idx);
+        sum += difference * difference;
+    }
+    return std::sqrt(sum / longest.size());
+}
+
+/**
+ * Returns the initial population: half of it comes from the generators, to
+ * start from sounds which make sense, the other half is uniformly random, to
+ * cover the whole parameter space
+ */
+static std::vector<Candidate> createPopulation(int size, Random* random) {
+    std::vector<Candidate> population(static_cast<size_t>(size));
+    for (int idx = 0; idx < size; ++idx) {
+        if (idx % 2 == 1) {
+            population[idx].genes = randomGenes(random);
+            continue;
+        }
+        SoundParams params;
+        switch (idx / 2 % 8) {
+        case 0:
+            params = SoundUtils::generatePickup(random);
+            break;
+        case 1:
+            params = SoundUtils::generateLaser(random);
+            break;
+        case 2:
+            params = SoundUtils::generateExplosion(random);
+            break;
+        case 3:
+            params = SoundUtils::generatePowerup(random);
+            break;
+        case 4:
+            params = SoundUtils::generateHitHurt(random);
+            break;
+        case 5:
+            params = SoundUtils::generateJump(random);
+            break;
+        case 6:
+            params = SoundUtils::generateBlipSelect(random);
+            break;
+        default:
+            params = SoundUtils::randomize(
+                static_cast<WaveForm::Enum>(random->range(WaveForm::Triangle)), random);
+            break;
+        }
+        population[idx].genes = genesFromParams(params);
+    }
+    return population;
+}
+
+/**
+ * Returns the indexes of the population, from the best candidate to the worst
+ */
+static std::vector<int> rankPopulation(const std::vector<Candidate>& population) {
+    std::vector<int> ranking(population.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::stable_sort(ranking.begin(), ranking.end(), [&population](int index1, int index2) {
+        return population[index1].distance < population[index2].distance;
+    });
+    return ranking;
+}
+
+/**
+ * Returns a trial candidate for `target`, using the DE/current-to-pbest/1/bin
+ * strategy: `target` moves toward one of the best candidates, plus the
+ * difference between two random members, both scaled by `weight`. The result
+ * is crossed with `target`.
+ */
+static Genes createTrial(const std::vector<Candidate>& population,
+                         const std::vector<int>& ranking,
+                         int target,
+                         qreal weight,
+                         Random* random) {
+    int size = int(population.size());
+    int bestCount = qMax(1, int(size * BEST_FRACTION));
+    int best = ranking[random->range(bestCount - 1)];
+    int picks[2];
+    for (int pick = 0; pick < 2; ++pick) {
+        bool unique;
+        do {
+            picks[pick] = random->range(size - 1);
+            unique = picks[pick] != target && (pick == 0 || picks[pick] != picks[0]);
+        } while (!unique);
+    }
+    const auto& targetGenes = population[target].genes;
+    const auto& bestGenes = population[best].genes;
+    const auto& genes1 = population[picks[0]].genes;
+    const auto& genes2 = population[picks[1]].genes;
+    const auto& ranges = geneRanges();
+
+    // At least one gene comes from the mutant
+    int forcedGene = random->range(GENE_COUNT - 1);
+    Genes trial;
+    for (int idx = 0; idx < GENE_COUNT; ++idx) {
+        auto current = targetGenes[idx];
+        if (idx != forcedGene && random->real(1) >= CROSSOVER_RATE) {
+            trial[idx] = current;
+            continue;
+        }
+        qreal value =
+            current + weight * (bestGenes[idx] - current) + weight * (genes1[idx] - genes2[idx]);
+        // Out of range values go between the current value and the bound they
+        // crossed, which keeps more diversity than clamping them
+        const auto& range = ranges[idx];
+        if (value < range.min) {
+            value = range.min + random->real(1) * (current - range.min);
+        } else if (value >= range.max) {
+            value = range.max - random->real(1) * (range.max - current);
+        }
+        trial[idx] = qBound(range.min, value, range.max);
+    }
+    return trial;
+}
+
+Fit fit(const QVector<qreal>& target, const Options& options) {
+    auto targetSpectrogram = Spectrogram::fromSamples(target);
+    // Candidates longer than the target are cut a bit after its end: this is
+    // enough to penalize them, without synthesizing all of their samples
+    int maxSampleCount = target.size() + target.size() / 4 + Spectrum::FRAME_SIZE;
+    auto evaluate = [&targetSpectrogram, maxSampleCount](Candidate* candidate) {
+        auto samples = renderSamples(paramsFromGenes(candidate->genes), maxSampleCount);
+        candidate->distance = Spectrogram::fromSamples(samples).distance(targetSpectrogram);
+    };
+
+    Random random(options.seed);
+    int populationSize = qMax(options.populationSize, MIN_POPULATION_SIZE);
+    int maxEvaluations = qMax(options.maxEvaluations, populationSize);
+    auto population = createPopulation(populationSize, &random);
+    auto* populationData = population.data();
+    Parallel::forEachIndex(populationSize, options.jobs, [populationData, &evaluate](int index) {
+        evaluate(populationData + index);
+    });
+    int evaluationCount = populationSize;
+
+    std::vector<Candidate> trials(population.size());
+    auto* trialsData = trials.data();
+    while (evaluationCount < maxEvaluations) {
+        auto ranking = rankPopulation(population);
+        if (options.progress) {
+            options.progress(evaluationCount, population[ranking.front()].distance);
+        }
+        int trialCount = qMin(populationSize, maxEvaluations - evaluationCount);
+        qreal weight = MIN_DIFFERENTIAL_WEIGHT + random.real(1 - MIN_DIFFERENTIAL_WEIGHT);
+        // Create the trials on this thread, so that the result does not depend
+        // on the number of jobs
+        for (int idx = 0; idx < trialCount; ++idx) {
+            trials[idx].genes = createTrial(population, ranking, idx, weight, &random);
+        }
+        Parallel::forEachIndex(trialCount, options.jobs, [trialsData, &evaluate](int index) {
+            evaluate(trialsData + index);
+        });
+        evaluationCount += trialCount;
+        for (int idx = 0; idx < trialCount; ++idx) {
+            // Accepting equal distances lets the population drift across flat
+            // areas, like the parameters of an inactive effect
+            if (trials[idx].distance <= population[idx].distance) {
+                population[idx] = trials[idx];
+            }
+        }
+    }
+
+    Fit result;
+    result.params = paramsFromGenes(population[rankPopulation(population).front()].genes);
+    auto samples = renderSamples(result.params);
+    result.distance = Spectrogram::fromSamples(samples).distance(targetSpectrogram);
+    result.evaluationCount = evaluationCount;
+    if (options.progress) {
+        options.progress(evaluationCount, result.distance);
+    }
+    return result;
+}
+
+} // namespace SoundFitter
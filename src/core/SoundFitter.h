@@ -0,0 +1,78 @@
+#ifndef SOUNDFITTER_H
+#define SOUNDFITTER_H
+
+#include "SoundParams.h"
+
+#include <QVector>
+
+#include <functional>
+
+/**
+ * Searches the synthesis parameters whose sound is the closest to a target
+ * sound, for example to recreate a legacy wav file as an editable sound.
+ *
+ * Sounds are compared by their spectrograms: the level of logarithmic
+ * frequency bands over time, in dB. The search uses differential evolution:
+ * a population of candidate parameters evolves by combining its members, and
+ * each generation of candidates is synthesized and compared on several
+ * threads. Candidates are only synthesized up to a bit after the end of the
+ * target, so very long candidates do not slow the search down.
+ *
+ * The result only depends on the target, the seed and the number of
+ * evaluations, not on the number of threads.
+ */
+namespace SoundFitter {
+
+static constexpr int DEFAULT_MAX_EVALUATIONS = 20000;
+
+/**
+ * The level of BAND_COUNT frequency bands, for each frame of
+ * Spectrum::FRAME_SIZE samples
+ */
+class Spectrogram {
+public:
+    static constexpr int BAND_COUNT = 32;
+
+    static Spectrogram fromSamples(const QVector<qreal>& samples);
+
+    int frameCount() const;
+
+    /**
+     * Returns the root mean square difference between the levels of the two
+     * spectrograms, in dB. Frames missing from the shortest one count as
+     * silent frames.
+     */
+    qreal distance(const Spectrogram& other) const;
+
+private:
+    QVector<float> mLevels;
+};
+
+struct Options {
+    int maxEvaluations = DEFAULT_MAX_EVALUATIONS;
+    int populationSize = 48;
+    quint64 seed = 0;
+    int jobs = 1;
+    /**
+     * Called after each generation with the number of evaluations so far and
+     * the distance of the best candidate. Can be null.
+     */
+    std::function<void(int evaluationCount, qreal distance)> progress;
+};
+
+struct Fit {
+    SoundParams params;
+    /** Distance between the spectrograms of the fitted sound and the target */
+    qreal distance = 0;
+    int evaluationCount = 0;
+};
+
+/**
+ * Returns the parameters of the sound closest to `target`, synthesized at
+ * Synthesizer::SAMPLE_RATE
+ */
+Fit fit(const QVector<qreal>& target, const Options& options);
+
+} // namespace SoundFitter
+
+#endif // SOUNDFITTER_H
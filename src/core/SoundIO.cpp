@@ -2,6 +2,8 @@
 
 #include "Result.h"
 #include "Sound.h"
+#include "SoundParams.h"
+#include "SoundParamsParser.h"
 
 #include <QCoreApplication>
 #include <QDebug>
@@ -9,15 +11,27 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMetaEnum>
 #include <QMetaProperty>
 #include <QUrl>
 #include <QtEndian>
 
 namespace SoundIO {
 
-static constexpr int MAX_SUPPORTED_VERSION = 1;
+static constexpr int MAX_SUPPORTED_VERSION = SoundParamsParser::MAX_SFXJ_VERSION;
 
 Result load(Sound* sound, const QUrl& url) {
+    auto params = SoundParams::fromSound(sound);
+    auto result = load(&params, url);
+    if (!result) {
+        return result;
+    }
+    params.applyTo(sound);
+    sound->setUrl(url);
+    return {};
+}
+
+Result load(SoundParams* params, const QUrl& url) {
     QString path = url.path();
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -28,89 +42,41 @@ Result load(Sound* sound, const QUrl& url) {
     }
     QString ext = path.section(".", -1);
     if (ext == "sfxr") {
-        auto result = loadSfxr(sound, &file);
-        if (!result) {
-            return result;
-        }
+        return loadSfxr(params, file.readAll());
     } else if (ext == "sfxj") {
-        auto result = loadSfxj(sound, &file);
-        if (!result) {
-            return result;
-        }
-    } else {
-        auto message =
-            QCoreApplication::translate("SoundIO", "Cannot load file with extension \"%1\".")
-                .arg(ext);
-        return Result::createError(message);
+        return loadSfxj(params, file.readAll());
     }
-    sound->setUrl(url);
-    return {};
+    auto message =
+        QCoreApplication::translate("SoundIO", "Cannot load file with extension \"%1\".").arg(ext);
+    return Result::createError(message);
 }
 
 Result loadSfxr(Sound* sound, QIODevice* device) {
-    auto readQReal = [device] {
-        float value;
-        device->read(reinterpret_cast<char*>(&value), sizeof(float));
-        value = qFromLittleEndian(value);
-        return qreal(value);
-    };
-    auto readInt32 = [device] {
-        qint32 value;
-        device->read(reinterpret_cast<char*>(&value), sizeof(qint32));
-        value = qFromLittleEndian(value);
-        return value;
-    };
+    auto params = SoundParams::fromSound(sound);
+    auto result = loadSfxr(&params, device->readAll());
+    if (!result) {
+        return result;
+    }
+    params.applyTo(sound);
+    return {};
+}
 
-    int version = readInt32();
-    if (version != 100 && version != 101 && version != 102) {
+Result loadSfxr(SoundParams* params, const QByteArray& data) {
+    qint32 version;
+    switch (SoundParamsParser::parseSfxr(params, data.constData(), data.size(), &version)) {
+    case SoundParamsParser::SfxrStatus::Ok:
+        return {};
+    case SoundParamsParser::SfxrStatus::InvalidVersion: {
         auto message =
             QCoreApplication::translate("SoundIO", "Invalid version value: %1.").arg(version);
         return Result::createError(message);
     }
-
-    sound->setWaveForm(static_cast<WaveForm::Enum>(readInt32()));
-
-    sound->setVolume(version == 102 ? readQReal() : 0.5);
-
-    sound->setBaseFrequency(readQReal());
-    sound->setMinFrequency(readQReal());
-    sound->setSlide(readQReal());
-    if (version >= 101) {
-        sound->setDeltaSlide(readQReal());
+    case SoundParamsParser::SfxrStatus::Truncated: {
+        auto message = QCoreApplication::translate("SoundIO", "File is truncated.");
+        return Result::createError(message);
     }
-    sound->setSquareDuty(readQReal());
-    sound->setDutySweep(readQReal());
-
-    sound->setVibratoDepth(readQReal());
-    sound->setVibratoSpeed(readQReal());
-    // p_vib_delay, unused
-    readQReal();
-
-    sound->setAttackTime(readQReal());
-    sound->setSustainTime(readQReal());
-    sound->setDecayTime(readQReal());
-    sound->setSustainPunch(readQReal());
-
-    // filter_on, unused
-    bool unused;
-    device->read(reinterpret_cast<char*>(&unused), sizeof(bool));
-
-    sound->setLpFilterResonance(readQReal());
-    sound->setLpFilterCutoff(readQReal());
-    sound->setLpFilterCutoffSweep(readQReal());
-    sound->setHpFilterCutoff(readQReal());
-    sound->setHpFilterCutoffSweep(readQReal());
-
-    sound->setPhaserOffset(readQReal());
-    sound->setPhaserSweep(readQReal());
-
-    sound->setRepeatSpeed(readQReal());
-
-    if (version >= 101) {
-        sound->setChangeSpeed(readQReal());
-        sound->setChangeAmount(readQReal());
     }
-    return {};
+    Q_UNREACHABLE();
 }
 
 Result save(const Sound* sound, const QUrl& url) {
@@ -186,8 +152,50 @@ Result saveSfxr(const Sound* sound, QIODevice* device) {
 }
 
 Result loadSfxj(Sound* sound, QIODevice* device) {
-    auto json = device->readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(json);
+    auto params = SoundParams::fromSound(sound);
+    auto result = loadSfxj(&params, device->readAll());
+    if (!result) {
+        return result;
+    }
+    params.applyTo(sound);
+    return {};
+}
+
+/**
+ * Sets the property called `key` in `params`. Returns false if `key` is not a
+ * property or if the value cannot be converted.
+ */
+static bool setParam(SoundParams* params, const QString& key, const QVariant& value) {
+    if (key == "waveForm") {
+        bool ok;
+        int waveForm = value.toInt(&ok);
+        if (!ok) {
+            auto name = value.toString().toUtf8();
+            waveForm = QMetaEnum::fromType<WaveForm::Enum>().keyToValue(name, &ok);
+        }
+        if (ok) {
+            params->waveForm = WaveForm::Enum(waveForm);
+        }
+        return ok;
+    }
+    for (const auto& field : SoundParams::realFields()) {
+        if (key == field.name) {
+            bool ok;
+            qreal realValue = value.toDouble(&ok);
+            if (ok) {
+                params->*field.member = realValue;
+            }
+            return ok;
+        }
+    }
+    return false;
+}
+
+/**
+ * Generic loader, used for files the fast parser does not handle
+ */
+static Result loadSfxjDocument(SoundParams* params, const QByteArray& data) {
+    QJsonDocument doc = QJsonDocument::fromJson(data);
     if (!doc.isObject()) {
         auto message = QCoreApplication::translate("SoundIO", "Invalid JSON.");
         return Result::createError(message);
@@ -211,11 +219,21 @@ Result loadSfxj(Sound* sound, QIODevice* device) {
     auto props = root["properties"].toObject();
     auto it = props.constBegin(), end = props.constEnd();
     for (; it != end; ++it) {
-        sound->setProperty(it.key().toUtf8(), it.value().toVariant());
+        // Ignore unknown properties, like the old versions did
+        setParam(params, it.key(), it.value().toVariant());
     }
+    params->clamp();
     return {};
 }
 
+Result loadSfxj(SoundParams* params, const QByteArray& data) {
+    // Try the fast parser first, it handles the files written by saveSfxj()
+    if (SoundParamsParser::parseSfxj(params, data.constData(), data.size())) {
+        return {};
+    }
+    return loadSfxjDocument(params, data);
+}
+
 Result saveSfxj(const Sound* sound, QIODevice* device) {
     static const QSet<QString> IGNORED_PROPERTIES = {"url", "name", "objectName", "hasRealUrl"};
 
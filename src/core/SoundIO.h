@@ -3,7 +3,9 @@
 
 class Result;
 class Sound;
+struct SoundParams;
 
+class QByteArray;
 class QIODevice;
 class QString;
 class QUrl;
@@ -12,12 +14,23 @@ namespace SoundIO {
 
 Result load(Sound* sound, const QUrl& url);
 
+/**
+ * Loads the parameters of the sound stored at `url`, without creating a
+ * Sound. Parameters missing from the file keep their values. `params` is left
+ * untouched on error.
+ */
+Result load(SoundParams* params, const QUrl& url);
+
 Result save(const Sound* sound, const QUrl& url);
 
 Result loadSfxr(Sound* sound, QIODevice* device);
 
 Result loadSfxj(Sound* sound, QIODevice* device);
 
+Result loadSfxr(SoundParams* params, const QByteArray& data);
+
+Result loadSfxj(SoundParams* params, const QByteArray& data);
+
 Result saveSfxr(const Sound* sound, QIODevice* device);
 
 Result saveSfxj(const Sound* sound, QIODevice* device);
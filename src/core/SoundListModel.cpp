@@ -1,8 +1,15 @@
 #include "SoundListModel.h"
 
+#include "ExportService.h"
+#include "ParamBank.h"
 #include "Sound.h"
+#include "SoundMorph.h"
+#include "SoundParams.h"
+#include "WavSaver.h"
 
+#include <QDir>
 #include <QQmlEngine>
+#include <QSet>
 
 #include <algorithm>
 
@@ -19,7 +26,17 @@ int SoundListModel::count() const {
 }
 
 Sound* SoundListModel::soundForRow(int row) const {
-    return mItems.at(row).get();
+    auto& item = mItems.at(row);
+    if (!item.sound) {
+        auto* sound = new Sound;
+        item.bank->params(item.bankIndex).applyTo(sound);
+        sound->setUnsavedName(item.bank->name(item.bankIndex));
+        item.sound.reset(sound);
+        // The sound no longer needs the bank
+        item.bank.reset();
+        const_cast<SoundListModel*>(this)->setupSound(sound);
+    }
+    return item.sound.get();
 }
 
 QVariant SoundListModel::data(const QModelIndex& index, int role) const {
@@ -27,12 +44,13 @@ QVariant SoundListModel::data(const QModelIndex& index, int role) const {
     if (row < 0 || row >= static_cast<int>(mItems.size())) {
         return QVariant();
     }
-    Sound* sound = soundForRow(row);
+    const auto& item = mItems.at(row);
     switch (role) {
     case TextRole:
-        return sound->name();
+        // Do not create the sound just to get its name
+        return item.sound ? item.sound->name() : item.bank->name(item.bankIndex);
     case SoundRole:
-        return QVariant::fromValue(sound);
+        return QVariant::fromValue(soundForRow(row));
     }
     return QVariant();
 }
@@ -45,14 +63,99 @@ QHash<int, QByteArray> SoundListModel::roleNames() const {
 }
 
 void SoundListModel::addNew(Sound* sound) {
-    // Make sure QML does not delete `sound` behind our back
-    QQmlEngine::setObjectOwnership(sound, QQmlEngine::CppOwnership);
-
+    setupSound(sound);
+    Item item;
+    item.sound.reset(sound);
     beginInsertRows(QModelIndex(), 0, 0);
-    mItems.insert(mItems.begin(), std::unique_ptr<Sound>(sound));
+    mItems.insert(mItems.begin(), std::move(item));
+    endInsertRows();
+    countChanged(count());
+}
+
+void SoundListModel::addMorphs(int fromRow, int toRow, int count) {
+    int size = static_cast<int>(mItems.size());
+    Q_ASSERT(fromRow >= 0 && fromRow < size);
+    Q_ASSERT(toRow >= 0 && toRow < size);
+    auto* fromSound = soundForRow(fromRow);
+    auto* toSound = soundForRow(toRow);
+    auto from = SoundParams::fromSound(fromSound);
+    auto to = SoundParams::fromSound(toSound);
+    auto name = tr("%1 to %2").arg(fromSound->name(), toSound->name());
+    // addNew() inserts at the top, so add the last step first. Steps 0 and
+    // count + 1 are the two sounds themselves.
+    for (int step = count; step >= 1; --step) {
+        auto* sound = new Sound;
+        SoundMorph::interpolate(from, to, SoundMorph::stepPosition(step, count + 2))
+            .applyTo(sound);
+        sound->setUnsavedName(
+            QString("%1 %2/%3").arg(name, QString::number(step), QString::number(count)));
+        addNew(sound);
+    }
+}
+
+Result SoundListModel::loadBank(const QUrl& url) {
+    auto bank = std::make_shared<ParamBank>();
+    auto result = bank->open(url.path());
+    if (!result) {
+        return result;
+    }
+    int bankCount = bank->count();
+    if (bankCount == 0) {
+        return {};
+    }
+    std::vector<Item> items(bankCount);
+    for (int idx = 0; idx < bankCount; ++idx) {
+        items[idx].bank = bank;
+        items[idx].bankIndex = idx;
+    }
+    beginInsertRows(QModelIndex(), 0, bankCount - 1);
+    mItems.insert(mItems.begin(),
+                  std::make_move_iterator(items.begin()),
+                  std::make_move_iterator(items.end()));
     endInsertRows();
-    connect(sound, &Sound::nameChanged, this, [this, sound] { onSoundNameChanged(sound); });
     countChanged(count());
+    return {};
+}
+
+/**
+ * Returns a file name for a sound called `name`, which is not in `usedNames`
+ */
+static QString uniqueFileName(const QString& name,
+                              const QString& extension,
+                              QSet<QString>* usedNames) {
+    static const QString FORBIDDEN_CHARS = QStringLiteral("/\\:*?\"<>|");
+    QString baseName = name;
+    for (auto& ch : baseName) {
+        if (FORBIDDEN_CHARS.contains(ch)) {
+            ch = '_';
+        }
+    }
+    QString fileName = baseName + '.' + extension;
+    for (int idx = 2; usedNames->contains(fileName); ++idx) {
+        fileName = QString("%1-%2.%3").arg(baseName).arg(idx).arg(extension);
+    }
+    usedNames->insert(fileName);
+    return fileName;
+}
+
+int SoundListModel::exportAll(ExportService* service, WavSaver* saver, const QUrl& dirUrl) const {
+    QDir dir(dirUrl.path());
+    auto extension = WavSaver::fileExtension(saver->format());
+    QSet<QString> usedNames;
+    for (const auto& item : mItems) {
+        // Do not create the sounds of parameter banks just to export them
+        auto params = item.sound ? SoundParams::fromSound(item.sound.get())
+                                 : item.bank->params(item.bankIndex);
+        auto name = item.sound ? item.sound->name() : item.bank->name(item.bankIndex);
+        service->add(*saver, params, dir.filePath(uniqueFileName(name, extension, &usedNames)));
+    }
+    return int(mItems.size());
+}
+
+void SoundListModel::setupSound(Sound* sound) {
+    // Make sure QML does not delete `sound` behind our back
+    QQmlEngine::setObjectOwnership(sound, QQmlEngine::CppOwnership);
+    connect(sound, &Sound::nameChanged, this, [this, sound] { onSoundNameChanged(sound); });
 }
 
 void SoundListModel::remove(int row) {
@@ -73,10 +176,9 @@ void SoundListModel::resetSoundAtRow(int row) {
 }
 
 void SoundListModel::onSoundNameChanged(Sound* sound) {
-    auto it =
-        std::find_if(mItems.begin(), mItems.end(), [sound](const std::unique_ptr<Sound>& rowSound) {
-            return sound == rowSound.get();
-        });
+    auto it = std::find_if(mItems.begin(), mItems.end(), [sound](const Item& item) {
+        return sound == item.sound.get();
+    });
     Q_ASSERT(it != mItems.end());
     int row = int(std::distance(mItems.begin(), it));
     QModelIndex idx = index(row);
@@ -2,10 +2,16 @@
 #define SOUNDLISTMODEL_H
 
 #include "BaseSoundListModel.h"
+#include "Result.h"
+
+#include <QUrl>
 
 #include <memory>
 
+class ExportService;
+class ParamBank;
 class Sound;
+class WavSaver;
 
 class SoundListModel : public BaseSoundListModel {
     Q_OBJECT
@@ -26,12 +32,42 @@ public:
     Q_INVOKABLE Sound* soundForRow(int row) const;
     Q_INVOKABLE void resetSoundAtRow(int row);
 
+    /**
+     * Adds `count` sounds, evenly spaced between the sounds at `fromRow` and
+     * `toRow`, using SoundMorph::interpolate(). They are added at the top of
+     * the list, in order from the closest to `fromRow`.
+     */
+    Q_INVOKABLE void addMorphs(int fromRow, int toRow, int count);
+
+    /**
+     * Adds all the sounds of the parameter bank at `url`. The Sound instances
+     * are only created when needed, so that large banks load instantly.
+     */
+    Q_INVOKABLE Result loadBank(const QUrl& url);
+
+    /**
+     * Queues the export of all the sounds to the directory at `dirUrl`, with
+     * the settings of `saver`. Files are named after the sounds. Returns the
+     * number of queued sounds.
+     */
+    Q_INVOKABLE int exportAll(ExportService* service, WavSaver* saver, const QUrl& dirUrl) const;
+
     int count() const override;
 
 private:
+    struct Item {
+        std::unique_ptr<Sound> sound;
+        // For sounds from a parameter bank, until `sound` is created. The
+        // bank is released once no item references it.
+        std::shared_ptr<const ParamBank> bank;
+        int bankIndex = -1;
+    };
+
     void onSoundNameChanged(Sound* sound);
+    void setupSound(Sound* sound);
 
-    std::vector<std::unique_ptr<Sound>> mItems;
+    // Mutable because sounds from parameter banks are created on demand
+    mutable std::vector<Item> mItems;
 };
 
 #endif // SOUNDLISTMODEL_H
@@ -0,0 +1,74 @@
+#include "SoundMorph.h"
+
+#include "BufferStrategy.h"
+#include "Parallel.h"
+
+#include <cmath>
+
+namespace SoundMorph {
+
+/**
+ * Returns `samples1` and `samples2` mixed with weights 1 - `ratio` and
+ * `ratio`. The shortest one is padded with silence.
+ */
+static QVector<qreal>
+crossfade(const QVector<qreal>& samples1, const QVector<qreal>& samples2, qreal ratio) {
+    QVector<qreal> samples(qMax(samples1.size(), samples2.size()));
+    for (int idx = 0; idx < samples.size(); ++idx) {
+        qreal sample1 = idx < samples1.size() ? samples1.at(idx) : 0;
+        qreal sample2 = idx < samples2.size() ? samples2.at(idx) : 0;
+        samples[idx] = sample1 * (1 - ratio) + sample2 * ratio;
+    }
+    return samples;
+}
+
+SoundParams interpolate(const SoundParams& from, const SoundParams& to, qreal position) {
+    SoundParams params;
+    params.waveForm = position < 0.5 ? from.waveForm : to.waveForm;
+    for (const auto& field : SoundParams::realFields()) {
+        // Written this way, position 1 gives exactly the value of `to`
+        params.*field.member = from.*field.member * (1 - position) + to.*field.member * position;
+    }
+    return params;
+}
+
+QVector<qreal> synthesize(const SoundParams& from, const SoundParams& to, qreal position) {
+    auto params = interpolate(from, to, position);
+    if (from.waveForm == to.waveForm) {
+        return renderSamples(params);
+    }
+    params.waveForm = from.waveForm;
+    auto fromSamples = renderSamples(params);
+    params.waveForm = to.waveForm;
+    auto toSamples = renderSamples(params);
+    return crossfade(fromSamples, toSamples, position);
+}
+
+qreal stepPosition(int step, int stepCount) {
+    return stepCount > 1 ? qreal(step) / (stepCount - 1) : 0;
+}
+
+QVector<QVector<qreal>>
+synthesizeSteps(const SoundParams& from, const SoundParams& to, int stepCount, int jobs) {
+    QVector<QVector<qreal>> steps(stepCount);
+    auto* stepData = steps.data();
+    Parallel::forEachIndex(stepCount, jobs, [&from, &to, stepCount, stepData](int index) {
+        stepData[index] = synthesize(from, to, stepPosition(index, stepCount));
+    });
+    return steps;
+}
+
+QVector<qreal> mixSteps(const QVector<QVector<qreal>>& steps, qreal position) {
+    if (steps.isEmpty()) {
+        return {};
+    }
+    qreal scaled = qBound(0., position, 1.) * (steps.size() - 1);
+    int step = qMin(int(std::floor(scaled)), steps.size() - 1);
+    qreal ratio = scaled - step;
+    if (ratio == 0) {
+        return steps.at(step);
+    }
+    return crossfade(steps.at(step), steps.at(step + 1), ratio);
+}
+
+} // namespace SoundMorph
@@ -0,0 +1,52 @@
+#ifndef SOUNDMORPH_H
+#define SOUNDMORPH_H
+
+#include "SoundParams.h"
+
+#include <QVector>
+
+/**
+ * Functions to create intermediate sounds between two sounds, for example to
+ * build a family of small, medium and large explosions from the smallest and
+ * the largest ones.
+ *
+ * Positions go from 0, for the first sound, to 1, for the second one.
+ */
+namespace SoundMorph {
+
+/**
+ * Returns the parameters at `position`. Real parameters are interpolated
+ * linearly, the wave form is the one of the closest sound.
+ */
+SoundParams interpolate(const SoundParams& from, const SoundParams& to, qreal position);
+
+/**
+ * Synthesizes the sound at `position`. If the wave forms of the two sounds
+ * differ, the interpolated parameters are synthesized with each wave form, and
+ * the results are crossfaded according to `position`, so that the timbre
+ * changes gradually.
+ */
+QVector<qreal> synthesize(const SoundParams& from, const SoundParams& to, qreal position);
+
+/**
+ * Returns the position of step `step` of `stepCount` evenly spaced steps. The
+ * first step is at 0 and the last one at 1.
+ */
+qreal stepPosition(int step, int stepCount);
+
+/**
+ * Synthesizes `stepCount` evenly spaced steps, using up to `jobs` threads
+ */
+QVector<QVector<qreal>>
+synthesizeSteps(const SoundParams& from, const SoundParams& to, int stepCount, int jobs);
+
+/**
+ * Returns an approximation of the sound at `position`, by crossfading the two
+ * closest of the evenly spaced `steps`. Unlike synthesize(), this is fast
+ * enough to follow the position while the user drags it.
+ */
+QVector<qreal> mixSteps(const QVector<QVector<qreal>>& steps, qreal position);
+
+} // namespace SoundMorph
+
+#endif // SOUNDMORPH_H
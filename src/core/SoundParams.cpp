@@ -0,0 +1,69 @@
+#include "SoundParams.h"
+
+#include <cstring>
+
+static constexpr quint64 FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+static constexpr quint64 FNV_PRIME = 0x100000001b3ULL;
+
+static quint64 fnv1a(quint64 hash, quint64 value) {
+    // Hash byte by byte, least significant first, to get the same result on
+    // all endiannesses
+    for (int i = 0; i < 8; ++i) {
+        hash ^= (value >> (i * 8)) & 0xff;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+void SoundParams::clamp() {
+    // Times can be negative, mutations create some: the synthesizer uses their
+    // square
+    for (auto member :
+         {&SoundParams::attackTime, &SoundParams::sustainTime, &SoundParams::decayTime}) {
+        this->*member = qBound(-MAX_ENVELOPE_TIME, this->*member, MAX_ENVELOPE_TIME);
+    }
+}
+
+const std::array<SoundParams::RealField, SoundParams::REAL_FIELD_COUNT>& SoundParams::realFields() {
+    static const std::array<RealField, REAL_FIELD_COUNT> fields = {{
+        {"attackTime", &SoundParams::attackTime},
+        {"sustainTime", &SoundParams::sustainTime},
+        {"sustainPunch", &SoundParams::sustainPunch},
+        {"decayTime", &SoundParams::decayTime},
+        {"baseFrequency", &SoundParams::baseFrequency},
+        {"minFrequency", &SoundParams::minFrequency},
+        {"slide", &SoundParams::slide},
+        {"deltaSlide", &SoundParams::deltaSlide},
+        {"vibratoDepth", &SoundParams::vibratoDepth},
+        {"vibratoSpeed", &SoundParams::vibratoSpeed},
+        {"changeAmount", &SoundParams::changeAmount},
+        {"changeSpeed", &SoundParams::changeSpeed},
+        {"squareDuty", &SoundParams::squareDuty},
+        {"dutySweep", &SoundParams::dutySweep},
+        {"repeatSpeed", &SoundParams::repeatSpeed},
+        {"phaserOffset", &SoundParams::phaserOffset},
+        {"phaserSweep", &SoundParams::phaserSweep},
+        {"lpFilterCutoff", &SoundParams::lpFilterCutoff},
+        {"lpFilterCutoffSweep", &SoundParams::lpFilterCutoffSweep},
+        {"lpFilterResonance", &SoundParams::lpFilterResonance},
+        {"hpFilterCutoff", &SoundParams::hpFilterCutoff},
+        {"hpFilterCutoffSweep", &SoundParams::hpFilterCutoffSweep},
+        {"volume", &SoundParams::volume},
+    }};
+    return fields;
+}
+
+quint64 SoundParams::hash() const {
+    quint64 hash = fnv1a(FNV_OFFSET_BASIS, quint64(waveForm));
+    for (const auto& field : realFields()) {
+        double value = this->*field.member;
+        if (value == 0) {
+            // Make sure 0 and -0 hash the same
+            value = 0;
+        }
+        quint64 bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        hash = fnv1a(hash, bits);
+    }
+    return hash;
+}
@@ -0,0 +1,90 @@
+#ifndef SOUNDPARAMS_H
+#define SOUNDPARAMS_H
+
+#include "WaveForm.h"
+
+#include <QtGlobal>
+
+#include <array>
+
+class Sound;
+
+/**
+ * A plain copy of the synthesis parameters of a Sound.
+ *
+ * Unlike Sound, this is not a QObject: it is cheap to copy and can be passed
+ * to worker threads.
+ */
+struct SoundParams {
+    struct RealField {
+        const char* name;
+        qreal SoundParams::*member;
+    };
+    static constexpr int REAL_FIELD_COUNT = 23;
+
+    /**
+     * Longest supported attack, sustain and decay times. Longer stages would
+     * make the sound too long to be held in memory.
+     */
+    static constexpr qreal MAX_ENVELOPE_TIME = 10;
+
+    WaveForm::Enum waveForm = WaveForm::Square;
+
+    qreal attackTime = 0;
+    qreal sustainTime = 0.3;
+    qreal sustainPunch = 0;
+    qreal decayTime = 0.4;
+
+    qreal baseFrequency = 0.3;
+    qreal minFrequency = 0;
+    qreal slide = 0;
+    qreal deltaSlide = 0;
+    qreal vibratoDepth = 0;
+    qreal vibratoSpeed = 0;
+
+    qreal changeAmount = 0;
+    qreal changeSpeed = 0;
+
+    qreal squareDuty = 0;
+    qreal dutySweep = 0;
+
+    qreal repeatSpeed = 0;
+
+    qreal phaserOffset = 0;
+    qreal phaserSweep = 0;
+
+    qreal lpFilterCutoff = 1;
+    qreal lpFilterCutoffSweep = 0;
+    qreal lpFilterResonance = 0;
+    qreal hpFilterCutoff = 0;
+    qreal hpFilterCutoffSweep = 0;
+
+    qreal volume = 0.5;
+
+    static SoundParams fromSound(const Sound* sound);
+
+    /**
+     * Sets the synthesis parameters of `sound` to these ones
+     */
+    void applyTo(Sound* sound) const;
+
+    /**
+     * The qreal members, with the name of the matching Sound property
+     */
+    static const std::array<RealField, REAL_FIELD_COUNT>& realFields();
+
+    /**
+     * Returns a hash of the parameters. The value is stable across runs and
+     * platforms, so it can be stored on disk.
+     */
+    quint64 hash() const;
+
+    /**
+     * Brings the parameters back into the range the synthesizer supports.
+     * Must be called on parameters loaded from files, which can contain
+     * anything.
+     */
+    void clamp();
+};
+
+#endif // SOUNDPARAMS_H
@@ -0,0 +1,346 @@
+#include "SoundParamsParser.h"
+
+#include "SoundParams.h"
+
+#include <QtEndian>
+
+#include <array>
+#include <cassert>
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <iterator>
+
+#include <string.h>
+
+namespace SoundParamsParser {
+
+// Must be kept in sync with WaveForm::Enum
+static constexpr const char* WAVE_FORM_NAMES[] = {
+    "Square",
+    "Sawtooth",
+    "Sine",
+    "Noise",
+    "Triangle",
+};
+
+SfxrStatus parseSfxr(SoundParams* params, const char* data, std::size_t size, qint32* version) {
+    const char* ptr = data;
+    const char* end = data + size;
+    bool truncated = false;
+    auto read = [&ptr, end, &truncated](void* value, int size) {
+        if (end - ptr < size) {
+            truncated = true;
+            memset(value, 0, size);
+            return;
+        }
+        memcpy(value, ptr, size);
+        ptr += size;
+    };
+    auto readQReal = [&read] {
+        float value;
+        read(&value, sizeof(float));
+        value = qFromLittleEndian(value);
+        return qreal(value);
+    };
+    auto readInt32 = [&read] {
+        qint32 value;
+        read(&value, sizeof(qint32));
+        value = qFromLittleEndian(value);
+        return value;
+    };
+
+    *version = readInt32();
+    if (*version != 100 && *version != 101 && *version != 102) {
+        return SfxrStatus::InvalidVersion;
+    }
+
+    // Decode to a copy, so that `params` is left untouched on error
+    SoundParams result = *params;
+    result.waveForm = static_cast<WaveForm::Enum>(readInt32());
+
+    result.volume = *version == 102 ? readQReal() : 0.5;
+
+    result.baseFrequency = readQReal();
+    result.minFrequency = readQReal();
+    result.slide = readQReal();
+    if (*version >= 101) {
+        result.deltaSlide = readQReal();
+    }
+    result.squareDuty = readQReal();
+    result.dutySweep = readQReal();
+
+    result.vibratoDepth = readQReal();
+    result.vibratoSpeed = readQReal();
+    // p_vib_delay, unused
+    readQReal();
+
+    result.attackTime = readQReal();
+    result.sustainTime = readQReal();
+    result.decayTime = readQReal();
+    result.sustainPunch = readQReal();
+
+    // filter_on, unused
+    bool unused;
+    read(&unused, sizeof(bool));
+
+    result.lpFilterResonance = readQReal();
+    result.lpFilterCutoff = readQReal();
+    result.lpFilterCutoffSweep = readQReal();
+    result.hpFilterCutoff = readQReal();
+    result.hpFilterCutoffSweep = readQReal();
+
+    result.phaserOffset = readQReal();
+    result.phaserSweep = readQReal();
+
+    result.repeatSpeed = readQReal();
+
+    if (*version >= 101) {
+        result.changeSpeed = readQReal();
+        result.changeAmount = readQReal();
+    }
+
+    if (truncated) {
+        return SfxrStatus::Truncated;
+    }
+    result.clamp();
+    *params = result;
+    return SfxrStatus::Ok;
+}
+
+class SfxjParser {
+public:
+    SfxjParser(const char* data, std::size_t size) : mPtr(data), mEnd(data + size) {
+    }
+
+    bool parse(SoundParams* params) {
+        // Work on a copy, so that `params` is left untouched if we fail
+        SoundParams result = *params;
+        bool hasVersion = false;
+        bool ok = parseObject([this, &result, &hasVersion](const char* key, int size) {
+            if (isKey(key, size, "version")) {
+                double version;
+                hasVersion = parseNumber(&version) && version <= MAX_SFXJ_VERSION;
+                return hasVersion;
+            }
+            if (isKey(key, size, "properties")) {
+                return parseObject([this, &result](const char* key, int size) {
+                    return parseProperty(&result, key, size);
+                });
+            }
+            return skipScalar();
+        });
+        skipSpaces();
+        if (!ok || !hasVersion || mPtr != mEnd) {
+            return false;
+        }
+        result.clamp();
+        *params = result;
+        return true;
+    }
+
+private:
+    // A property, found by its name. `member` is null for the wave form.
+    struct Key {
+        const char* name = nullptr;
+        qreal SoundParams::*member = nullptr;
+    };
+
+    static constexpr int KEY_TABLE_BITS = 5;
+    // Found by trying seeds until all keys have their own slot. A test makes
+    // sure it is still the case.
+    static constexpr quint32 KEY_HASH_SEED = 68564;
+
+    const char* mPtr;
+    const char* const mEnd;
+
+    static quint32 hashKey(const char* key, int size) {
+        quint32 hash = KEY_HASH_SEED;
+        for (int idx = 0; idx < size; ++idx) {
+            hash = (hash ^ quint8(key[idx])) * 16777619u;
+        }
+        return hash >> (32 - KEY_TABLE_BITS);
+    }
+
+    static const std::array<Key, 1 << KEY_TABLE_BITS>& keyTable() {
+        static const auto table = [] {
+            std::array<Key, 1 << KEY_TABLE_BITS> table;
+            auto add = [&table](const char* name, qreal SoundParams::*member) {
+                auto& key = table[hashKey(name, int(strlen(name)))];
+                assert(!key.name);
+                key.name = name;
+                key.member = member;
+            };
+            add("waveForm", nullptr);
+            for (const auto& field : SoundParams::realFields()) {
+                add(field.name, field.member);
+            }
+            return table;
+        }();
+        return table;
+    }
+
+    static bool isKey(const char* key, int size, const char* expected) {
+        return int(strlen(expected)) == size && memcmp(key, expected, size) == 0;
+    }
+
+    bool parseProperty(SoundParams* params, const char* name, int size) {
+        const auto& key = keyTable()[hashKey(name, size)];
+        if (!key.name || !isKey(name, size, key.name)) {
+            return skipScalar();
+        }
+        if (key.member) {
+            return parseNumber(&(params->*key.member));
+        }
+        skipSpaces();
+        if (mPtr != mEnd && *mPtr == '"') {
+            const char* value;
+            int valueSize;
+            if (!parseString(&value, &valueSize)) {
+                return false;
+            }
+            for (int idx = 0; idx < int(std::size(WAVE_FORM_NAMES)); ++idx) {
+                if (isKey(value, valueSize, WAVE_FORM_NAMES[idx])) {
+                    params->waveForm = WaveForm::Enum(idx);
+                    return true;
+                }
+            }
+            return false;
+        }
+        double waveForm;
+        if (!parseNumber(&waveForm) || waveForm != int(waveForm)) {
+            return false;
+        }
+        params->waveForm = WaveForm::Enum(int(waveForm));
+        return true;
+    }
+
+    static bool isNumberChar(char ch) {
+        return (ch >= '0' && ch <= '9') || ch == '-' || ch == '+' || ch == '.' || ch == 'e'
+               || ch == 'E';
+    }
+
+    void skipSpaces() {
+        while (mPtr != mEnd && (*mPtr == ' ' || *mPtr == '\n' || *mPtr == '\r' || *mPtr == '\t')) {
+            ++mPtr;
+        }
+    }
+
+    bool expect(char ch) {
+        skipSpaces();
+        if (mPtr == mEnd || *mPtr != ch) {
+            return false;
+        }
+        ++mPtr;
+        return true;
+    }
+
+    /**
+     * Calls `parseMember(key, keySize)` for each member, which must parse the
+     * value
+     */
+    template <typename F> bool parseObject(const F& parseMember) {
+        if (!expect('{')) {
+            return false;
+        }
+        skipSpaces();
+        if (mPtr != mEnd && *mPtr == '}') {
+            ++mPtr;
+            return true;
+        }
+        while (true) {
+            const char* key;
+            int keySize;
+            if (!parseString(&key, &keySize) || !expect(':') || !parseMember(key, keySize)) {
+                return false;
+            }
+            skipSpaces();
+            if (mPtr == mEnd) {
+                return false;
+            }
+            char ch = *mPtr++;
+            if (ch == '}') {
+                return true;
+            }
+            if (ch != ',') {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * Parses a string without escape sequences, which never appear in the
+     * names we are interested in
+     */
+    bool parseString(const char** begin, int* size) {
+        if (!expect('"')) {
+            return false;
+        }
+        const char* end = static_cast<const char*>(memchr(mPtr, '"', mEnd - mPtr));
+        if (!end || memchr(mPtr, '\\', end - mPtr)) {
+            return false;
+        }
+        *begin = mPtr;
+        *size = int(end - mPtr);
+        mPtr = end + 1;
+        return true;
+    }
+
+    bool parseNumber(double* value) {
+        skipSpaces();
+        const char* begin = mPtr;
+        while (mPtr != mEnd && isNumberChar(*mPtr)) {
+            ++mPtr;
+        }
+        // Copy to a null-terminated buffer for strtod()
+        char buffer[32];
+        int size = int(mPtr - begin);
+        if (size == 0 || size >= int(std::size(buffer))) {
+            return false;
+        }
+        // strtod() uses the decimal point of the current locale, which may
+        // not be '.'
+        const char* decimalPoint = localeconv()->decimal_point;
+        if (strlen(decimalPoint) != 1) {
+            return false;
+        }
+        for (int idx = 0; idx < size; ++idx) {
+            buffer[idx] = begin[idx] == '.' ? decimalPoint[0] : begin[idx];
+        }
+        buffer[size] = '\0';
+        char* end;
+        *value = strtod(buffer, &end);
+        return end == buffer + size && std::isfinite(*value);
+    }
+
+    /**
+     * Skips a value which is not an object nor an array
+     */
+    bool skipScalar() {
+        skipSpaces();
+        if (mPtr == mEnd) {
+            return false;
+        }
+        if (*mPtr == '"') {
+            const char* value;
+            int size;
+            return parseString(&value, &size);
+        }
+        for (const char* literal : {"true", "false", "null"}) {
+            int size = int(strlen(literal));
+            if (mEnd - mPtr >= size && memcmp(mPtr, literal, size) == 0) {
+                mPtr += size;
+                return true;
+            }
+        }
+        double value;
+        return parseNumber(&value);
+    }
+};
+
+bool parseSfxj(SoundParams* params, const char* data, std::size_t size) {
+    SfxjParser parser(data, size);
+    return parser.parse(params);
+}
+
+} // namespace SoundParamsParser
@@ -0,0 +1,51 @@
+#ifndef SOUNDPARAMSPARSER_H
+#define SOUNDPARAMSPARSER_H
+
+#include <QtGlobal>
+
+#include <cstddef>
+
+struct SoundParams;
+
+/**
+ * Decoders for the .sfxr and .sfxj formats, working on bytes in memory.
+ *
+ * They only use the C++ standard library, so that libsfxr can use them
+ * without linking with Qt. SoundIO wraps them and produces the error messages.
+ */
+namespace SoundParamsParser {
+
+/**
+ * Most recent version of the .sfxj format
+ */
+static constexpr int MAX_SFXJ_VERSION = 1;
+
+enum class SfxrStatus {
+    Ok,
+    InvalidVersion,
+    Truncated,
+};
+
+/**
+ * Decodes a .sfxr file. If the version is invalid, it is stored in `version`.
+ * `params` is left untouched on error.
+ */
+SfxrStatus parseSfxr(SoundParams* params, const char* data, std::size_t size, qint32* version);
+
+/**
+ * Decodes a .sfxj file, as written by SoundIO::saveSfxj(): a JSON object with
+ * a "version" number and a "properties" object of numbers, plus the name of
+ * the wave form.
+ *
+ * It works on the raw bytes, without building a JSON document, and finds the
+ * properties with a perfect hash table. Returns false as soon as it finds
+ * something unexpected, for example escape sequences or an unsupported
+ * version. `params` is left untouched in this case.
+ *
+ * Both decoders clamp the parameters with SoundParams::clamp().
+ */
+bool parseSfxj(SoundParams* params, const char* data, std::size_t size);
+
+} // namespace SoundParamsParser
+
+#endif // SOUNDPARAMSPARSER_H
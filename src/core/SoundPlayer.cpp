@@ -1,29 +1,34 @@
 #include "SoundPlayer.h"
 
+#include "BufferStrategy.h"
+#include "RenderCache.h"
 #include "Sound.h"
-#include "Synthesizer.h"
+#include "SoundParams.h"
 
 #include <QDebug>
+#include <QRunnable>
 #include <QTimer>
 
 #include <SDL.h>
 
-class BufferStrategy : public Synthesizer::SynthStrategy {
+class CacheInsertJob : public QRunnable {
 public:
-    BufferStrategy(QVector<qreal>* samples) : mSamples(samples) {
+    CacheInsertJob(RenderCache* cache, const SoundParams& params, const QVector<qreal>& samples)
+            : mCache(cache), mParams(params), mSamples(samples) {
     }
 
-    void write(qreal sample) override {
-        auto value = qBound(-1., sample, 1.);
-        mSamples->push_back(value);
+    void run() override {
+        mCache->insertSamples(mParams, mSamples);
     }
 
 private:
-    QVector<qreal>* const mSamples;
+    RenderCache* const mCache;
+    const SoundParams mParams;
+    const QVector<qreal> mSamples;
 };
 
 SoundPlayer::SoundPlayer(QObject* parent) : QObject(parent), mPlayTimer(new QTimer(this)) {
-    mPlayThreadData.samples.reserve(65536);
+    mCacheThreadPool.setMaxThreadCount(1);
     mPlayTimer->setInterval(0);
     mPlayTimer->setSingleShot(true);
     connect(mPlayTimer, &QTimer::timeout, this, &SoundPlayer::startPlaying);
@@ -32,6 +37,7 @@ SoundPlayer::SoundPlayer(QObject* parent) : QObject(parent), mPlayTimer(new QTim
 
 SoundPlayer::~SoundPlayer() {
     unregisterCallback();
+    mCacheThreadPool.waitForDone();
 }
 
 Sound* SoundPlayer::sound() const {
@@ -47,7 +53,7 @@ void SoundPlayer::setSound(Sound* value) {
     }
     mSound = value;
     if (mSound) {
-        updateSamples();
+        updateSamples(true);
         connect(mSound, &Sound::modified, this, &SoundPlayer::onSoundModified);
     }
     {
@@ -80,10 +86,14 @@ QVector<qreal> SoundPlayer::samples() const {
 }
 
 void SoundPlayer::startPlaying() {
+    if (!mSound) {
+        return;
+    }
     {
         QMutexLocker lock(&mMutex);
         mPlayThreadData.position = 0;
         mPlayThreadData.playing = true;
+        mPlayThreadData.playingExternal = false;
     }
     playPositionChanged(0);
 }
@@ -95,12 +105,13 @@ void SoundPlayer::staticSdlAudioCallback(void* userdata, unsigned char* stream,
 
 void SoundPlayer::sdlAudioCallback(unsigned char* stream, int byteLength) {
     memset(stream, 0, byteLength);
-    if (!mSound) {
-        return;
-    }
     qreal playPosition = 0;
     {
         QMutexLocker lock(&mMutex);
+        if (mPlayThreadData.playingExternal) {
+            fillWithExternalSamples(reinterpret_cast<qint16*>(stream), byteLength / 2);
+            return;
+        }
         if (!mPlayThreadData.playing) {
             return;
         }
@@ -124,6 +135,19 @@ void SoundPlayer::sdlAudioCallback(unsigned char* stream, int byteLength) {
     playPositionChanged(playPosition);
 }
 
+void SoundPlayer::fillWithExternalSamples(qint16* buffer, int length) {
+    auto& data = mPlayThreadData;
+    const qreal* samples = data.externalSamples.constData() + data.externalPosition;
+    int count = qMin(length, data.externalSamples.count() - data.externalPosition);
+    for (int idx = 0; idx < count; ++idx) {
+        buffer[idx] = static_cast<qint16>(samples[idx] * 32767);
+    }
+    data.externalPosition += count;
+    if (data.externalPosition == data.externalSamples.count()) {
+        data.playingExternal = false;
+    }
+}
+
 void SoundPlayer::registerCallback() {
     SDL_AudioSpec des;
     des.freq = 44100;
@@ -147,21 +171,41 @@ void SoundPlayer::play() {
     mPlayTimer->start();
 }
 
+void SoundPlayer::playSamples(const QVector<qreal>& samples) {
+    mPlayTimer->stop();
+    {
+        QMutexLocker lock(&mMutex);
+        // Stop the sound
+        mPlayThreadData.playing = false;
+        mPlayThreadData.position = 0;
+        mPlayThreadData.externalSamples = samples;
+        mPlayThreadData.externalPosition = 0;
+        mPlayThreadData.playingExternal = !samples.isEmpty();
+    }
+    playPositionChanged(0);
+}
+
 void SoundPlayer::onSoundModified() {
-    updateSamples();
+    // Edited sounds change all the time, do not fill the cache with them
+    updateSamples(false);
     play();
     soundModified();
 }
 
-void SoundPlayer::updateSamples() {
-    QMutexLocker lock(&mMutex);
+void SoundPlayer::updateSamples(bool useCache) {
+    auto params = SoundParams::fromSound(mSound);
+    auto* cache = useCache ? RenderCache::instance() : nullptr;
+    QVector<qreal> samples;
+    if (!cache || !cache->findSamples(params, &samples)) {
+        samples = renderSamples(params);
+        if (cache) {
+            mCacheThreadPool.start(new CacheInsertJob(cache, params, samples));
+        }
+    }
 
-    mPlayThreadData.samples.clear();
+    // Only lock now, so that the audio thread is not blocked while the
+    // samples are produced
+    QMutexLocker lock(&mMutex);
+    mPlayThreadData.samples.swap(samples);
     mPlayThreadData.position = 0;
-
-    Synthesizer synth;
-    synth.init(mSound);
-    BufferStrategy strategy(&mPlayThreadData.samples);
-    while (synth.synthSample(256, &strategy)) {
-    }
 }
@@ -3,6 +3,7 @@
 
 #include <QMutex>
 #include <QObject>
+#include <QThreadPool>
 #include <QVector>
 
 class QTimer;
@@ -19,6 +20,14 @@ public:
 
     Q_INVOKABLE void play();
 
+    /**
+     * Plays samples rendered by the caller, once, instead of the sound. The
+     * samples of the sound are kept: samples(), playPositionChanged() and
+     * looping only concern the sound. The next call to play() plays the sound
+     * again.
+     */
+    void playSamples(const QVector<qreal>& samples);
+
     Sound* sound() const;
     void setSound(Sound* value);
 
@@ -37,6 +46,9 @@ private:
     bool mLoop = false;
     QTimer* mPlayTimer;
     Sound* mSound = nullptr;
+    // Stores the rendered sounds in the render cache, so that the disk writes
+    // do not block the UI
+    QThreadPool mCacheThreadPool;
 
     mutable QMutex mMutex;
     struct PlayThreadData {
@@ -44,9 +56,18 @@ private:
         bool playing = false;
         bool loop = false;
         int position = 0;
+        // The samples passed to playSamples()
+        QVector<qreal> externalSamples;
+        bool playingExternal = false;
+        int externalPosition = 0;
     } mPlayThreadData;
 
     void sdlAudioCallback(unsigned char* stream, int len);
+    /**
+     * Fills `buffer` with the next samples passed to playSamples(). Must be
+     * called with mMutex locked.
+     */
+    void fillWithExternalSamples(qint16* buffer, int length);
     void registerCallback();
     void unregisterCallback();
 
@@ -55,7 +76,11 @@ private:
     static void staticSdlAudioCallback(void* userdata, unsigned char* stream, int len);
 
     void onSoundModified();
-    void updateSamples();
+    /**
+     * Synthesizes the samples of the sound. If `useCache` is true, gets them
+     * from the render cache if possible, and stores them there otherwise.
+     */
+    void updateSamples(bool useCache);
 };
 
 #endif // SOUNDPLAYER_H
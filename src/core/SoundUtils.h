@@ -1,25 +1,29 @@
 #ifndef SOUNDUTILS_H
 #define SOUNDUTILS_H
 
-#include "Sound.h"
+#include "SoundParams.h"
 
-#include <memory>
+class Random;
 
 /**
- * Functions to randomly generate or mutate sounds
+ * Functions to randomly generate or mutate sounds.
+ *
+ * The random values come from `random`: the same seed produces the same
+ * sounds, and the functions can be called from several threads at once, as
+ * long as each thread uses its own generator.
  */
 namespace SoundUtils {
 
-std::unique_ptr<Sound> generatePickup();
-std::unique_ptr<Sound> generateLaser();
-std::unique_ptr<Sound> generateExplosion();
-std::unique_ptr<Sound> generatePowerup();
-std::unique_ptr<Sound> generateHitHurt();
-std::unique_ptr<Sound> generateJump();
-std::unique_ptr<Sound> generateBlipSelect();
-std::unique_ptr<Sound> randomize(WaveForm::Enum waveForm);
+SoundParams generatePickup(Random* random);
+SoundParams generateLaser(Random* random);
+SoundParams generateExplosion(Random* random);
+SoundParams generatePowerup(Random* random);
+SoundParams generateHitHurt(Random* random);
+SoundParams generateJump(Random* random);
+SoundParams generateBlipSelect(Random* random);
+SoundParams randomize(WaveForm::Enum waveForm, Random* random);
 
-void mutate(Sound* sound);
+void mutate(SoundParams* params, Random* random);
 
 } // namespace SoundUtils
 
@@ -0,0 +1,100 @@
+#include "Spectrum.h"
+
+#include <array>
+#include <cmath>
+#include <complex>
+
+namespace Spectrum {
+
+using Complex = std::complex<qreal>;
+
+static constexpr qreal TWO_PI = 6.28318530717958647692;
+
+/**
+ * The tables of an in-place radix-2 FFT of FRAME_SIZE values, computed once
+ */
+class FftTables {
+public:
+    static const FftTables& instance() {
+        static const FftTables tables;
+        return tables;
+    }
+
+    std::array<qreal, FRAME_SIZE> window;
+    std::array<Complex, FRAME_SIZE / 2> twiddles;
+    std::array<int, FRAME_SIZE> bitReversed;
+
+private:
+    FftTables() {
+        int bits = 0;
+        while ((1 << bits) < FRAME_SIZE) {
+            ++bits;
+        }
+        for (int idx = 0; idx < FRAME_SIZE; ++idx) {
+            window[idx] = 0.5 - 0.5 * std::cos(TWO_PI * idx / FRAME_SIZE);
+            int reversed = 0;
+            for (int bit = 0; bit < bits; ++bit) {
+                reversed |= ((idx >> bit) & 1) << (bits - 1 - bit);
+            }
+            bitReversed[idx] = reversed;
+        }
+        for (int idx = 0; idx < FRAME_SIZE / 2; ++idx) {
+            twiddles[idx] = std::polar(1.0, -TWO_PI * idx / FRAME_SIZE);
+        }
+    }
+};
+
+void computeMagnitudes(const qreal* frame, int count, qreal* magnitudes) {
+    const auto& tables = FftTables::instance();
+    std::array<Complex, FRAME_SIZE> values;
+    if (count >= FRAME_SIZE) {
+        for (int idx = 0; idx < FRAME_SIZE; ++idx) {
+            int src = tables.bitReversed[idx];
+            values[idx] = frame[src] * tables.window[src];
+        }
+    } else {
+        // Fit the window to the samples, so that the end of the sound does not
+        // look like a sudden drop to silence
+        for (int idx = 0; idx < FRAME_SIZE; ++idx) {
+            int src = tables.bitReversed[idx];
+            qreal window = 0.5 - 0.5 * std::cos(TWO_PI * src / count);
+            values[idx] = src < count ? frame[src] * window : 0;
+        }
+    }
+
+    for (int size = 2; size <= FRAME_SIZE; size *= 2) {
+        int half = size / 2;
+        int twiddleStep = FRAME_SIZE / size;
+        for (int start = 0; start < FRAME_SIZE; start += size) {
+            for (int idx = 0; idx < half; ++idx) {
+                Complex odd = values[start + idx + half] * tables.twiddles[idx * twiddleStep];
+                Complex even = values[start + idx];
+                values[start + idx] = even + odd;
+                values[start + idx + half] = even - odd;
+            }
+        }
+    }
+
+    for (int idx = 0; idx < BIN_COUNT; ++idx) {
+        magnitudes[idx] = std::abs(values[idx]);
+    }
+}
+
+qreal binFrequency(qreal bin, int sampleRate) {
+    return bin * sampleRate / FRAME_SIZE;
+}
+
+QVector<int> logBandEdges(qreal minFrequency, qreal maxFrequency, int bandCount, int sampleRate) {
+    QVector<int> edges(bandCount + 1);
+    qreal binWidth = binFrequency(1, sampleRate);
+    for (int band = 0; band <= bandCount; ++band) {
+        qreal frequency =
+            minFrequency * std::pow(maxFrequency / minFrequency, qreal(band) / bandCount);
+        int bin = qMin(int(std::lround(frequency / binWidth)), BIN_COUNT);
+        edges[band] = band > 0 ? qMax(bin, edges.at(band - 1) + 1) : bin;
+    }
+    Q_ASSERT(edges.last() <= BIN_COUNT);
+    return edges;
+}
+
+} // namespace Spectrum
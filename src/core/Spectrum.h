@@ -0,0 +1,47 @@
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <QVector>
+
+/**
+ * Spectral analysis of synthesized samples
+ */
+namespace Spectrum {
+
+/**
+ * Number of samples analyzed at once. At 44100 Hz, a frame lasts 23 ms.
+ */
+static constexpr int FRAME_SIZE = 1024;
+
+static constexpr int BIN_COUNT = FRAME_SIZE / 2;
+
+/**
+ * Computes the magnitude spectrum of the `count` samples starting at `frame`,
+ * with a Hann window. `count` can be lower than FRAME_SIZE for the last frame
+ * of a sound: the window then covers the `count` samples, and the missing
+ * samples are zeros.
+ *
+ * Stores BIN_COUNT values in `magnitudes`. Bin `idx` is centered on
+ * binFrequency(idx).
+ */
+void computeMagnitudes(const qreal* frame, int count, qreal* magnitudes);
+
+/**
+ * Returns the frequency in Hz of the center of bin `bin`. `bin` can be
+ * fractional, for positions between two bins.
+ */
+qreal binFrequency(qreal bin, int sampleRate);
+
+/**
+ * Splits the spectrum from `minFrequency` to `maxFrequency` in `bandCount`
+ * bands of logarithmically increasing widths, so that each octave gets the
+ * same number of bands.
+ *
+ * Returns the first bin of each band, followed by the end of the last band.
+ * Each band has at least one bin.
+ */
+QVector<int> logBandEdges(qreal minFrequency, qreal maxFrequency, int bandCount, int sampleRate);
+
+} // namespace Spectrum
+
+#endif // SPECTRUM_H
@@ -1,17 +1,27 @@
 #include "Synthesizer.h"
 
 #include "NoiseGenerator.h"
-#include "Sound.h"
+#include "SineTable.h"
 
-#include <QDebug>
+#include <algorithm>
+#include <cassert>
 
 #include <math.h>
 
-static const qreal PI = 3.14159265;
-
 static const qreal MASTER_VOL = 0.2;
 
-static const int NOISE_SAMPLE_COUNT = 32;
+/**
+ * Returns the length of an envelope stage lasting `time`, in samples
+ */
+static int envelopeLength(qreal time) {
+    // Loaders clamp the times, but parameters can come from elsewhere. The
+    // comparison also catches NaN.
+    time = qAbs(time);
+    if (!(time <= SoundParams::MAX_ENVELOPE_TIME)) {
+        time = SoundParams::MAX_ENVELOPE_TIME;
+    }
+    return int(time * time * Synthesizer::ENVELOPE_SCALE);
+}
 
 inline qreal ramp(qreal x, qreal x1, qreal x2, qreal y1, qreal y2) {
     qreal k = (x - x1) / (x2 - x1); // k goes from 0 to 1
@@ -20,111 +30,160 @@ inline qreal ramp(qreal x, qreal x1, qreal x2, qreal y1, qreal y2) {
 
 class WaveFormGenerator {
 public:
-    WaveFormGenerator() : mNoiseGenerator(NOISE_SAMPLE_COUNT) {
-    }
-
-    void setSound(const Sound* sound) {
-        mSound = sound;
+    void setParams(const SoundParams* params) {
+        mParams = params;
         mNoiseGenerator.reset();
     }
 
-    qreal generate(int phase, int period) {
-        qreal fp = qreal(phase) / period;
+    /**
+     * Advances `*phase` by `step`, `count` times, and stores the value of the
+     * wave form at each position in `samples`
+     */
+    void generate(int* phase, int period, int step, int count, qreal* samples) {
+        if (mParams->waveForm == WaveForm::Noise) {
+            generateNoise(phase, period, step, count, samples);
+            return;
+        }
+        // Compute all the positions first, so that the loops below do not
+        // depend on the previous iterations, and can be vectorized
+        qreal positions[Synthesizer::MAX_OVERSAMPLING];
+        qreal periodInverse = 1.0 / period;
+        for (int idx = 0; idx < count; ++idx) {
+            *phase += step;
+            if (*phase >= period) {
+                *phase %= period;
+            }
+            positions[idx] = *phase * periodInverse;
+        }
 
-        switch (mSound->waveForm()) {
+        switch (mParams->waveForm) {
         case WaveForm::Square:
-            return fp < mSquareDuty ? 0.5 : -0.5;
+            for (int idx = 0; idx < count; ++idx) {
+                samples[idx] = positions[idx] < mSquareDuty ? 0.5 : -0.5;
+            }
+            return;
         case WaveForm::Sawtooth:
-            return 1.0 - fp * 2;
+            for (int idx = 0; idx < count; ++idx) {
+                samples[idx] = 1.0 - positions[idx] * 2;
+            }
+            return;
         case WaveForm::Sine:
-            return sin(fp * 2 * PI);
-        case WaveForm::Noise:
-            return mNoiseGenerator.get(fp);
+            for (int idx = 0; idx < count; ++idx) {
+                samples[idx] = mSineTable.sinTurns(positions[idx]);
+            }
+            return;
         case WaveForm::Triangle:
-            return fp < 0.5 ? ramp(fp, 0, 0.5, -1, 1) : ramp(fp, 0.5, 1, 1, -1);
+            for (int idx = 0; idx < count; ++idx) {
+                qreal fp = positions[idx];
+                samples[idx] = fp < 0.5 ? ramp(fp, 0, 0.5, -1, 1) : ramp(fp, 0.5, 1, 1, -1);
+            }
+            return;
+        case WaveForm::Noise:
+            break;
         }
-        Q_UNREACHABLE();
+        // Only reached with an invalid wave form, for example from a corrupted
+        // .sfxr file
+        std::fill(samples, samples + count, 0);
     }
 
     void onResetSample() {
-        mSquareDuty = 0.5 - mSound->squareDuty() * 0.5;
+        mSquareDuty = 0.5 - mParams->squareDuty * 0.5;
     }
 
     void update() {
-        if (mSound->waveForm() != WaveForm::Square) {
+        if (mParams->waveForm != WaveForm::Square) {
             return;
         }
-        mSquareDuty = qBound(0.0, mSquareDuty - mSound->dutySweep() * 0.00005, 0.5);
+        mSquareDuty = qBound(0.0, mSquareDuty - mParams->dutySweep * 0.00005, 0.5);
     }
 
 private:
-    const Sound* mSound = nullptr;
+    const SoundParams* mParams = nullptr;
+    const SineTable& mSineTable = SineTable::instance();
     qreal mSquareDuty = 0;
     NoiseGenerator mNoiseGenerator;
+
+    void generateNoise(int* phase, int period, int step, int count, qreal* samples) {
+        qreal periodInverse = 1.0 / period;
+        for (int idx = 0; idx < count; ++idx) {
+            *phase += step;
+            if (*phase >= period) {
+                *phase %= period;
+                mNoiseGenerator.nextPeriod();
+            }
+            samples[idx] = mNoiseGenerator.get(*phase * periodInverse);
+        }
+    }
 };
 
 Synthesizer::SynthStrategy::~SynthStrategy() {
 }
 
-Synthesizer::Synthesizer() : mSound(new Sound), mWaveFormGenerator(new WaveFormGenerator) {
+Synthesizer::Synthesizer()
+        : mSineTable(SineTable::instance()), mWaveFormGenerator(new WaveFormGenerator) {
 }
 
 Synthesizer::~Synthesizer() {
 }
 
-void Synthesizer::init(const Sound* sound) {
-    mSound->fromOther(sound);
-    mWaveFormGenerator->setSound(sound);
+void Synthesizer::init(const SoundParams& params) {
+    mParams = params;
+    mWaveFormGenerator->setParams(&mParams);
     start();
 }
 
+void Synthesizer::setOversampling(int oversampling) {
+    assert(oversampling > 0 && MAX_OVERSAMPLING % oversampling == 0);
+    mOversampling = oversampling;
+}
+
 void Synthesizer::resetSample(bool restart) {
-    fperiod = 100.0 / (mSound->baseFrequency() * mSound->baseFrequency() + 0.001);
-    fmaxperiod = 100.0 / (mSound->minFrequency() * mSound->minFrequency() + 0.001);
-    fslide = 1.0 - pow(mSound->slide(), 3.0) * 0.01;
-    fdslide = -pow(mSound->deltaSlide(), 3.0) * 0.000001;
+    fperiod = 100.0 / (mParams.baseFrequency * mParams.baseFrequency + 0.001);
+    fmaxperiod = 100.0 / (mParams.minFrequency * mParams.minFrequency + 0.001);
+    fslide = 1.0 - pow(mParams.slide, 3.0) * 0.01;
+    fdslide = -pow(mParams.deltaSlide, 3.0) * 0.000001;
     mWaveFormGenerator->onResetSample();
-    if (mSound->changeAmount() >= 0.0) {
-        arp_mod = 1.0 - pow(mSound->changeAmount(), 2.0) * 0.9;
+    if (mParams.changeAmount >= 0.0) {
+        arp_mod = 1.0 - pow(mParams.changeAmount, 2.0) * 0.9;
     } else {
-        arp_mod = 1.0 + pow(mSound->changeAmount(), 2.0) * 10.0;
+        arp_mod = 1.0 + pow(mParams.changeAmount, 2.0) * 10.0;
     }
     arp_time = 0;
-    arp_limit = int(pow(1.0 - mSound->changeSpeed(), 2.0) * 20000 + 32);
-    if (mSound->changeSpeed() == 1.0) {
+    arp_limit = int(pow(1.0 - mParams.changeSpeed, 2.0) * 20000 + 32);
+    if (mParams.changeSpeed == 1.0) {
         arp_limit = 0;
     }
     if (!restart) {
         // reset filter
         fltp = 0.0;
         fltdp = 0.0;
-        fltw = pow(mSound->lpFilterCutoff(), 3.0) * 0.1;
-        fltw_d = 1.0 + mSound->lpFilterCutoffSweep() * 0.0001;
-        fltdmp = 5.0 / (1.0 + pow(mSound->lpFilterResonance(), 2.0) * 20.0) * (0.01 + fltw);
+        fltw = pow(mParams.lpFilterCutoff, 3.0) * 0.1;
+        fltw_d = 1.0 + mParams.lpFilterCutoffSweep * 0.0001;
+        fltdmp = 5.0 / (1.0 + pow(mParams.lpFilterResonance, 2.0) * 20.0) * (0.01 + fltw);
         if (fltdmp > 0.8) {
             fltdmp = 0.8;
         }
         fltphp = 0.0;
-        flthp = pow(mSound->hpFilterCutoff(), 2.0) * 0.1;
-        flthp_d = 1.0 + mSound->hpFilterCutoffSweep() * 0.0003;
+        flthp = pow(mParams.hpFilterCutoff, 2.0) * 0.1;
+        flthp_d = 1.0 + mParams.hpFilterCutoffSweep * 0.0003;
         // reset vibrato
         vib_phase = 0.0;
-        vib_speed = pow(mSound->vibratoSpeed(), 2.0) * 0.01;
-        vib_amp = mSound->vibratoDepth() * 0.5;
+        vib_speed = pow(mParams.vibratoSpeed, 2.0) * 0.01;
+        vib_amp = mParams.vibratoDepth * 0.5;
         // reset envelope
         env_vol = 0.0;
         env_stage = Attack;
         env_time = 0;
-        env_length[Attack] = int(mSound->attackTime() * mSound->attackTime() * 100000.0);
-        env_length[Sustain] = int(mSound->sustainTime() * mSound->sustainTime() * 100000.0);
-        env_length[Decay] = int(mSound->decayTime() * mSound->decayTime() * 100000.0);
+        env_length[Attack] = envelopeLength(mParams.attackTime);
+        env_length[Sustain] = envelopeLength(mParams.sustainTime);
+        env_length[Decay] = envelopeLength(mParams.decayTime);
 
-        fphase = pow(mSound->phaserOffset(), 2.0) * 1020.0;
-        if (mSound->phaserOffset() < 0.0) {
+        fphase = pow(mParams.phaserOffset, 2.0) * 1020.0;
+        if (mParams.phaserOffset < 0.0) {
             fphase = -fphase;
         }
-        fdphase = pow(mSound->phaserSweep(), 2.0) * 1.0;
-        if (mSound->phaserSweep() < 0.0) {
+        fdphase = pow(mParams.phaserSweep, 2.0) * 1.0;
+        if (mParams.phaserSweep < 0.0) {
             fdphase = -fdphase;
         }
         ipp = 0;
@@ -133,8 +192,8 @@ void Synthesizer::resetSample(bool restart) {
         }
 
         rep_time = 0;
-        rep_limit = int(pow(1.0 - mSound->repeatSpeed(), 2.0) * 20000 + 32);
-        if (mSound->repeatSpeed() == 0.0) {
+        rep_limit = int(pow(1.0 - mParams.repeatSpeed, 2.0) * 20000 + 32);
+        if (mParams.repeatSpeed == 0.0) {
             rep_limit = 0;
         }
     }
@@ -145,6 +204,17 @@ void Synthesizer::start() {
     resetSample(false);
 }
 
+qint64 Synthesizer::maxSampleCount() const {
+    // Each stage produces one sample per unit of its length, plus one for the
+    // transition to the next stage. The sound stops at the end of Decay.
+    return qint64(env_length[Attack]) + env_length[Sustain] + env_length[Decay] + 2;
+}
+
+qint64 Synthesizer::maxSampleCount(const SoundParams& params) {
+    return qint64(envelopeLength(params.attackTime)) + envelopeLength(params.sustainTime)
+           + envelopeLength(params.decayTime) + 2;
+}
+
 bool Synthesizer::synthSample(int length, SynthStrategy* strategy) {
     for (int i = 0; i < length; i++) {
         rep_time++;
@@ -163,14 +233,14 @@ bool Synthesizer::synthSample(int length, SynthStrategy* strategy) {
         fperiod *= fslide;
         if (fperiod > fmaxperiod) {
             fperiod = fmaxperiod;
-            if (mSound->minFrequency() > 0.0) {
+            if (mParams.minFrequency > 0.0) {
                 return false;
             }
         }
         qreal rfperiod = fperiod;
         if (vib_amp > 0.0) {
             vib_phase += vib_speed;
-            rfperiod = fperiod * (1.0 + sin(vib_phase) * vib_amp);
+            rfperiod = fperiod * (1.0 + mSineTable.sin(vib_phase) * vib_amp);
         }
         int period = std::max(int(rfperiod), 8);
         mWaveFormGenerator->update();
@@ -188,9 +258,8 @@ bool Synthesizer::synthSample(int length, SynthStrategy* strategy) {
             env_vol = qreal(env_time) / env_length[Attack];
             break;
         case Sustain:
-            env_vol = 1.0
-                      + pow(1.0 - qreal(env_time) / env_length[Sustain], 1.0) * 2.0
-                            * mSound->sustainPunch();
+            env_vol =
+                1.0 + (1.0 - qreal(env_time) / env_length[Sustain]) * 2.0 * mParams.sustainPunch;
             break;
         case Decay:
             env_vol = 1.0 - qreal(env_time) / env_length[Decay];
@@ -211,19 +280,20 @@ bool Synthesizer::synthSample(int length, SynthStrategy* strategy) {
             }
         }
 
+        // base waveform. With reduced oversampling, advance faster to keep
+        // the same pitch.
+        qreal samples[MAX_OVERSAMPLING];
+        mWaveFormGenerator->generate(
+            &phase, period, MAX_OVERSAMPLING / mOversampling, mOversampling, samples);
+
         qreal ssample = 0.0;
-        for (int si = 0; si < 8; si++) { // 8x supersampling
-            phase++;
-            if (phase >= period) {
-                phase %= period;
-            }
-            // base waveform
-            qreal sample = mWaveFormGenerator->generate(phase, period);
+        for (int si = 0; si < mOversampling; si++) {
+            qreal sample = samples[si];
 
             // lp filter
             qreal pp = fltp;
             fltw = qBound(0.0, fltw * fltw_d, 0.1);
-            if (mSound->lpFilterCutoff() != 1.0) {
+            if (mParams.lpFilterCutoff != 1.0) {
                 fltdp += (sample - fltp) * fltw;
                 fltdp -= fltdp * fltdmp;
             } else {
@@ -242,10 +312,10 @@ bool Synthesizer::synthSample(int length, SynthStrategy* strategy) {
             // final accumulation and envelope application
             ssample += sample * env_vol;
         }
-        ssample = ssample / 8 * MASTER_VOL;
+        ssample = ssample / mOversampling * MASTER_VOL;
 
-        // mSound->volume() goes from 0 to 1, with 0.5 for 100%
-        ssample *= 2.0 * mSound->volume();
+        // volume goes from 0 to 1, with 0.5 for 100%
+        ssample *= 2.0 * mParams.volume;
 
         strategy->write(ssample);
     }
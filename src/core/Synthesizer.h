@@ -1,15 +1,18 @@
 #ifndef SYNTHESIZER_H
 #define SYNTHESIZER_H
 
+#include "SoundParams.h"
+
 #include <QtGlobal>
 
+#include <array>
+#include <limits>
 #include <memory>
-#include <unordered_map>
 
 static constexpr int PHASER_BUFFER_LENGTH = 1024;
 
+class SineTable;
 class WaveFormGenerator;
-class Sound;
 
 class Synthesizer {
 public:
@@ -19,15 +22,66 @@ public:
         virtual void write(qreal sample) = 0;
     };
 
+    /**
+     * Number of subsamples computed for each output sample by default. This
+     * is also the maximum value for setOversampling().
+     */
+    static constexpr int MAX_OVERSAMPLING = 8;
+
+    /**
+     * Number of samples synthSample() produces per second of sound
+     */
+    static constexpr int SAMPLE_RATE = 44100;
+
+    /**
+     * Version of the synthesis engine. Must be incremented when a change
+     * modifies the synthesized samples, to invalidate the renders stored by
+     * RenderCache.
+     */
+    static constexpr int VERSION = 3;
+
     Synthesizer();
     ~Synthesizer();
 
-    void init(const Sound* sound);
+    void init(const SoundParams& params);
     void start();
     bool synthSample(int length, SynthStrategy* strategy);
 
+    /**
+     * Returns the number of samples synthSample() produces for the sound, from
+     * the start. The actual count is lower if the sound stops early because
+     * its frequency reaches minFrequency.
+     */
+    qint64 maxSampleCount() const;
+
+    /**
+     * Returns the value of maxSampleCount() for `params`, without having to
+     * initialize a synthesizer
+     */
+    static qint64 maxSampleCount(const SoundParams& params);
+
+    /**
+     * Number of samples per squared unit of envelope time
+     */
+    static constexpr qreal ENVELOPE_SCALE = 100000.0;
+
+    /**
+     * Upper bound of maxSampleCount(), reached when all envelope stages last
+     * SoundParams::MAX_ENVELOPE_TIME
+     */
+    static constexpr qint64 MAX_SAMPLE_COUNT =
+        3 * qint64(SoundParams::MAX_ENVELOPE_TIME * SoundParams::MAX_ENVELOPE_TIME * ENVELOPE_SCALE)
+        + 2;
+
+    /**
+     * Lower the oversampling to render faster, at the cost of accuracy. Useful
+     * for previews. Must be a divisor of MAX_OVERSAMPLING.
+     */
+    void setOversampling(int oversampling);
+
 private:
-    std::unique_ptr<Sound> mSound;
+    SoundParams mParams;
+    int mOversampling = MAX_OVERSAMPLING;
     enum EnvelopStage {
         Attack,
         Sustain,
@@ -43,7 +97,7 @@ private:
     qreal square_duty;
     EnvelopStage env_stage;
     int env_time;
-    std::unordered_map<EnvelopStage, int> env_length;
+    std::array<int, Decay + 1> env_length{};
     qreal env_vol;
     qreal fphase;
     qreal fdphase;
@@ -68,7 +122,12 @@ private:
 
     void resetSample(bool restart);
 
+    const SineTable& mSineTable;
     std::unique_ptr<WaveFormGenerator> mWaveFormGenerator;
 };
 
+// Sample counts can be stored in an int, and a whole sound fits in a QVector
+static_assert(Synthesizer::MAX_SAMPLE_COUNT < std::numeric_limits<int>::max() / sizeof(qreal),
+              "Sounds are too long");
+
 #endif // SYNTHESIZER_H
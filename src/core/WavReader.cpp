@@ -0,0 +1,151 @@
+#include "WavReader.h"
+
+#include "Synthesizer.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QtEndian>
+
+#include <limits>
+
+#include <string.h>
+
+namespace WavReader {
+
+static constexpr int FORMAT_PCM = 1;
+static constexpr int FORMAT_FLOAT = 3;
+static constexpr int FORMAT_EXTENSIBLE = 0xfffe;
+
+// Minimum size of the "fmt " chunk
+static constexpr int FORMAT_CHUNK_SIZE = 16;
+
+struct Format {
+    int format = 0;
+    int channels = 0;
+    int sampleRate = 0;
+    int bits = 0;
+};
+
+static Result createError(const QString& reason) {
+    auto message = QCoreApplication::translate("WavReader", "Invalid wav file: %1.").arg(reason);
+    return Result::createError(message);
+}
+
+static qreal readSample(const uchar* ptr, const Format& format) {
+    if (format.format == FORMAT_FLOAT) {
+        quint32 bits = qFromLittleEndian<quint32>(ptr);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+    switch (format.bits) {
+    case 8:
+        // 8-bit samples are unsigned
+        return (int(*ptr) - 128) / 128.0;
+    case 16:
+        return qFromLittleEndian<qint16>(ptr) / 32768.0;
+    case 24: {
+        // Shift to the top of an int32 to get the sign
+        qint32 value = qint32(quint32(ptr[0]) << 8 | quint32(ptr[1]) << 16 | quint32(ptr[2]) << 24);
+        return value / 2147483648.0;
+    }
+    default:
+        return qFromLittleEndian<qint32>(ptr) / 2147483648.0;
+    }
+}
+
+/**
+ * Resamples with a linear interpolation. Good enough to compute features.
+ */
+static QVector<qreal> resample(const QVector<qreal>& input, int inputRate) {
+    if (inputRate == Synthesizer::SAMPLE_RATE || input.isEmpty()) {
+        return input;
+    }
+    qreal step = qreal(inputRate) / Synthesizer::SAMPLE_RATE;
+    int count = int(input.size() / step);
+    QVector<qreal> output(count);
+    for (int idx = 0; idx < count; ++idx) {
+        qreal pos = idx * step;
+        int left = int(pos);
+        int right = qMin(left + 1, input.size() - 1);
+        qreal delta = pos - left;
+        output[idx] = input.at(left) + delta * (input.at(right) - input.at(left));
+    }
+    return output;
+}
+
+Result load(const QByteArray& data, QVector<qreal>* samples) {
+    auto begin = reinterpret_cast<const uchar*>(data.constData());
+    if (data.size() < 12 || memcmp(begin, "RIFF", 4) != 0 || memcmp(begin + 8, "WAVE", 4) != 0) {
+        return createError(QCoreApplication::translate("WavReader", "not a RIFF WAVE file"));
+    }
+
+    // Walk the chunks, looking for "fmt " and "data"
+    Format format;
+    const uchar* sampleData = nullptr;
+    qint64 sampleDataSize = 0;
+    qint64 pos = 12;
+    while (pos + 8 <= data.size()) {
+        const uchar* chunk = begin + pos;
+        qint64 chunkSize = qFromLittleEndian<quint32>(chunk + 4);
+        qint64 available = qMin(chunkSize, data.size() - pos - 8);
+        if (memcmp(chunk, "fmt ", 4) == 0) {
+            if (available < FORMAT_CHUNK_SIZE) {
+                return createError(QCoreApplication::translate("WavReader", "truncated format"));
+            }
+            format.format = qFromLittleEndian<quint16>(chunk + 8);
+            format.channels = qFromLittleEndian<quint16>(chunk + 10);
+            format.sampleRate = int(qFromLittleEndian<quint32>(chunk + 12));
+            format.bits = qFromLittleEndian<quint16>(chunk + 22);
+            if (format.format == FORMAT_EXTENSIBLE && available >= 26) {
+                // The actual format is the first two bytes of the sub-format
+                // GUID
+                format.format = qFromLittleEndian<quint16>(chunk + 32);
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            sampleData = chunk + 8;
+            // Accept truncated files: their size fields are often wrong
+            sampleDataSize = available;
+        }
+        // Chunks are padded to an even size
+        pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    bool supported = (format.format == FORMAT_PCM
+                      && (format.bits == 8 || format.bits == 16 || format.bits == 24
+                          || format.bits == 32))
+                     || (format.format == FORMAT_FLOAT && format.bits == 32);
+    if (!supported || format.channels < 1 || format.sampleRate < 1) {
+        return createError(QCoreApplication::translate("WavReader", "unsupported format"));
+    }
+    if (!sampleData) {
+        return createError(QCoreApplication::translate("WavReader", "no data"));
+    }
+
+    int bytesPerSample = format.bits / 8;
+    int frameSize = bytesPerSample * format.channels;
+    int frameCount = int(qMin(sampleDataSize / frameSize, qint64(std::numeric_limits<int>::max())));
+    QVector<qreal> mixed(frameCount);
+    for (int idx = 0; idx < frameCount; ++idx) {
+        const uchar* frame = sampleData + qint64(idx) * frameSize;
+        qreal sum = 0;
+        for (int channel = 0; channel < format.channels; ++channel) {
+            sum += readSample(frame + channel * bytesPerSample, format);
+        }
+        mixed[idx] = sum / format.channels;
+    }
+    *samples = resample(mixed, format.sampleRate);
+    return {};
+}
+
+Result load(const QString& path, QVector<qreal>* samples) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        auto message = QCoreApplication::translate("WavReader", "Cannot open %1: %2.")
+                           .arg(path, file.errorString());
+        return Result::createError(message);
+    }
+    return load(file.readAll(), samples);
+}
+
+} // namespace WavReader
@@ -0,0 +1,29 @@
+#ifndef WAVREADER_H
+#define WAVREADER_H
+
+#include "Result.h"
+
+#include <QVector>
+
+class QByteArray;
+class QString;
+
+/**
+ * Reads the samples of wav files, to compare them with synthesized sounds
+ */
+namespace WavReader {
+
+/**
+ * Reads the samples of a wav file. Supports PCM files with 8, 16, 24 or 32 bits
+ * per sample and 32-bit float files, with any number of channels.
+ *
+ * Channels are mixed, and the samples are resampled to
+ * Synthesizer::SAMPLE_RATE, between -1 and 1.
+ */
+Result load(const QString& path, QVector<qreal>* samples);
+
+Result load(const QByteArray& data, QVector<qreal>* samples);
+
+} // namespace WavReader
+
+#endif // WAVREADER_H
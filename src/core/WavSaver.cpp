@@ -1,136 +1,399 @@
 #include "WavSaver.h"
 
+#include "FlacEncoder.h"
+#include "RenderCache.h"
 #include "Sound.h"
+#include "SoundParams.h"
 #include "Synthesizer.h"
 
+#include <QCoreApplication>
 #include <QFile>
 #include <QUrl>
 #include <QtEndian>
 
-class WavExportStrategy : public Synthesizer::SynthStrategy {
+#include <limits>
+
+#include <string.h>
+
+static constexpr int HEADER_SIZE = 44;
+
+/**
+ * Converts the synthesized samples to PCM data, and stores it in a memory area
+ * large enough to hold the whole sound
+ */
+class PcmStrategy : public Synthesizer::SynthStrategy {
 public:
-    int file_sampleswritten;
-    qreal filesample = 0.0f;
-    int fileacc = 0;
-    int wav_bits = 16;
-    int wav_freq = 44100;
+    PcmStrategy(int bits, int frequency, uchar* begin, uchar* end)
+            : mBits(bits), mFrequency(frequency), mBegin(begin), mEnd(end), mPtr(begin) {
+    }
+
+    qint64 dataSize() const {
+        return mPtr - mBegin;
+    }
+
+    // Synthesizer::SynthStrategy implementation
+    void write(qreal sample) override;
+
+private:
+    const int mBits;
+    const int mFrequency;
+    uchar* const mBegin;
+    uchar* const mEnd;
+    uchar* mPtr;
+    qreal mAccumulator = 0;
+    int mAccumulatedCount = 0;
+};
+
+void PcmStrategy::write(qreal sample) {
+    // Downsample by averaging consecutive samples
+    mAccumulator += qBound(-1.0, sample, 1.0);
+    mAccumulatedCount++;
+    if (mFrequency != 44100 && mAccumulatedCount < 2) {
+        return;
+    }
+    qreal value = mAccumulator / mAccumulatedCount;
+    mAccumulator = 0;
+    mAccumulatedCount = 0;
+    // The area is sized for the longest possible sound, but never write past
+    // its end, even if that size was wrong
+    Q_ASSERT(mPtr + mBits / 8 <= mEnd);
+    if (mEnd - mPtr < mBits / 8) {
+        return;
+    }
+    if (mBits == 16) {
+        qToLittleEndian(qint16(value * 32000), mPtr);
+        mPtr += 2;
+    } else {
+        *mPtr = quint8(value * 127 + 128);
+        ++mPtr;
+    }
+}
+
+static void writeHeader(uchar* ptr, int bits, int frequency, quint32 dataSize) {
+    auto writeTag = [&ptr](const char* tag) {
+        memcpy(ptr, tag, 4);
+        ptr += 4;
+    };
+    auto writeUInt16 = [&ptr](quint16 value) {
+        qToLittleEndian(value, ptr);
+        ptr += 2;
+    };
+    auto writeUInt32 = [&ptr](quint32 value) {
+        qToLittleEndian(value, ptr);
+        ptr += 4;
+    };
+    writeTag("RIFF");
+    writeUInt32(HEADER_SIZE - 8 + dataSize); // remaining file size
+    writeTag("WAVE");
+
+    writeTag("fmt ");
+    writeUInt32(16);                   // chunk size
+    writeUInt16(1);                    // compression code
+    writeUInt16(1);                    // channels
+    writeUInt32(frequency);            // sample rate
+    writeUInt32(frequency * bits / 8); // bytes/sec
+    writeUInt16(bits / 8);             // block align
+    writeUInt16(bits);                 // bits per sample
+
+    writeTag("data");
+    writeUInt32(dataSize); // chunk size
+}
+
+static Result createOpenError(const QFile& file) {
+    auto message = QCoreApplication::translate("WavSaver", "Cannot open %1: %2.")
+                       .arg(file.fileName())
+                       .arg(file.errorString());
+    return Result::createError(message);
+}
+
+static Result createWriteError(const QFile& file) {
+    auto message = QCoreApplication::translate("WavSaver", "Cannot write %1: %2.")
+                       .arg(file.fileName())
+                       .arg(file.errorString());
+    return Result::createError(message);
+}
+
+static Result createTooLongError() {
+    auto message = QCoreApplication::translate("WavSaver", "The sound is too long to be saved.");
+    return Result::createError(message);
+}
+
+static Result createDeviceWriteError(const QIODevice& device) {
+    auto message = QCoreApplication::translate("WavSaver", "Write error: %1.")
+                       .arg(device.errorString());
+    return Result::createError(message);
+}
+
+WavSaver::WavSaver(QObject* parent) : BaseWavSaver(parent) {
+}
+
+WavSaver::WriteMode WavSaver::writeMode() const {
+    return mWriteMode;
+}
+
+void WavSaver::setWriteMode(WriteMode mode) {
+    mWriteMode = mode;
+}
 
-    ~WavExportStrategy() {
+WavSaver::Format WavSaver::format() const {
+    return mFormat;
+}
+
+void WavSaver::setFormat(Format format) {
+    mFormat = format;
+}
+
+void WavSaver::setJobs(int jobs) {
+    mJobs = jobs;
+}
+
+RenderCache* WavSaver::renderCache() const {
+    return mRenderCache;
+}
+
+void WavSaver::setRenderCache(RenderCache* cache) {
+    mRenderCache = cache;
+}
+
+QString WavSaver::fileExtension(Format format) {
+    switch (format) {
+    case Wav:
+        return QStringLiteral("wav");
+    case Raw:
+        return QStringLiteral("raw");
+    case Flac:
+        return QStringLiteral("flac");
     }
+    Q_UNREACHABLE();
+}
 
-    bool open(const QString& path) {
-        auto file = std::make_unique<QFile>(path);
-        if (!file->open(QIODevice::WriteOnly)) {
-            return false;
+bool WavSaver::save(Sound* sound, const QUrl& url) {
+    return save(SoundParams::fromSound(sound), url.path());
+}
+
+Result WavSaver::save(const SoundParams& params, const QString& path, qint64* sampleCount) const {
+    if (mRenderCache) {
+        QFile file(path);
+        if (!file.open(QIODevice::WriteOnly)) {
+            return createOpenError(file);
+        }
+        QByteArray data;
+        auto result = renderCached(params, &data, sampleCount);
+        if (!result) {
+            return result;
         }
-        mDevice = std::move(file);
-        return true;
+        if (file.write(data) != data.size()) {
+            return createWriteError(file);
+        }
+        return {};
     }
+    Synthesizer synth;
+    synth.init(params);
+    auto source = [&synth](Synthesizer::SynthStrategy* strategy) {
+        while (synth.synthSample(256, strategy)) {
+        }
+    };
+    return saveToFile(source, synth.maxSampleCount(), path, sampleCount);
+}
 
-    qint64 fwrite(const void* ptr, size_t size) {
-        return mDevice->write(reinterpret_cast<const char*>(ptr), size);
+Result WavSaver::save(const SoundParams& params, QIODevice* device, qint64* sampleCount) const {
+    if (mRenderCache) {
+        QByteArray data;
+        auto result = renderCached(params, &data, sampleCount);
+        if (!result) {
+            return result;
+        }
+        if (device->write(data) != data.size()) {
+            return createDeviceWriteError(*device);
+        }
+        return {};
     }
+    Synthesizer synth;
+    synth.init(params);
+    auto source = [&synth](Synthesizer::SynthStrategy* strategy) {
+        while (synth.synthSample(256, strategy)) {
+        }
+    };
+    return saveToDevice(source, synth.maxSampleCount(), device, sampleCount);
+}
 
-    qint64 ftell() const {
-        return mDevice->pos();
+static auto sampleSource(const QVector<qreal>& samples) {
+    return [&samples](Synthesizer::SynthStrategy* strategy) {
+        for (qreal sample : samples) {
+            strategy->write(sample);
+        }
+    };
+}
+
+Result WavSaver::save(const QVector<qreal>& samples,
+                      const QString& path,
+                      qint64* sampleCount) const {
+    return saveToFile(sampleSource(samples), samples.size(), path, sampleCount);
+}
+
+Result WavSaver::save(const QVector<qreal>& samples,
+                      QIODevice* device,
+                      qint64* sampleCount) const {
+    return saveToDevice(sampleSource(samples), samples.size(), device, sampleCount);
+}
+
+Result WavSaver::saveToFile(const SampleSource& source,
+                            qint64 maxSampleCount,
+                            const QString& path,
+                            qint64* sampleCount) const {
+    // The size of FLAC files is not known in advance, they cannot be mapped
+    bool mapped = mWriteMode == Mapped && mFormat != Flac;
+    QFile file(path);
+    auto openMode = mapped ? QIODevice::ReadWrite | QIODevice::Truncate : QIODevice::WriteOnly;
+    if (!file.open(openMode)) {
+        return createOpenError(file);
     }
 
-    void fseek(qint64 offset) {
-        mDevice->seek(offset);
+    qint64 maxSize = maxFileSize(maxSampleCount);
+    uchar* map = nullptr;
+    if (mapped && file.resize(maxSize)) {
+        map = file.map(0, maxSize);
+    }
+    if (map) {
+        qint64 size = render(source, map, map + maxSize);
+        file.unmap(map);
+        if (!file.resize(size)) {
+            return createWriteError(file);
+        }
+        if (sampleCount) {
+            *sampleCount = (size - headerSize()) / (bits() / 8);
+        }
+        return {};
     }
 
-    void fwriteUInt16(quint16 value) {
-        value = qToLittleEndian(value);
-        mDevice->write(reinterpret_cast<char*>(&value), 2);
+    // Not all file systems support mapping: use a buffer if it failed
+    QByteArray data;
+    auto result = renderToBuffer(source, maxSampleCount, &data, sampleCount);
+    if (!result) {
+        return result;
+    }
+    if (file.write(data) != data.size()) {
+        return createWriteError(file);
+    }
+    // Remove the space allocated for mapping, if any
+    if (file.size() != data.size() && !file.resize(data.size())) {
+        return createWriteError(file);
     }
+    return {};
+}
 
-    void fwriteUInt32(quint32 value) {
-        value = qToLittleEndian(value);
-        mDevice->write(reinterpret_cast<char*>(&value), 4);
+Result WavSaver::saveToDevice(const SampleSource& source,
+                              qint64 maxSampleCount,
+                              QIODevice* device,
+                              qint64* sampleCount) const {
+    QByteArray data;
+    auto result = renderToBuffer(source, maxSampleCount, &data, sampleCount);
+    if (!result) {
+        return result;
+    }
+    if (device->write(data) != data.size()) {
+        return createDeviceWriteError(*device);
     }
+    return {};
+}
 
-    void fwriteInt16(qint16 value) {
-        value = qToLittleEndian(value);
-        mDevice->write(reinterpret_cast<char*>(&value), 2);
+Result WavSaver::renderToBuffer(const SampleSource& source,
+                                qint64 maxSampleCount,
+                                QByteArray* data,
+                                qint64* sampleCount) const {
+    qint64 maxSize = maxFileSize(maxSampleCount);
+    if (maxSize > std::numeric_limits<int>::max()) {
+        return createTooLongError();
     }
+    QByteArray buffer(int(maxSize), Qt::Uninitialized);
+    auto begin = reinterpret_cast<uchar*>(buffer.data());
+    qint64 size = render(source, begin, begin + maxSize);
+    buffer.truncate(int(size));
+    qint64 count = (size - headerSize()) / (bits() / 8);
+    if (sampleCount) {
+        *sampleCount = count;
+    }
+    if (mFormat != Flac) {
+        *data = buffer;
+        return {};
+    }
+    // The buffer contains raw PCM data
+    *data = encodeFlac(begin, count);
+    return {};
+}
 
-    // Synthesizer::SynthStrategy implementation
-    void write(qreal sample) override;
+Result WavSaver::renderCached(const SoundParams& params,
+                              QByteArray* data,
+                              qint64* sampleCount) const {
+    auto key = RenderCache::key(params, bits(), frequency());
+    QByteArray pcm;
+    if (!mRenderCache->find(key, &pcm)) {
+        Synthesizer synth;
+        synth.init(params);
+        if (maxFileSize(synth.maxSampleCount()) > std::numeric_limits<int>::max()) {
+            return createTooLongError();
+        }
+        // Downsampling can round up the sample count
+        qint64 maxSize = (synth.maxSampleCount() + 1) * bits() / 8;
+        pcm.resize(int(maxSize));
+        auto begin = reinterpret_cast<uchar*>(pcm.data());
+        PcmStrategy strategy(bits(), frequency(), begin, begin + maxSize);
+        while (synth.synthSample(256, &strategy)) {
+        }
+        pcm.truncate(int(strategy.dataSize()));
+        mRenderCache->insert(key, pcm);
+    }
 
-private:
-    std::unique_ptr<QIODevice> mDevice;
-};
+    qint64 count = pcm.size() / (bits() / 8);
+    if (sampleCount) {
+        *sampleCount = count;
+    }
+    switch (mFormat) {
+    case Wav: {
+        QByteArray header(HEADER_SIZE, Qt::Uninitialized);
+        writeHeader(reinterpret_cast<uchar*>(header.data()), bits(), frequency(), pcm.size());
+        *data = header + pcm;
+        return {};
+    }
+    case Raw:
+        *data = pcm;
+        return {};
+    case Flac:
+        *data = encodeFlac(reinterpret_cast<const uchar*>(pcm.constData()), count);
+        return {};
+    }
+    Q_UNREACHABLE();
+}
 
-void WavExportStrategy::write(qreal ssample) {
-    // quantize depending on format
-    // accumulate/count to accomodate variable sample rate?
-    ssample = qBound(-1.0, ssample, 1.0);
-    filesample += ssample;
-    fileacc++;
-    if (wav_freq == 44100 || fileacc == 2) {
-        filesample /= fileacc;
-        fileacc = 0;
-        if (wav_bits == 16) {
-            qint16 isample = qint16(filesample * 32000);
-            fwriteInt16(isample);
+QByteArray WavSaver::encodeFlac(const uchar* pcm, qint64 count) const {
+    // Convert the samples to signed values
+    QVector<qint32> samples(count);
+    for (int idx = 0; idx < count; ++idx) {
+        if (bits() == 16) {
+            samples[idx] = qFromLittleEndian<qint16>(pcm + 2 * idx);
         } else {
-            quint8 isample = quint8(filesample * 127 + 128);
-            fwrite(&isample, 1);
+            samples[idx] = pcm[idx] - 128;
         }
-        filesample = 0.0;
     }
-    file_sampleswritten++;
+    FlacEncoder encoder(bits(), frequency());
+    encoder.setJobs(mJobs);
+    return encoder.encode(samples);
 }
 
-WavSaver::WavSaver(QObject* parent) : BaseWavSaver(parent) {
+int WavSaver::headerSize() const {
+    return mFormat == Wav ? HEADER_SIZE : 0;
 }
 
-bool WavSaver::save(Sound* sound, const QUrl& url) {
-    QString path = url.path();
-    WavExportStrategy wav;
-    if (!wav.open(path)) {
-        return false;
-    }
-    wav.wav_bits = bits();
-    wav.wav_freq = frequency();
-
-    // write wav header
-    wav.fwrite("RIFF", 4); // "RIFF"
-    wav.fwriteUInt32(0);   // remaining file size
-    wav.fwrite("WAVE", 4); // "WAVE"
-
-    wav.fwrite("fmt ", 4);          // "fmt "
-    wav.fwriteUInt32(16);           // chunk size
-    wav.fwriteUInt16(1);            // compression code
-    wav.fwriteUInt16(1);            // channels
-    wav.fwriteUInt32(wav.wav_freq); // sample rate
-    quint64 bytesPerSec = wav.wav_freq * wav.wav_bits / 8;
-    wav.fwriteUInt32(bytesPerSec);      // bytes/sec
-    wav.fwriteUInt16(wav.wav_bits / 8); // block align
-    wav.fwriteUInt16(wav.wav_bits);     // bits per sample
-
-    wav.fwrite("data", 4); // "data"
-    auto foutstream_datasize = wav.ftell();
-    wav.fwriteUInt32(foutstream_datasize); // chunk size
-
-    // write sample data
-    wav.file_sampleswritten = 0;
-    wav.filesample = 0.0;
-    wav.fileacc = 0;
+qint64 WavSaver::maxFileSize(qint64 maxSampleCount) const {
+    // Downsampling can round up the sample count
+    return headerSize() + (maxSampleCount + 1) * bits() / 8;
+}
 
-    Synthesizer synth;
-    synth.init(sound);
-    while (synth.synthSample(256, &wav)) {
+qint64 WavSaver::render(const SampleSource& source, uchar* begin, uchar* end) const {
+    PcmStrategy pcm(bits(), frequency(), begin + headerSize(), end);
+    source(&pcm);
+    if (mFormat == Wav) {
+        writeHeader(begin, bits(), frequency(), pcm.dataSize());
     }
-
-    // seek back to header and write size info
-    wav.fseek(4);
-    quint64 remainingFileSize =
-        foutstream_datasize - 4 + wav.file_sampleswritten * wav.wav_bits / 8;
-    wav.fwriteUInt32(remainingFileSize); // remaining file size
-    wav.fseek(foutstream_datasize);
-    quint64 dataChunkSize = wav.file_sampleswritten * wav.wav_bits / 8;
-    wav.fwriteUInt32(dataChunkSize); // chunk size (data)
-
-    return true;
+    return headerSize() + pcm.dataSize();
 }
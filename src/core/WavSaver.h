@@ -2,19 +2,151 @@
 #define WAVSAVER_H
 
 #include "BaseWavSaver.h"
+#include "Result.h"
+#include "Synthesizer.h"
 
 #include <QObject>
+#include <QVector>
 
+#include <functional>
+
+class QIODevice;
 class QUrl;
 
+class RenderCache;
 class Sound;
 
 class WavSaver : public BaseWavSaver {
     Q_OBJECT
 public:
+    enum WriteMode {
+        // Render the whole file in memory, then write it in one go
+        Buffered,
+        // Render directly to the file, mapped in memory. Falls back to
+        // Buffered if the file system does not support it.
+        Mapped,
+    };
+
+    enum Format {
+        Wav,
+        // PCM samples without any header: signed little-endian for 16 bits,
+        // unsigned for 8 bits
+        Raw,
+        Flac,
+    };
+
     explicit WavSaver(QObject* parent = nullptr);
 
+    WriteMode writeMode() const;
+    void setWriteMode(WriteMode mode);
+
+    Format format() const;
+    void setFormat(Format format);
+
+    /**
+     * Number of threads used to encode a file, for formats which support it.
+     * Defaults to 1.
+     */
+    void setJobs(int jobs);
+
+    /**
+     * Sets the cache used to reuse the sounds rendered by previous runs, or
+     * null to disable it. Only the overloads receiving sound parameters use
+     * it. Defaults to null.
+     */
+    RenderCache* renderCache() const;
+    void setRenderCache(RenderCache* cache);
+
+    /**
+     * The extension of the files created for `format`, without the leading dot
+     */
+    static QString fileExtension(Format format);
+
     Q_INVOKABLE bool save(Sound* sound, const QUrl& url);
+
+    /**
+     * Synthesizes `params` and saves the result to `path`.
+     *
+     * Does not touch any state of the instance, so it can be called from
+     * several threads at the same time.
+     *
+     * If `sampleCount` is not null, it is set to the number of samples
+     * written to the file.
+     */
+    Result save(const SoundParams& params,
+                const QString& path,
+                qint64* sampleCount = nullptr) const;
+
+    /**
+     * Synthesizes `params` and writes the result to `device`. The device does
+     * not need to be seekable, so it can be a pipe or the standard output.
+     */
+    Result save(const SoundParams& params,
+                QIODevice* device,
+                qint64* sampleCount = nullptr) const;
+
+    /**
+     * Saves `samples`, as produced by the synthesizer, to `path`.
+     *
+     * This makes it possible to export a sound with different settings while
+     * synthesizing it only once.
+     */
+    Result save(const QVector<qreal>& samples,
+                const QString& path,
+                qint64* sampleCount = nullptr) const;
+
+    Result save(const QVector<qreal>& samples,
+                QIODevice* device,
+                qint64* sampleCount = nullptr) const;
+
+private:
+    // Writes the samples of a sound to the strategy it receives
+    using SampleSource = std::function<void(Synthesizer::SynthStrategy* strategy)>;
+
+    WriteMode mWriteMode = Buffered;
+    Format mFormat = Wav;
+    int mJobs = 1;
+    RenderCache* mRenderCache = nullptr;
+
+    Result saveToFile(const SampleSource& source,
+                      qint64 maxSampleCount,
+                      const QString& path,
+                      qint64* sampleCount) const;
+    Result saveToDevice(const SampleSource& source,
+                        qint64 maxSampleCount,
+                        QIODevice* device,
+                        qint64* sampleCount) const;
+
+    /**
+     * Stores the whole content of the file in `data`. Fails if the file would
+     * not fit in a QByteArray.
+     */
+    Result renderToBuffer(const SampleSource& source,
+                          qint64 maxSampleCount,
+                          QByteArray* data,
+                          qint64* sampleCount) const;
+
+    /**
+     * Stores the whole content of the file for `params` in `data`, getting the
+     * samples from the render cache if possible. Fails if the file would not
+     * fit in a QByteArray.
+     */
+    Result renderCached(const SoundParams& params, QByteArray* data, qint64* sampleCount) const;
+
+    /**
+     * Encodes `count` raw PCM samples starting at `pcm` to FLAC
+     */
+    QByteArray encodeFlac(const uchar* pcm, qint64 count) const;
+
+    int headerSize() const;
+    qint64 maxFileSize(qint64 maxSampleCount) const;
+
+    /**
+     * Converts the samples from `source` to `begin`, after room for the
+     * header, then writes the header. The area must be large enough for the
+     * longest possible sound. Returns the size of the file.
+     */
+    qint64 render(const SampleSource& source, uchar* begin, uchar* end) const;
 };
 
 #endif // WAVSAVER_H
@@ -1,18 +1,18 @@
 #include "WaveForm.h"
 
-#include <QQmlEngine>
+#include "Random.h"
+
+#include <QMetaType>
 
 namespace WaveForm {
 
-Enum random(const std::vector<Enum>& values) {
-    int idx = std::rand() % values.size();
+Enum random(Random* random, const std::vector<Enum>& values) {
+    int idx = random->range(int(values.size()) - 1);
     return values.at(idx);
 }
 
 void registerType() {
     qRegisterMetaType<WaveForm::Enum>();
-    qmlRegisterUncreatableMetaObject(
-        WaveForm::staticMetaObject, "sfxr", 1, 0, "WaveForm", "Only enums");
 }
 
 } // namespace WaveForm
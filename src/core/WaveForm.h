@@ -3,6 +3,8 @@
 
 #include <QObject>
 
+class Random;
+
 namespace WaveForm {
 Q_NAMESPACE
 
@@ -16,7 +18,7 @@ enum Enum {
     Triangle,
 };
 
-Enum random(const std::vector<Enum>& values);
+Enum random(Random* random, const std::vector<Enum>& values);
 
 void registerType();
 
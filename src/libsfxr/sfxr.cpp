@@ -0,0 +1,211 @@
+#include "sfxr.h"
+
+#include "SoundParams.h"
+#include "SoundParamsParser.h"
+#include "Synthesizer.h"
+
+#include <algorithm>
+#include <new>
+
+#include <string.h>
+
+struct sfxr_params {
+    SoundParams params;
+};
+
+struct sfxr_synth {
+    Synthesizer synth;
+    bool done = false;
+};
+
+// Number of samples synthesized per call to Synthesizer::synthSample()
+static constexpr size_t BLOCK_SIZE = 4096;
+
+static constexpr int WAVE_FORM_COUNT = WaveForm::Triangle + 1;
+
+/**
+ * Writes the samples to a buffer, clamped to [-1, 1] like the samples of the
+ * exported files
+ */
+template <typename T, T (*convert)(qreal)> class BufferWriter : public Synthesizer::SynthStrategy {
+public:
+    explicit BufferWriter(T* buffer) : mBegin(buffer), mPtr(buffer) {
+    }
+
+    void write(qreal sample) override {
+        *mPtr++ = convert(qBound(-1., sample, 1.));
+    }
+
+    size_t count() const {
+        return size_t(mPtr - mBegin);
+    }
+
+private:
+    T* const mBegin;
+    T* mPtr;
+};
+
+static float toFloat(qreal sample) {
+    return float(sample);
+}
+
+static int16_t toInt16(qreal sample) {
+    // Same scale as WavSaver
+    return int16_t(sample * 32000);
+}
+
+template <typename T, T (*convert)(qreal)>
+static size_t render(sfxr_synth* synth, T* buffer, size_t count) {
+    if (!synth || !buffer) {
+        return 0;
+    }
+    BufferWriter<T, convert> writer(buffer);
+    while (!synth->done && writer.count() < count) {
+        auto length = std::min(count - writer.count(), BLOCK_SIZE);
+        if (!synth->synth.synthSample(int(length), &writer)) {
+            synth->done = true;
+        }
+    }
+    return writer.count();
+}
+
+/**
+ * Returns the member of SoundParams called `name`, or null if there is none.
+ * The wave form is handled by the callers.
+ */
+static qreal SoundParams::*findRealField(const char* name) {
+    for (const auto& field : SoundParams::realFields()) {
+        if (strcmp(field.name, name) == 0) {
+            return field.member;
+        }
+    }
+    return nullptr;
+}
+
+sfxr_params* sfxr_params_create() {
+    return new (std::nothrow) sfxr_params;
+}
+
+sfxr_params* sfxr_params_clone(const sfxr_params* params) {
+    if (!params) {
+        return nullptr;
+    }
+    return new (std::nothrow) sfxr_params(*params);
+}
+
+void sfxr_params_free(sfxr_params* params) {
+    delete params;
+}
+
+int sfxr_params_load_sfxr(sfxr_params* params, const void* data, size_t size) {
+    if (!params || !data) {
+        return SFXR_ERROR_INVALID_ARGUMENT;
+    }
+    qint32 version;
+    auto status = SoundParamsParser::parseSfxr(
+        &params->params, static_cast<const char*>(data), size, &version);
+    return status == SoundParamsParser::SfxrStatus::Ok ? SFXR_OK : SFXR_ERROR_INVALID_DATA;
+}
+
+int sfxr_params_load_sfxj(sfxr_params* params, const void* data, size_t size) {
+    if (!params || !data) {
+        return SFXR_ERROR_INVALID_ARGUMENT;
+    }
+    bool ok = SoundParamsParser::parseSfxj(&params->params, static_cast<const char*>(data), size);
+    return ok ? SFXR_OK : SFXR_ERROR_INVALID_DATA;
+}
+
+int sfxr_params_load(sfxr_params* params, const void* data, size_t size) {
+    if (!params || !data) {
+        return SFXR_ERROR_INVALID_ARGUMENT;
+    }
+    // .sfxj files are JSON objects, .sfxr files start with a small version
+    // number, whose first byte cannot be a space nor a '{'
+    auto begin = static_cast<const char*>(data);
+    auto end = begin + size;
+    auto it = std::find_if(begin, end, [](char ch) {
+        return ch != ' ' && ch != '\n' && ch != '\r' && ch != '\t';
+    });
+    if (it != end && *it == '{') {
+        return sfxr_params_load_sfxj(params, data, size);
+    }
+    return sfxr_params_load_sfxr(params, data, size);
+}
+
+int sfxr_params_set(sfxr_params* params, const char* name, double value) {
+    if (!params || !name) {
+        return SFXR_ERROR_INVALID_ARGUMENT;
+    }
+    if (strcmp(name, "waveForm") == 0) {
+        if (value != int(value) || value < 0 || value >= WAVE_FORM_COUNT) {
+            return SFXR_ERROR_INVALID_ARGUMENT;
+        }
+        params->params.waveForm = WaveForm::Enum(int(value));
+        return SFXR_OK;
+    }
+    auto member = findRealField(name);
+    if (!member) {
+        return SFXR_ERROR_INVALID_ARGUMENT;
+    }
+    params->params.*member = value;
+    params->params.clamp();
+    return SFXR_OK;
+}
+
+int sfxr_params_get(const sfxr_params* params, const char* name, double* value) {
+    if (!params || !name || !value) {
+        return SFXR_ERROR_INVALID_ARGUMENT;
+    }
+    if (strcmp(name, "waveForm") == 0) {
+        *value = params->params.waveForm;
+        return SFXR_OK;
+    }
+    auto member = findRealField(name);
+    if (!member) {
+        return SFXR_ERROR_INVALID_ARGUMENT;
+    }
+    *value = params->params.*member;
+    return SFXR_OK;
+}
+
+sfxr_synth* sfxr_synth_create(const sfxr_params* params) {
+    if (!params) {
+        return nullptr;
+    }
+    // Exceptions must not cross the C API
+    sfxr_synth* synth;
+    try {
+        synth = new sfxr_synth;
+    } catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+    synth->synth.init(params->params);
+    return synth;
+}
+
+void sfxr_synth_free(sfxr_synth* synth) {
+    delete synth;
+}
+
+void sfxr_synth_reset(sfxr_synth* synth, const sfxr_params* params) {
+    if (!synth || !params) {
+        return;
+    }
+    synth->synth.init(params->params);
+    synth->done = false;
+}
+
+size_t sfxr_synth_max_sample_count(const sfxr_synth* synth) {
+    if (!synth) {
+        return 0;
+    }
+    return size_t(synth->synth.maxSampleCount());
+}
+
+size_t sfxr_synth_render_f32(sfxr_synth* synth, float* buffer, size_t count) {
+    return render<float, toFloat>(synth, buffer, count);
+}
+
+size_t sfxr_synth_render_s16(sfxr_synth* synth, int16_t* buffer, size_t count) {
+    return render<int16_t, toInt16>(synth, buffer, count);
+}
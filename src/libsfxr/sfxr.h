@@ -0,0 +1,124 @@
+#ifndef SFXR_H
+#define SFXR_H
+
+#include "sfxr_export.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * C API to synthesize sfxr sounds at runtime.
+ *
+ * Sounds are synthesized at 44100 Hz, mono. The library uses the same
+ * synthesizer as the application and sfxr-render, so the samples are the same
+ * as the ones of exported files.
+ *
+ * Functions returning an int return SFXR_OK on success, or one of the
+ * negative error codes.
+ */
+
+#define SFXR_SAMPLE_RATE 44100
+
+enum {
+    SFXR_OK = 0,
+    /** A pointer is null, or a parameter name is unknown */
+    SFXR_ERROR_INVALID_ARGUMENT = -1,
+    /** The data is not a valid .sfxr or .sfxj file */
+    SFXR_ERROR_INVALID_DATA = -2,
+};
+
+/** The synthesis parameters of a sound */
+typedef struct sfxr_params sfxr_params;
+
+/** The state of the synthesis of a sound */
+typedef struct sfxr_synth sfxr_synth;
+
+/**
+ * Creates a parameter set with the default values of a new sound. Returns
+ * NULL if memory cannot be allocated.
+ */
+SFXR_EXPORT sfxr_params* sfxr_params_create(void);
+
+/**
+ * Creates a copy of `params`, to create variants of a sound. Returns NULL if
+ * memory cannot be allocated.
+ */
+SFXR_EXPORT sfxr_params* sfxr_params_clone(const sfxr_params* params);
+
+SFXR_EXPORT void sfxr_params_free(sfxr_params* params);
+
+/**
+ * Loads the content of a .sfxr file. `params` is left untouched on error.
+ */
+SFXR_EXPORT int sfxr_params_load_sfxr(sfxr_params* params, const void* data, size_t size);
+
+/**
+ * Loads the content of a .sfxj file, as written by sfxr-qt. Parameters
+ * missing from the file keep their values. `params` is left untouched on
+ * error.
+ */
+SFXR_EXPORT int sfxr_params_load_sfxj(sfxr_params* params, const void* data, size_t size);
+
+/**
+ * Loads the content of a .sfxr or .sfxj file, guessing the format from the
+ * data
+ */
+SFXR_EXPORT int sfxr_params_load(sfxr_params* params, const void* data, size_t size);
+
+/**
+ * Sets the parameter called `name`. Names are the ones used in .sfxj files,
+ * for example "baseFrequency". "waveForm" accepts 0 (square), 1 (sawtooth),
+ * 2 (sine), 3 (noise) and 4 (triangle). Envelope times are clamped to
+ * [-10, 10], like when loading files.
+ */
+SFXR_EXPORT int sfxr_params_set(sfxr_params* params, const char* name, double value);
+
+/**
+ * Stores the value of the parameter called `name` in `value`
+ */
+SFXR_EXPORT int sfxr_params_get(const sfxr_params* params, const char* name, double* value);
+
+/**
+ * Creates a synthesizer for `params`. Later changes to `params` do not
+ * affect it. Returns NULL if memory cannot be allocated.
+ */
+SFXR_EXPORT sfxr_synth* sfxr_synth_create(const sfxr_params* params);
+
+SFXR_EXPORT void sfxr_synth_free(sfxr_synth* synth);
+
+/**
+ * Restarts the synthesis, with new parameters. Does not allocate memory, so
+ * that a synthesizer can be reused to play variants of a sound.
+ */
+SFXR_EXPORT void sfxr_synth_reset(sfxr_synth* synth, const sfxr_params* params);
+
+/**
+ * Returns the maximum number of samples the sound produces. Useful to
+ * allocate a buffer for the whole sound.
+ */
+SFXR_EXPORT size_t sfxr_synth_max_sample_count(const sfxr_synth* synth);
+
+/**
+ * Synthesizes up to `count` samples, between -1 and 1, to `buffer`. Returns
+ * the number of samples written, which is lower than `count` once the end of
+ * the sound is reached.
+ *
+ * Does not allocate memory nor take locks: it can be called from an audio
+ * callback.
+ */
+SFXR_EXPORT size_t sfxr_synth_render_f32(sfxr_synth* synth, float* buffer, size_t count);
+
+/**
+ * Same as sfxr_synth_render_f32(), with 16-bit signed samples
+ */
+SFXR_EXPORT size_t sfxr_synth_render_s16(sfxr_synth* synth, int16_t* buffer, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SFXR_H */
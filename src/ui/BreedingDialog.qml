@@ -0,0 +1,142 @@
+import QtQuick 2.7
+import QtQuick.Layouts 1.3
+import QtQuick.Controls 2.0
+import QtQuick.Dialogs 1.2
+
+import sfxr 1.0
+
+Dialog {
+    id: root
+    property SoundPlayer soundPlayer
+
+    // Emitted when the user keeps an offspring. The receiver becomes the
+    // owner of `sound`.
+    signal soundKept(Sound sound)
+
+    property real cellMargin: 4
+    property real cellControlHeight: 32
+
+    title: qsTr("Breed sounds - generation %1").arg(breedingModel.generation)
+    standardButtons: StandardButton.Close
+    width: 820
+    height: 560
+
+    function start(sound) {
+        breedingModel.start(sound);
+        open();
+    }
+
+    SystemPalette {
+        id: systemPalette
+    }
+
+    BreedingModel {
+        id: breedingModel
+        onSoundKept: {
+            root.soundKept(sound);
+        }
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+
+        Label {
+            Layout.fillWidth: true
+            wrapMode: Text.Wrap
+            text: qsTr("Click a sound to play it. Check your favourites, then click \"Breed\" to get a new generation from them.")
+        }
+
+        GridView {
+            id: gridView
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            clip: true
+            model: breedingModel
+            cellWidth: breedingModel.thumbnailSize.width + 2 * cellMargin
+            cellHeight: breedingModel.thumbnailSize.height + cellControlHeight + 2 * cellMargin
+            opacity: breedingModel.busy ? 0.5 : 1
+
+            delegate: Rectangle {
+                width: gridView.cellWidth
+                height: gridView.cellHeight
+                color: model.selected ? systemPalette.highlight : "transparent"
+                radius: 2
+
+                SoundThumbnail {
+                    id: thumbnail
+                    x: cellMargin
+                    y: cellMargin
+                    width: breedingModel.thumbnailSize.width
+                    height: breedingModel.thumbnailSize.height
+                    sound: model.sound
+
+                    MouseArea {
+                        anchors.fill: parent
+                        onClicked: {
+                            breedingModel.play(model.index, root.soundPlayer);
+                        }
+                    }
+                }
+
+                CheckBox {
+                    anchors {
+                        left: parent.left
+                        top: thumbnail.bottom
+                    }
+                    height: cellControlHeight
+                    checked: model.selected
+                    onClicked: {
+                        breedingModel.toggleSelected(model.index);
+                    }
+                }
+
+                Button {
+                    anchors {
+                        right: parent.right
+                        rightMargin: cellMargin
+                        top: thumbnail.bottom
+                    }
+                    height: cellControlHeight
+                    flat: true
+                    text: qsTr("Keep")
+                    onClicked: {
+                        breedingModel.keep(model.index);
+                    }
+                }
+            }
+
+            ScrollIndicator.vertical: ScrollIndicator {}
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+
+            Label {
+                text: qsTr("Offspring")
+            }
+
+            SpinBox {
+                from: breedingModel.minOffspringCount
+                to: breedingModel.maxOffspringCount
+                stepSize: 8
+                value: breedingModel.offspringCount
+                onValueChanged: {
+                    breedingModel.offspringCount = value;
+                }
+            }
+
+            Item {
+                Layout.fillWidth: true
+            }
+
+            Button {
+                text: breedingModel.selectedCount > 0
+                    ? qsTr("Breed from %n sound(s)", "", breedingModel.selectedCount)
+                    : qsTr("Breed again")
+                onClicked: {
+                    breedingModel.breed();
+                }
+            }
+        }
+    }
+}
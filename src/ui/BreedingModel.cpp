@@ -0,0 +1,220 @@
+#include "BreedingModel.h"
+
+#include "Breeder.h"
+#include "BufferStrategy.h"
+#include "Parallel.h"
+#include "PreviewImage.h"
+#include "Sound.h"
+#include "SoundPlayer.h"
+#include "ThumbnailRenderer.h"
+
+#include <QQmlEngine>
+#include <QRunnable>
+#include <QThread>
+
+static constexpr int DEFAULT_OFFSPRING_COUNT = 24;
+
+// Size of the thumbnails shown in the grid, in pixels
+static const QSize THUMBNAIL_SIZE = {96, 48};
+
+class BreedingJob : public QRunnable {
+public:
+    BreedingJob(BreedingModel* model,
+                int jobId,
+                const QVector<SoundParams>& parents,
+                const QVector<SoundParams>& offspring)
+            : mModel(model), mJobId(jobId), mParents(parents), mOffspring(offspring) {
+    }
+
+    void run() override {
+        QVector<BreedingModel::RenderedOffspring> rendered(mOffspring.size());
+        auto* renderedData = rendered.data();
+        const auto& offspring = mOffspring;
+        Parallel::forEachIndex(
+            offspring.size(),
+            QThread::idealThreadCount(),
+            [renderedData, &offspring](int index) {
+                auto& item = renderedData[index];
+                item.params = offspring.at(index);
+                item.samples = renderSamples(item.params);
+                item.thumbnail = PreviewImage::create(
+                    item.samples, THUMBNAIL_SIZE.width(), THUMBNAIL_SIZE.height());
+            });
+
+        auto* model = mModel;
+        auto jobId = mJobId;
+        auto parents = mParents;
+        QMetaObject::invokeMethod(
+            model,
+            [model, jobId, parents, rendered] { model->onJobDone(jobId, parents, rendered); },
+            Qt::QueuedConnection);
+    }
+
+private:
+    BreedingModel* const mModel;
+    const int mJobId;
+    const QVector<SoundParams> mParents;
+    const QVector<SoundParams> mOffspring;
+};
+
+BreedingModel::BreedingModel(QObject* parent)
+        : QAbstractListModel(parent)
+        , mRandom(Random::randomSeed())
+        , mOffspringCount(DEFAULT_OFFSPRING_COUNT) {
+    // Jobs use all the cores themselves, so run them one at a time
+    mThreadPool.setMaxThreadCount(1);
+}
+
+BreedingModel::~BreedingModel() {
+    mThreadPool.clear();
+    mThreadPool.waitForDone();
+}
+
+int BreedingModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : int(mOffspring.size());
+}
+
+QVariant BreedingModel::data(const QModelIndex& index, int role) const {
+    int row = index.row();
+    if (row < 0 || row >= rowCount()) {
+        return QVariant();
+    }
+    const auto& offspring = mOffspring.at(row);
+    switch (role) {
+    case SoundRole:
+        return QVariant::fromValue(offspring.sound.get());
+    case SelectedRole:
+        return offspring.selected;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> BreedingModel::roleNames() const {
+    return {
+        {SoundRole, "sound"},
+        {SelectedRole, "selected"},
+    };
+}
+
+void BreedingModel::start(Sound* sound) {
+    startJob({SoundParams::fromSound(sound)});
+}
+
+void BreedingModel::breed() {
+    QVector<SoundParams> parents;
+    for (const auto& offspring : mOffspring) {
+        if (offspring.selected) {
+            parents << SoundParams::fromSound(offspring.sound.get());
+        }
+    }
+    startJob(parents.isEmpty() ? mParents : parents);
+}
+
+void BreedingModel::toggleSelected(int row) {
+    Q_ASSERT(row >= 0 && row < rowCount());
+    auto& offspring = mOffspring.at(row);
+    offspring.selected = !offspring.selected;
+    auto modelIndex = index(row);
+    dataChanged(modelIndex, modelIndex, {SelectedRole});
+    mSelectedCount += offspring.selected ? 1 : -1;
+    selectedCountChanged(mSelectedCount);
+}
+
+void BreedingModel::play(int row, SoundPlayer* player) const {
+    Q_ASSERT(row >= 0 && row < rowCount());
+    player->playSamples(mOffspring.at(row).samples);
+}
+
+void BreedingModel::keep(int row) {
+    Q_ASSERT(row >= 0 && row < rowCount());
+    auto* sound = new Sound;
+    SoundParams::fromSound(mOffspring.at(row).sound.get()).applyTo(sound);
+    sound->setUnsavedName(tr("Bred"));
+    soundKept(sound);
+}
+
+int BreedingModel::offspringCount() const {
+    return mOffspringCount;
+}
+
+void BreedingModel::setOffspringCount(int value) {
+    value = qBound(Breeder::MIN_OFFSPRING_COUNT, value, Breeder::MAX_OFFSPRING_COUNT);
+    if (mOffspringCount == value) {
+        return;
+    }
+    mOffspringCount = value;
+    offspringCountChanged(value);
+}
+
+int BreedingModel::minOffspringCount() const {
+    return Breeder::MIN_OFFSPRING_COUNT;
+}
+
+int BreedingModel::maxOffspringCount() const {
+    return Breeder::MAX_OFFSPRING_COUNT;
+}
+
+QSize BreedingModel::thumbnailSize() const {
+    return THUMBNAIL_SIZE;
+}
+
+int BreedingModel::generation() const {
+    return mGeneration;
+}
+
+int BreedingModel::selectedCount() const {
+    return mSelectedCount;
+}
+
+bool BreedingModel::isBusy() const {
+    return mBusy;
+}
+
+void BreedingModel::startJob(const QVector<SoundParams>& parents) {
+    if (parents.isEmpty()) {
+        return;
+    }
+    // Drop the jobs which have not started yet, their results would be
+    // ignored anyway
+    mThreadPool.clear();
+    auto offspring = Breeder::breed(parents, mOffspringCount, &mRandom);
+    mThreadPool.start(new BreedingJob(this, ++mLastJobId, parents, offspring));
+    if (!mBusy) {
+        mBusy = true;
+        busyChanged(true);
+    }
+}
+
+void BreedingModel::onJobDone(int jobId,
+                              const QVector<SoundParams>& parents,
+                              const QVector<RenderedOffspring>& rendered) {
+    if (jobId != mLastJobId) {
+        return;
+    }
+    auto* thumbnailRenderer = ThumbnailRenderer::instance();
+    beginResetModel();
+    mOffspring.clear();
+    for (const auto& item : rendered) {
+        Offspring offspring;
+        offspring.sound = std::make_unique<Sound>();
+        // Make sure QML does not delete the sound behind our back
+        QQmlEngine::setObjectOwnership(offspring.sound.get(), QQmlEngine::CppOwnership);
+        item.params.applyTo(offspring.sound.get());
+        offspring.samples = item.samples;
+        // The SoundThumbnail items of the grid find their thumbnails there
+        thumbnailRenderer->insert(ThumbnailRenderer::key(item.params, THUMBNAIL_SIZE),
+                                  item.thumbnail);
+        mOffspring.push_back(std::move(offspring));
+    }
+    mParents = parents;
+    endResetModel();
+
+    ++mGeneration;
+    generationChanged(mGeneration);
+    if (mSelectedCount != 0) {
+        mSelectedCount = 0;
+        selectedCountChanged(0);
+    }
+    mBusy = false;
+    busyChanged(false);
+}
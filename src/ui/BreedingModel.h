@@ -0,0 +1,133 @@
+#ifndef BREEDINGMODEL_H
+#define BREEDINGMODEL_H
+
+#include "Random.h"
+#include "SoundParams.h"
+
+#include <QAbstractListModel>
+#include <QImage>
+#include <QSize>
+#include <QThreadPool>
+#include <QVector>
+
+#include <memory>
+#include <vector>
+
+class Sound;
+class SoundPlayer;
+
+/**
+ * The offspring of the current generation of the breeding grid.
+ *
+ * Each generation is bred from the sounds selected in the previous one, using
+ * Breeder. Its sounds are synthesized in the background, on all cores,
+ * together with their thumbnails. The generation replaces the previous one
+ * once all its sounds are ready, so they can be played instantly, without
+ * synthesizing them again.
+ */
+class BreedingModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int offspringCount READ offspringCount WRITE setOffspringCount NOTIFY
+                   offspringCountChanged)
+    Q_PROPERTY(int minOffspringCount READ minOffspringCount CONSTANT)
+    Q_PROPERTY(int maxOffspringCount READ maxOffspringCount CONSTANT)
+    Q_PROPERTY(QSize thumbnailSize READ thumbnailSize CONSTANT)
+    Q_PROPERTY(int generation READ generation NOTIFY generationChanged)
+    Q_PROPERTY(int selectedCount READ selectedCount NOTIFY selectedCountChanged)
+    Q_PROPERTY(bool busy READ isBusy NOTIFY busyChanged)
+public:
+    enum Role {
+        SoundRole = Qt::UserRole,
+        SelectedRole,
+    };
+
+    explicit BreedingModel(QObject* parent = nullptr);
+    ~BreedingModel();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * Starts a new breeding session, with `sound` as the only parent of the
+     * first generation
+     */
+    Q_INVOKABLE void start(Sound* sound);
+
+    /**
+     * Breeds the next generation from the selected offspring. If none is
+     * selected, breeds a new generation from the parents of the current one.
+     */
+    Q_INVOKABLE void breed();
+
+    Q_INVOKABLE void toggleSelected(int row);
+
+    /**
+     * Plays the offspring at `row` with `player`, from its rendered samples
+     */
+    Q_INVOKABLE void play(int row, SoundPlayer* player) const;
+
+    /**
+     * Emits soundKept() with a copy of the offspring at `row`
+     */
+    Q_INVOKABLE void keep(int row);
+
+    int offspringCount() const;
+    void setOffspringCount(int value);
+
+    int minOffspringCount() const;
+    int maxOffspringCount() const;
+
+    QSize thumbnailSize() const;
+
+    int generation() const;
+
+    int selectedCount() const;
+
+    bool isBusy() const;
+
+signals:
+    void offspringCountChanged(int offspringCount);
+    void generationChanged(int generation);
+    void selectedCountChanged(int selectedCount);
+    void busyChanged(bool busy);
+
+    /**
+     * The receiver becomes the owner of `sound`
+     */
+    void soundKept(Sound* sound);
+
+private:
+    friend class BreedingJob;
+
+    struct Offspring {
+        std::unique_ptr<Sound> sound;
+        QVector<qreal> samples;
+        bool selected = false;
+    };
+
+    struct RenderedOffspring {
+        SoundParams params;
+        QVector<qreal> samples;
+        QImage thumbnail;
+    };
+
+    void startJob(const QVector<SoundParams>& parents);
+    void onJobDone(int jobId,
+                   const QVector<SoundParams>& parents,
+                   const QVector<RenderedOffspring>& rendered);
+
+    Random mRandom;
+    QThreadPool mThreadPool;
+    int mOffspringCount;
+    int mGeneration = 0;
+    int mSelectedCount = 0;
+    // Identifies the most recent job: the results of the older ones are
+    // dropped
+    int mLastJobId = 0;
+    bool mBusy = false;
+    QVector<SoundParams> mParents;
+    std::vector<Offspring> mOffspring;
+};
+
+#endif // BREEDINGMODEL_H
@@ -8,6 +8,11 @@ import sfxr 1.0
 ColumnLayout {
     id: root
     property Sound sound
+    property SoundListModel soundListModel
+
+    // Emitted when the sounds of a parameter bank have been added to
+    // soundListModel
+    signal bankLoaded()
 
     TitleLabel {
         text: qsTr("File")
@@ -28,7 +33,7 @@ ColumnLayout {
             id: loadFileDialog
             title: qsTr("Load sound")
             nameFilters: [
-                qsTr("Supported formats (*.sfxj, *.sfxr)") + " (*.sfxj *.sfxr)",
+                qsTr("Supported formats (*.sfxj, *.sfxr, *.sfxp)") + " (*.sfxj *.sfxr *.sfxp)",
                 qsTr("All files") + " (*)"]
             onAccepted: {
                 loadSound(fileUrl);
@@ -85,6 +90,58 @@ ColumnLayout {
         }
     }
 
+    SimilarSoundFinder {
+        id: similarSoundFinder
+        onFinished: {
+            similarSoundsDialog.matches = matches;
+            similarSoundsDialog.open();
+            if (!result.ok) {
+                showError(qsTr("Error indexing sounds"), result.message);
+            }
+        }
+    }
+
+    Dialog {
+        id: similarSoundsDialog
+        property var matches: []
+        title: qsTr("Similar sounds")
+        standardButtons: StandardButton.Close
+        width: 400
+        height: 400
+
+        ListView {
+            anchors.fill: parent
+            clip: true
+            model: similarSoundsDialog.matches
+            delegate: ItemDelegate {
+                width: parent.width
+                text: qsTr("%1 (distance: %2)").arg(modelData.name)
+                    .arg(modelData.distance.toFixed(2))
+                onClicked: {
+                    loadSound(modelData.url);
+                    similarSoundsDialog.close();
+                }
+            }
+        }
+    }
+
+    Button {
+        Layout.fillWidth: true
+        FileDialog {
+            id: findSimilarDialog
+            selectFolder: true
+            title: qsTr("Find similar sounds in")
+            onAccepted: {
+                similarSoundFinder.find(sound, fileUrl, 20);
+            }
+        }
+        text: similarSoundFinder.busy ? qsTr("Searching...") : qsTr("Find similar...")
+        enabled: !similarSoundFinder.busy
+        onClicked: {
+            findSimilarDialog.open();
+        }
+    }
+
     VerticalSpacer {}
 
     TitleLabel {
@@ -95,6 +152,28 @@ ColumnLayout {
         id: wavSaver
     }
 
+    ExportService {
+        id: exportService
+        // Messages of the failed exports of the current batch
+        property var errorMessages: []
+
+        onItemFinished: {
+            if (!result.ok) {
+                errorMessages.push(result.message);
+            }
+        }
+        onFinished: {
+            if (failureCount > 0) {
+                // Do not create a huge dialog if many exports failed
+                var details = errorMessages.slice(0, 10).join("\n");
+                var message = qsTr("%1 of %2 sounds could not be exported.\n%3")
+                    .arg(failureCount).arg(totalCount).arg(details);
+                showError(qsTr("Error exporting sounds"), message);
+            }
+            errorMessages = [];
+        }
+    }
+
     Button {
         Layout.fillWidth: true
         text: qsTr("%1 bits").arg(wavSaver.bits)
@@ -120,7 +199,7 @@ ColumnLayout {
             nameFilters: [qsTr("Wav files") + " (*.wav)",
                 qsTr("All files") + " (*)"]
             onAccepted: {
-                wavSaver.save(sound, fileUrl);
+                exportService.exportSound(wavSaver, sound, fileUrl);
             }
         }
         text: qsTr("Export as...")
@@ -129,6 +208,40 @@ ColumnLayout {
         }
     }
 
+    Button {
+        Layout.fillWidth: true
+        FileDialog {
+            id: exportAllDialog
+            selectFolder: true
+            title: qsTr("Export all sounds to")
+            onAccepted: {
+                soundListModel.exportAll(exportService, wavSaver, fileUrl);
+            }
+        }
+        text: qsTr("Export all...")
+        enabled: !exportService.busy
+        onClicked: {
+            exportAllDialog.open();
+        }
+    }
+
+    ProgressBar {
+        Layout.fillWidth: true
+        visible: exportService.busy
+        from: 0
+        to: exportService.totalCount
+        value: exportService.doneCount
+    }
+
+    Button {
+        Layout.fillWidth: true
+        visible: exportService.busy
+        text: qsTr("Cancel export")
+        onClicked: {
+            exportService.cancel();
+        }
+    }
+
     function showError(title, text) {
         var dlg = messageDialogComponent.createObject(this, {title: title, text: text});
         dlg.open();
@@ -143,7 +256,15 @@ ColumnLayout {
     }
 
     function loadSound(url) {
-        var result = sound.load(url);
+        var result;
+        if (url.toString().endsWith(".sfxp")) {
+            result = soundListModel.loadBank(url);
+            if (result.ok) {
+                bankLoaded();
+            }
+        } else {
+            result = sound.load(url);
+        }
         if (!result.ok) {
             var message = qsTr("Could not load file \"%1\".\n%2").arg(url).arg(result.message);
             showError(qsTr("Error loading file"), message);
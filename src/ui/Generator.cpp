@@ -3,60 +3,50 @@
 #include "Sound.h"
 #include "SoundUtils.h"
 
-using std::move;
-
-Generator::Generator(QObject* parent) : QObject(parent) {
+Generator::Generator(QObject* parent) : QObject(parent), mRandom(Random::randomSeed()) {
 }
 
 void Generator::generatePickup() {
-    auto sound = SoundUtils::generatePickup();
-    finish(move(sound), tr("Pickup"));
+    finish(SoundUtils::generatePickup(&mRandom), tr("Pickup"));
 }
 
 void Generator::generateLaser() {
-    auto sound = SoundUtils::generateLaser();
-    finish(move(sound), tr("Laser"));
+    finish(SoundUtils::generateLaser(&mRandom), tr("Laser"));
 }
 
 void Generator::generateExplosion() {
-    auto sound = SoundUtils::generateExplosion();
-    finish(move(sound), tr("Explosion"));
+    finish(SoundUtils::generateExplosion(&mRandom), tr("Explosion"));
 }
 
 void Generator::generatePowerup() {
-    auto sound = SoundUtils::generatePowerup();
-    finish(move(sound), tr("Power up"));
+    finish(SoundUtils::generatePowerup(&mRandom), tr("Power up"));
 }
 
 void Generator::generateHitHurt() {
-    auto sound = SoundUtils::generateHitHurt();
-    finish(move(sound), tr("Hit"));
+    finish(SoundUtils::generateHitHurt(&mRandom), tr("Hit"));
 }
 
 void Generator::generateJump() {
-    auto sound = SoundUtils::generateJump();
-    finish(move(sound), tr("Jump"));
+    finish(SoundUtils::generateJump(&mRandom), tr("Jump"));
 }
 
 void Generator::generateBlipSelect() {
-    auto sound = SoundUtils::generateBlipSelect();
-    finish(move(sound), tr("Blip"));
+    finish(SoundUtils::generateBlipSelect(&mRandom), tr("Blip"));
 }
 
 void Generator::randomize(WaveForm::Enum waveForm) {
-    auto sound = SoundUtils::randomize(waveForm);
-    finish(move(sound), tr("Randomize"));
+    finish(SoundUtils::randomize(waveForm, &mRandom), tr("Randomize"));
 }
 
 void Generator::mutate(Sound* source) {
-    auto sound = std::make_unique<Sound>();
-    sound->fromOther(source);
-    SoundUtils::mutate(sound.get());
-    finish(move(sound), tr("Mutated"));
+    auto params = SoundParams::fromSound(source);
+    SoundUtils::mutate(&params, &mRandom);
+    finish(params, tr("Mutated"));
 }
 
-void Generator::finish(std::unique_ptr<Sound> soundPtr, const QString& name) {
-    auto sound = soundPtr.release();
+void Generator::finish(const SoundParams& params, const QString& name) {
+    auto sound = new Sound;
+    params.applyTo(sound);
     sound->setUnsavedName(name);
     soundGenerated(sound);
 }
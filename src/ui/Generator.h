@@ -1,13 +1,13 @@
 #ifndef GENERATOR_H
 #define GENERATOR_H
 
+#include "Random.h"
 #include "WaveForm.h"
 
 #include <QObject>
 
-#include <memory>
-
 class Sound;
+struct SoundParams;
 
 /**
  * QML wrapper over SoundUtils functions.
@@ -34,7 +34,9 @@ signals:
     void soundGenerated(Sound* sound);
 
 private:
-    void finish(std::unique_ptr<Sound> soundPtr, const QString& name);
+    Random mRandom;
+
+    void finish(const SoundParams& params, const QString& name);
 };
 
 #endif // GENERATOR_H
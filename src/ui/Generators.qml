@@ -9,6 +9,13 @@ ColumnLayout {
     property Generator generator
     property Sound sound
 
+    // Emitted when the user wants to breed new sounds from the current one
+    signal breedRequested()
+
+    // Emitted when the user wants to create sounds between the current one
+    // and another one
+    signal morphRequested()
+
     TitleLabel {
         id: label
         text: qsTr("Generators")
@@ -89,4 +96,22 @@ ColumnLayout {
         }
         ToolTip.text: qsTr("Randomly alter the settings of the current sound")
     }
+
+    Button {
+        text: qsTr("Breed...")
+        Layout.fillWidth: true
+        onClicked: {
+            breedRequested();
+        }
+        ToolTip.text: qsTr("Pick your favourites among many variations of the current sound, generation after generation")
+    }
+
+    Button {
+        text: qsTr("Morph...")
+        Layout.fillWidth: true
+        onClicked: {
+            morphRequested();
+        }
+        ToolTip.text: qsTr("Create sounds between the current sound and another one")
+    }
 }
@@ -0,0 +1,175 @@
+import QtQuick 2.7
+import QtQuick.Layouts 1.3
+import QtQuick.Controls 2.0
+import QtQuick.Dialogs 1.2
+
+import sfxr 1.0
+
+Dialog {
+    id: root
+    property SoundPlayer soundPlayer
+    property SoundListModel soundListModel
+
+    // Emitted after sounds have been added at the top of soundListModel
+    signal soundsAdded()
+
+    property real cellMargin: 4
+
+    title: qsTr("Morph sounds")
+    standardButtons: StandardButton.Close
+    width: 820
+    height: 420
+
+    function start(row) {
+        fromComboBox.currentIndex = row;
+        toComboBox.currentIndex = row + 1 < soundListModel.count ? row + 1 : 0;
+        restart();
+        open();
+    }
+
+    function restart() {
+        morphModel.start(soundListModel.soundForRow(fromComboBox.currentIndex),
+                         soundListModel.soundForRow(toComboBox.currentIndex));
+    }
+
+    // Sounds are added at the top of the list: keep the combo boxes on the
+    // same sounds
+    function shiftSelection(count) {
+        fromComboBox.currentIndex += count;
+        toComboBox.currentIndex += count;
+        soundsAdded();
+    }
+
+    MorphModel {
+        id: morphModel
+        onSoundKept: {
+            soundListModel.addNew(sound);
+            root.shiftSelection(1);
+        }
+    }
+
+    ColumnLayout {
+        anchors.fill: parent
+
+        RowLayout {
+            Layout.fillWidth: true
+
+            ComboBox {
+                id: fromComboBox
+                Layout.fillWidth: true
+                model: soundListModel
+                textRole: "text"
+                onActivated: {
+                    restart();
+                }
+            }
+
+            Label {
+                text: qsTr("to")
+            }
+
+            ComboBox {
+                id: toComboBox
+                Layout.fillWidth: true
+                model: soundListModel
+                textRole: "text"
+                onActivated: {
+                    restart();
+                }
+            }
+        }
+
+        ListView {
+            id: stepListView
+            Layout.fillWidth: true
+            Layout.preferredHeight: morphModel.thumbnailSize.height + 2 * cellMargin
+            orientation: ListView.Horizontal
+            clip: true
+            model: morphModel
+            opacity: morphModel.busy ? 0.5 : 1
+
+            delegate: Item {
+                width: morphModel.thumbnailSize.width + 2 * cellMargin
+                height: morphModel.thumbnailSize.height + 2 * cellMargin
+
+                SoundThumbnail {
+                    x: cellMargin
+                    y: cellMargin
+                    width: morphModel.thumbnailSize.width
+                    height: morphModel.thumbnailSize.height
+                    image: model.thumbnail
+
+                    MouseArea {
+                        anchors.fill: parent
+                        onClicked: {
+                            positionSlider.value = model.position;
+                            morphModel.play(model.index, root.soundPlayer);
+                        }
+                    }
+                }
+            }
+
+            ScrollIndicator.horizontal: ScrollIndicator {}
+        }
+
+        Label {
+            Layout.fillWidth: true
+            wrapMode: Text.Wrap
+            text: qsTr("Drag the slider to hear the sounds between the two sounds. Click a step to play it.")
+        }
+
+        Slider {
+            id: positionSlider
+            Layout.fillWidth: true
+            from: 0
+            to: 1
+            onValueChanged: {
+                if (pressed) {
+                    morphModel.playAt(value, root.soundPlayer);
+                }
+            }
+        }
+
+        Item {
+            Layout.fillHeight: true
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+
+            Label {
+                text: qsTr("Intermediate sounds")
+            }
+
+            SpinBox {
+                from: morphModel.minStepCount
+                to: morphModel.maxStepCount
+                value: morphModel.stepCount
+                onValueChanged: {
+                    morphModel.stepCount = value;
+                }
+            }
+
+            Item {
+                Layout.fillWidth: true
+            }
+
+            Button {
+                text: qsTr("Keep this one")
+                onClicked: {
+                    morphModel.keep(positionSlider.value);
+                }
+            }
+
+            Button {
+                text: qsTr("Add all to list")
+                onClicked: {
+                    soundListModel.addMorphs(fromComboBox.currentIndex,
+                                             toComboBox.currentIndex,
+                                             morphModel.stepCount);
+                    root.shiftSelection(morphModel.stepCount);
+                }
+            }
+        }
+    }
+}
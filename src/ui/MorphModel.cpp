@@ -0,0 +1,184 @@
+#include "MorphModel.h"
+
+#include "Parallel.h"
+#include "PreviewImage.h"
+#include "Sound.h"
+#include "SoundMorph.h"
+#include "SoundPlayer.h"
+
+#include <QRunnable>
+#include <QThread>
+
+static constexpr int DEFAULT_STEP_COUNT = 6;
+static constexpr int MIN_STEP_COUNT = 1;
+static constexpr int MAX_STEP_COUNT = 30;
+
+// Size of the thumbnails of the steps, in pixels
+static const QSize THUMBNAIL_SIZE = {96, 48};
+
+class MorphJob : public QRunnable {
+public:
+    MorphJob(MorphModel* model,
+             int jobId,
+             const SoundParams& from,
+             const SoundParams& to,
+             int stepCount)
+            : mModel(model), mJobId(jobId), mFrom(from), mTo(to), mStepCount(stepCount) {
+    }
+
+    void run() override {
+        int jobs = QThread::idealThreadCount();
+        MorphModel::RenderedSteps rendered;
+        rendered.samples = SoundMorph::synthesizeSteps(mFrom, mTo, mStepCount, jobs);
+        rendered.thumbnails.resize(mStepCount);
+        auto* thumbnailData = rendered.thumbnails.data();
+        const auto& samples = rendered.samples;
+        Parallel::forEachIndex(mStepCount, jobs, [thumbnailData, &samples](int index) {
+            thumbnailData[index] = PreviewImage::create(
+                samples.at(index), THUMBNAIL_SIZE.width(), THUMBNAIL_SIZE.height());
+        });
+
+        auto* model = mModel;
+        auto jobId = mJobId;
+        QMetaObject::invokeMethod(
+            model, [model, jobId, rendered] { model->onJobDone(jobId, rendered); },
+            Qt::QueuedConnection);
+    }
+
+private:
+    MorphModel* const mModel;
+    const int mJobId;
+    const SoundParams mFrom;
+    const SoundParams mTo;
+    const int mStepCount;
+};
+
+MorphModel::MorphModel(QObject* parent)
+        : QAbstractListModel(parent), mStepCount(DEFAULT_STEP_COUNT) {
+    // Jobs use all the cores themselves, so run them one at a time
+    mThreadPool.setMaxThreadCount(1);
+}
+
+MorphModel::~MorphModel() {
+    mThreadPool.clear();
+    mThreadPool.waitForDone();
+}
+
+int MorphModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : int(mSteps.size());
+}
+
+QVariant MorphModel::data(const QModelIndex& index, int role) const {
+    int row = index.row();
+    if (row < 0 || row >= rowCount()) {
+        return QVariant();
+    }
+    const auto& step = mSteps.at(row);
+    switch (role) {
+    case ThumbnailRole:
+        return step.thumbnail;
+    case PositionRole:
+        return step.position;
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> MorphModel::roleNames() const {
+    return {
+        {ThumbnailRole, "thumbnail"},
+        {PositionRole, "position"},
+    };
+}
+
+void MorphModel::start(Sound* from, Sound* to) {
+    mFrom = SoundParams::fromSound(from);
+    mTo = SoundParams::fromSound(to);
+    mStarted = true;
+    startJob();
+}
+
+void MorphModel::play(int row, SoundPlayer* player) const {
+    Q_ASSERT(row >= 0 && row < mSamples.size());
+    player->playSamples(mSamples.at(row));
+}
+
+void MorphModel::playAt(qreal position, SoundPlayer* player) const {
+    if (mSamples.isEmpty()) {
+        return;
+    }
+    player->playSamples(SoundMorph::mixSteps(mSamples, position));
+}
+
+void MorphModel::keep(qreal position) {
+    if (!mStarted) {
+        return;
+    }
+    auto* sound = new Sound;
+    SoundMorph::interpolate(mFrom, mTo, position).applyTo(sound);
+    sound->setUnsavedName(tr("Morph %1%").arg(qRound(position * 100)));
+    soundKept(sound);
+}
+
+int MorphModel::stepCount() const {
+    return mStepCount;
+}
+
+void MorphModel::setStepCount(int value) {
+    value = qBound(MIN_STEP_COUNT, value, MAX_STEP_COUNT);
+    if (mStepCount == value) {
+        return;
+    }
+    mStepCount = value;
+    stepCountChanged(value);
+    if (mStarted) {
+        startJob();
+    }
+}
+
+int MorphModel::minStepCount() const {
+    return MIN_STEP_COUNT;
+}
+
+int MorphModel::maxStepCount() const {
+    return MAX_STEP_COUNT;
+}
+
+QSize MorphModel::thumbnailSize() const {
+    return THUMBNAIL_SIZE;
+}
+
+bool MorphModel::isBusy() const {
+    return mBusy;
+}
+
+void MorphModel::startJob() {
+    // Drop the jobs which have not started yet, their results would be
+    // ignored anyway
+    mThreadPool.clear();
+    // The steps include the two sounds
+    mThreadPool.start(new MorphJob(this, ++mLastJobId, mFrom, mTo, mStepCount + 2));
+    if (!mBusy) {
+        mBusy = true;
+        busyChanged(true);
+    }
+}
+
+void MorphModel::onJobDone(int jobId, const RenderedSteps& rendered) {
+    if (jobId != mLastJobId) {
+        return;
+    }
+    int stepCount = rendered.thumbnails.size();
+    beginResetModel();
+    mSteps.clear();
+    for (int idx = 0; idx < stepCount; ++idx) {
+        Step step;
+        step.thumbnail = rendered.thumbnails.at(idx);
+        step.position = SoundMorph::stepPosition(idx, stepCount);
+        mSteps.push_back(step);
+    }
+    mSamples = rendered.samples;
+    endResetModel();
+
+    mBusy = false;
+    busyChanged(false);
+}
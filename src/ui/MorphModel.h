@@ -0,0 +1,118 @@
+#ifndef MORPHMODEL_H
+#define MORPHMODEL_H
+
+#include "SoundParams.h"
+
+#include <QAbstractListModel>
+#include <QImage>
+#include <QSize>
+#include <QThreadPool>
+#include <QVector>
+
+#include <vector>
+
+class Sound;
+class SoundPlayer;
+
+/**
+ * The steps of a morph between two sounds, from the first sound to the second
+ * one, with `stepCount` intermediate sounds between them.
+ *
+ * The steps are synthesized in the background, on all cores, using
+ * SoundMorph. Once they are ready, any position of the morph can be played
+ * instantly by crossfading the two closest steps, so the position can be
+ * scrubbed interactively.
+ */
+class MorphModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(int stepCount READ stepCount WRITE setStepCount NOTIFY stepCountChanged)
+    Q_PROPERTY(int minStepCount READ minStepCount CONSTANT)
+    Q_PROPERTY(int maxStepCount READ maxStepCount CONSTANT)
+    Q_PROPERTY(QSize thumbnailSize READ thumbnailSize CONSTANT)
+    Q_PROPERTY(bool busy READ isBusy NOTIFY busyChanged)
+public:
+    enum Role {
+        ThumbnailRole = Qt::UserRole,
+        PositionRole,
+    };
+
+    explicit MorphModel(QObject* parent = nullptr);
+    ~MorphModel();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * Starts synthesizing the steps of the morph from `from` to `to`
+     */
+    Q_INVOKABLE void start(Sound* from, Sound* to);
+
+    /**
+     * Plays the step at `row` with `player`
+     */
+    Q_INVOKABLE void play(int row, SoundPlayer* player) const;
+
+    /**
+     * Plays the sound at `position`, between 0 and 1, with `player`. Does
+     * nothing until the steps are ready.
+     */
+    Q_INVOKABLE void playAt(qreal position, SoundPlayer* player) const;
+
+    /**
+     * Emits soundKept() with the sound at `position`, between 0 and 1
+     */
+    Q_INVOKABLE void keep(qreal position);
+
+    int stepCount() const;
+    void setStepCount(int value);
+
+    int minStepCount() const;
+    int maxStepCount() const;
+
+    QSize thumbnailSize() const;
+
+    bool isBusy() const;
+
+signals:
+    void stepCountChanged(int stepCount);
+    void busyChanged(bool busy);
+
+    /**
+     * The receiver becomes the owner of `sound`
+     */
+    void soundKept(Sound* sound);
+
+private:
+    friend class MorphJob;
+
+    struct Step {
+        // Shows the crossfaded samples when the wave forms differ, so it is
+        // not the thumbnail ThumbnailRenderer would create for the step
+        QImage thumbnail;
+        qreal position = 0;
+    };
+
+    struct RenderedSteps {
+        QVector<QVector<qreal>> samples;
+        QVector<QImage> thumbnails;
+    };
+
+    void startJob();
+    void onJobDone(int jobId, const RenderedSteps& rendered);
+
+    QThreadPool mThreadPool;
+    int mStepCount;
+    bool mStarted = false;
+    SoundParams mFrom;
+    SoundParams mTo;
+    // Identifies the most recent job: the results of the older ones are
+    // dropped
+    int mLastJobId = 0;
+    bool mBusy = false;
+    std::vector<Step> mSteps;
+    // Samples of the steps, used to play any position instantly
+    QVector<QVector<qreal>> mSamples;
+};
+
+#endif // MORPHMODEL_H
@@ -0,0 +1,74 @@
+#include "PreviewImage.h"
+
+#include <QPainter>
+#include <QPainterPath>
+
+namespace PreviewImage {
+
+static const QColor WAVE_BORDER_COLOR = Qt::white;
+static const QColor WAVE_FILL_COLOR = QColor::fromRgbF(0.6, 0.6, 0.6);
+
+struct MinMax {
+    qreal min = 1;
+    qreal max = -1;
+};
+
+static MinMax computeMinMax(const QVector<qreal>& samples, qreal from, qreal to) {
+    int fromIdx = from * samples.length();
+    int toIdx = to * samples.length();
+    MinMax minMax;
+    for (int idx = fromIdx; idx < toIdx; ++idx) {
+        auto volume = samples[idx];
+        minMax.min = qMin(minMax.min, volume);
+        minMax.max = qMax(minMax.max, volume);
+    }
+    return minMax;
+}
+
+QImage create(const QVector<qreal>& samples, qreal width, qreal height) {
+    int iWidth = int(width);
+    int iHeight = int(height);
+
+    QVector<MinMax> minMaxes(iWidth);
+    for (int x = 0; x < iWidth; ++x) {
+        qreal from = qreal(x) / width;
+        qreal to = qreal(x + 1) / width;
+        minMaxes[x] = computeMinMax(samples, from, to);
+    }
+
+    qreal halfHeight = height / 2;
+
+    QPainterPath path;
+
+    for (int x = 0; x < iWidth; ++x) {
+        qreal y = halfHeight - minMaxes[x].max * halfHeight;
+
+        if (x == 0) {
+            path.moveTo(0, y);
+        } else {
+            path.lineTo(x, y);
+        }
+    }
+
+    // Go backward for min values to form a shape
+    for (int x = iWidth - 1; x >= 0; --x) {
+        qreal y = halfHeight - minMaxes[x].min * halfHeight;
+        path.lineTo(x, y);
+    }
+
+    path.closeSubpath();
+
+    QImage image(iWidth, iHeight, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(WAVE_BORDER_COLOR);
+        painter.setBrush(WAVE_FILL_COLOR);
+        painter.translate(0.5, 0.5);
+        painter.drawPath(path);
+    }
+    return image;
+}
+
+} // namespace PreviewImage
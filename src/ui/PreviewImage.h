@@ -0,0 +1,16 @@
+#ifndef PREVIEWIMAGE_H
+#define PREVIEWIMAGE_H
+
+#include <QImage>
+#include <QVector>
+
+namespace PreviewImage {
+
+/**
+ * Draws the shape of `samples` in an image of size `width` x `height`
+ */
+QImage create(const QVector<qreal>& samples, qreal width, qreal height);
+
+} // namespace PreviewImage
+
+#endif // PREVIEWIMAGE_H
@@ -28,6 +28,7 @@ ColumnLayout {
             }
             text: model.text
             highlighted: model.index === listView.currentIndex
+            leftPadding: thumbnail.width + 2 * innerMargin
 
             onClicked: {
                 if (highlighted) {
@@ -37,6 +38,18 @@ ColumnLayout {
                 }
             }
 
+            SoundThumbnail {
+                id: thumbnail
+                anchors {
+                    left: parent.left
+                    leftMargin: innerMargin
+                    verticalCenter: parent.verticalCenter
+                }
+                height: parent.height - 2 * innerMargin
+                width: height * 2
+                sound: model.sound
+            }
+
             Button {
                 anchors {
                     right: parent.right
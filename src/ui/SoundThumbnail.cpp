@@ -0,0 +1,116 @@
+#include "SoundThumbnail.h"
+
+#include "Sound.h"
+#include "SoundParams.h"
+#include "ThumbnailRenderer.h"
+
+#include <QPainter>
+
+SoundThumbnail::SoundThumbnail(QQuickItem* parent) : QQuickPaintedItem(parent) {
+    setImplicitSize(48, 24);
+    setAntialiasing(true);
+
+    connect(ThumbnailRenderer::instance(),
+            &ThumbnailRenderer::thumbnailReady,
+            this,
+            &SoundThumbnail::onThumbnailReady);
+}
+
+SoundThumbnail::~SoundThumbnail() {
+    cancelPendingRequest();
+}
+
+Sound* SoundThumbnail::sound() const {
+    return mSound;
+}
+
+void SoundThumbnail::setSound(Sound* value) {
+    if (mSound == value) {
+        return;
+    }
+    if (mSound) {
+        disconnect(mSound, nullptr, this, nullptr);
+    }
+    mSound = value;
+    if (mSound) {
+        connect(mSound, &Sound::modified, this, &SoundThumbnail::updateThumbnail);
+    }
+    updateThumbnail();
+    soundChanged(value);
+}
+
+QImage SoundThumbnail::image() const {
+    return mImage;
+}
+
+void SoundThumbnail::setImage(const QImage& value) {
+    if (mImage == value) {
+        return;
+    }
+    mImage = value;
+    updateThumbnail();
+    imageChanged(value);
+}
+
+void SoundThumbnail::paint(QPainter* painter) {
+    QRectF rect = {0, 0, width(), height()};
+    painter->setBrush(Qt::black);
+    painter->setPen(Qt::NoPen);
+    painter->drawRoundedRect(rect, 2, 2);
+    if (!mThumbnail.isNull()) {
+        painter->drawImage(0, 0, mThumbnail);
+    }
+}
+
+void SoundThumbnail::geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) {
+    QQuickPaintedItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        updateThumbnail();
+    }
+}
+
+void SoundThumbnail::updateThumbnail() {
+    cancelPendingRequest();
+    if (!mImage.isNull()) {
+        mThumbnail = mImage;
+        update();
+        return;
+    }
+    QSize size(int(width()), int(height()));
+    if (!mSound || size.isEmpty()) {
+        mThumbnail = QImage();
+        update();
+        return;
+    }
+
+    auto* renderer = ThumbnailRenderer::instance();
+    auto params = SoundParams::fromSound(mSound);
+    auto key = ThumbnailRenderer::key(params, size);
+    QImage thumbnail = renderer->cachedThumbnail(key);
+    if (!thumbnail.isNull()) {
+        mThumbnail = thumbnail;
+        update();
+        return;
+    }
+    // Keep showing the previous thumbnail until the new one is ready
+    mHasPendingRequest = true;
+    mPendingKey = key;
+    renderer->request(key, params, size);
+}
+
+void SoundThumbnail::cancelPendingRequest() {
+    if (!mHasPendingRequest) {
+        return;
+    }
+    ThumbnailRenderer::instance()->cancel(mPendingKey);
+    mHasPendingRequest = false;
+}
+
+void SoundThumbnail::onThumbnailReady(quint64 key) {
+    if (!mHasPendingRequest || key != mPendingKey) {
+        return;
+    }
+    mHasPendingRequest = false;
+    mThumbnail = ThumbnailRenderer::instance()->cachedThumbnail(key);
+    update();
+}
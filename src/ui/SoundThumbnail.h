@@ -0,0 +1,52 @@
+#ifndef SOUNDTHUMBNAIL_H
+#define SOUNDTHUMBNAIL_H
+
+#include <QImage>
+#include <QQuickPaintedItem>
+
+class Sound;
+
+/**
+ * A small preview of a sound, rendered in the background by ThumbnailRenderer.
+ *
+ * If `image` is set, it is shown instead. This is for previews which do not
+ * come from the parameters of a single sound, like crossfaded morph steps.
+ */
+class SoundThumbnail : public QQuickPaintedItem {
+    Q_OBJECT
+
+    Q_PROPERTY(Sound* sound READ sound WRITE setSound NOTIFY soundChanged)
+    Q_PROPERTY(QImage image READ image WRITE setImage NOTIFY imageChanged)
+
+public:
+    explicit SoundThumbnail(QQuickItem* parent = nullptr);
+    ~SoundThumbnail();
+
+    Sound* sound() const;
+    void setSound(Sound* value);
+
+    QImage image() const;
+    void setImage(const QImage& value);
+
+    void paint(QPainter* painter) override;
+
+signals:
+    void soundChanged(Sound* sound);
+    void imageChanged(const QImage& image);
+
+private:
+    void geometryChanged(const QRectF& newGeometry, const QRectF& oldGeometry) override;
+
+private:
+    void updateThumbnail();
+    void cancelPendingRequest();
+    void onThumbnailReady(quint64 key);
+
+    Sound* mSound = nullptr;
+    QImage mImage;
+    QImage mThumbnail;
+    bool mHasPendingRequest = false;
+    quint64 mPendingKey = 0;
+};
+
+#endif // SOUNDTHUMBNAIL_H
@@ -0,0 +1,149 @@
+#include "ThumbnailRenderer.h"
+
+#include "BufferStrategy.h"
+#include "PreviewImage.h"
+#include "RenderCache.h"
+#include "Synthesizer.h"
+
+#include <QCoreApplication>
+#include <QRunnable>
+#include <QThread>
+
+// Maximum size of the thumbnail cache, in bytes
+static constexpr int CACHE_MAX_COST = 32 * 1024 * 1024;
+
+// Thumbnails are small, they do not need the full accuracy of the synthesizer
+static constexpr int THUMBNAIL_OVERSAMPLING = 2;
+
+// Number of samples to synthesize between two checks for cancellation
+static constexpr int SYNTH_CHUNK_LENGTH = 256;
+
+class ThumbnailJob : public QRunnable {
+public:
+    ThumbnailJob(ThumbnailRenderer* renderer,
+                 quint64 key,
+                 quint64 jobId,
+                 const SoundParams& params,
+                 const QSize& size,
+                 const std::shared_ptr<std::atomic_bool>& cancelled)
+            : mRenderer(renderer)
+            , mKey(key)
+            , mJobId(jobId)
+            , mParams(params)
+            , mSize(size)
+            , mCancelled(cancelled) {
+    }
+
+    void run() override {
+        if (*mCancelled) {
+            return;
+        }
+        QVector<qreal> samples;
+        // Sounds played or exported before are in the render cache. Do not
+        // store the thumbnail samples there: they are not accurate enough.
+        auto* cache = RenderCache::instance();
+        if (!cache || !cache->findSamples(mParams, &samples)) {
+            Synthesizer synth;
+            synth.setOversampling(THUMBNAIL_OVERSAMPLING);
+            synth.init(mParams);
+            BufferStrategy strategy(&samples);
+            while (synth.synthSample(SYNTH_CHUNK_LENGTH, &strategy)) {
+                if (*mCancelled) {
+                    return;
+                }
+            }
+        }
+        QImage image = PreviewImage::create(samples, mSize.width(), mSize.height());
+
+        auto* renderer = mRenderer;
+        auto key = mKey;
+        auto jobId = mJobId;
+        QMetaObject::invokeMethod(
+            renderer,
+            [renderer, key, jobId, image] { renderer->onThumbnailRendered(key, jobId, image); },
+            Qt::QueuedConnection);
+    }
+
+private:
+    ThumbnailRenderer* const mRenderer;
+    const quint64 mKey;
+    const quint64 mJobId;
+    const SoundParams mParams;
+    const QSize mSize;
+    const std::shared_ptr<std::atomic_bool> mCancelled;
+};
+
+ThumbnailRenderer::ThumbnailRenderer(QObject* parent) : QObject(parent) {
+    // Leave a core for the UI and the sound player
+    mThreadPool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+    mCache.setMaxCost(CACHE_MAX_COST);
+}
+
+ThumbnailRenderer::~ThumbnailRenderer() {
+    mThreadPool.clear();
+    for (const auto& request : qAsConst(mPendingRequests)) {
+        *request.cancelled = true;
+    }
+    mThreadPool.waitForDone();
+}
+
+ThumbnailRenderer* ThumbnailRenderer::instance() {
+    // Parent the instance to the application, so that it gets deleted while
+    // the application is still alive
+    static ThumbnailRenderer* instance = new ThumbnailRenderer(QCoreApplication::instance());
+    return instance;
+}
+
+quint64 ThumbnailRenderer::key(const SoundParams& params, const QSize& size) {
+    return params.hash() ^ (quint64(size.width()) * 0x9e3779b97f4a7c15ULL)
+           ^ (quint64(size.height()) * 0xc2b2ae3d27d4eb4fULL);
+}
+
+QImage ThumbnailRenderer::cachedThumbnail(quint64 key) const {
+    auto* image = mCache.object(key);
+    return image ? *image : QImage();
+}
+
+void ThumbnailRenderer::request(quint64 key, const SoundParams& params, const QSize& size) {
+    auto& request = mPendingRequests[key];
+    ++request.refCount;
+    if (request.cancelled) {
+        // Already scheduled
+        return;
+    }
+    request.cancelled = std::make_shared<std::atomic_bool>(false);
+    request.jobId = ++mNextJobId;
+    auto* job = new ThumbnailJob(this, key, request.jobId, params, size, request.cancelled);
+    // Higher priorities run first: favor the most recent requests, they come
+    // from the rows which just became visible
+    mThreadPool.start(job, mNextPriority++);
+}
+
+void ThumbnailRenderer::cancel(quint64 key) {
+    auto it = mPendingRequests.find(key);
+    if (it == mPendingRequests.end()) {
+        return;
+    }
+    --it->refCount;
+    if (it->refCount > 0) {
+        return;
+    }
+    *it->cancelled = true;
+    mPendingRequests.erase(it);
+}
+
+void ThumbnailRenderer::insert(quint64 key, const QImage& image) {
+    mCache.insert(key, new QImage(image), image.bytesPerLine() * image.height());
+}
+
+void ThumbnailRenderer::onThumbnailRendered(quint64 key, quint64 jobId, const QImage& image) {
+    insert(key, image);
+    auto it = mPendingRequests.find(key);
+    if (it == mPendingRequests.end() || it->jobId != jobId) {
+        // The request was cancelled. If it was made again, the newer job
+        // notifies its requesters.
+        return;
+    }
+    mPendingRequests.erase(it);
+    thumbnailReady(key);
+}
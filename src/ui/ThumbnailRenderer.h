@@ -0,0 +1,79 @@
+#ifndef THUMBNAILRENDERER_H
+#define THUMBNAILRENDERER_H
+
+#include "SoundParams.h"
+
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <memory>
+
+/**
+ * Renders sound thumbnails in a background thread pool.
+ *
+ * Thumbnails are identified by a key, computed from the sound parameters and
+ * the thumbnail size, and are kept in a cache, so unchanged sounds are never
+ * synthesized twice.
+ *
+ * The most recent requests are rendered first. Requests which are not needed
+ * anymore must be cancelled with cancel().
+ */
+class ThumbnailRenderer : public QObject {
+    Q_OBJECT
+public:
+    explicit ThumbnailRenderer(QObject* parent = nullptr);
+    ~ThumbnailRenderer();
+
+    static ThumbnailRenderer* instance();
+
+    static quint64 key(const SoundParams& params, const QSize& size);
+
+    /**
+     * Returns the thumbnail for `key` if it has already been rendered, a null
+     * image otherwise.
+     */
+    QImage cachedThumbnail(quint64 key) const;
+
+    /**
+     * Schedules the rendering of a thumbnail. thumbnailReady() is emitted when
+     * it is available. Each call must be balanced with a call to cancel() if
+     * the thumbnail is not needed anymore before it is ready.
+     */
+    void request(quint64 key, const SoundParams& params, const QSize& size);
+
+    void cancel(quint64 key);
+
+    /**
+     * Stores a thumbnail rendered by the caller, so that SoundThumbnail items
+     * showing this sound at this size do not render it again
+     */
+    void insert(quint64 key, const QImage& image);
+
+signals:
+    void thumbnailReady(quint64 key);
+
+private:
+    friend class ThumbnailJob;
+
+    struct PendingRequest {
+        std::shared_ptr<std::atomic_bool> cancelled;
+        int refCount = 0;
+        // Identifies the job rendering the thumbnail: a request can be
+        // cancelled and made again while its first job is still running
+        quint64 jobId = 0;
+    };
+
+    void onThumbnailRendered(quint64 key, quint64 jobId, const QImage& image);
+
+    QThreadPool mThreadPool;
+    QCache<quint64, QImage> mCache;
+    QHash<quint64, PendingRequest> mPendingRequests;
+    int mNextPriority = 0;
+    quint64 mNextJobId = 0;
+};
+
+#endif // THUMBNAILRENDERER_H
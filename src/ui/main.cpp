@@ -1,10 +1,15 @@
+#include "BreedingModel.h"
+#include "Commands.h"
+#include "ExportService.h"
 #include "Generator.h"
+#include "MorphModel.h"
 #include "Result.h"
+#include "SimilarSoundFinder.h"
 #include "Sound.h"
-#include "SoundIO.h"
 #include "SoundListModel.h"
 #include "SoundPlayer.h"
 #include "SoundPreview.h"
+#include "SoundThumbnail.h"
 #include "WavSaver.h"
 
 #include <QApplication>
@@ -28,21 +33,12 @@ static QIcon createIcon() {
 
 struct Arguments {
     QUrl url;
-    bool export_ = false;
-    QUrl outputUrl;
-    std::optional<int> outputBits;
-    std::optional<int> outputFrequency;
 
     static optional<Arguments> parse(const QCommandLineParser& parser) {
         Arguments instance;
         auto args = parser.positionalArguments();
-        instance.export_ = parser.isSet("export");
 
         if (args.isEmpty()) {
-            if (instance.export_) {
-                qCritical() << QApplication::translate("main", "No file given to export.");
-                exit(1);
-            }
             return {};
         }
 
@@ -54,38 +50,6 @@ struct Arguments {
 
         instance.url =
             QUrl::fromUserInput(args.first(), QDir::currentPath(), QUrl::AssumeLocalFile);
-
-        if (!instance.export_) {
-            return instance;
-        }
-
-        instance.outputUrl =
-            QUrl::fromUserInput(parser.value("output"), QDir::currentPath(), QUrl::AssumeLocalFile);
-        if (instance.outputUrl.isEmpty()) {
-            auto path = instance.url.path().section('.', 0, -2) + ".wav";
-            instance.outputUrl = QUrl::fromLocalFile(path);
-        }
-
-        if (parser.isSet("bits")) {
-            int outputBits = parser.value("bits").toInt();
-            if (!(outputBits == 8 || outputBits == 16)) {
-                qCritical() << QApplication::translate(
-                    "main", "Invalid bits per sample. Supported values are 8 and 16.");
-                exit(1);
-            }
-            instance.outputBits = outputBits;
-        }
-
-        if (parser.isSet("rate")) {
-            int outputFrequency = parser.value("rate").toInt();
-            if (!(outputFrequency == 22050 || outputFrequency == 44100)) {
-                qCritical() << QApplication::translate(
-                    "main", "Invalid samplerate. Supported values are 22050 and 44100.");
-                exit(1);
-            }
-            instance.outputFrequency = outputFrequency;
-        }
-
         return instance;
     }
 };
@@ -96,57 +60,28 @@ static void registerQmlTypes() {
     qmlRegisterType<Generator>("sfxr", 1, 0, "Generator");
     qmlRegisterType<SoundListModel>("sfxr", 1, 0, "SoundListModel");
     qmlRegisterType<WavSaver>("sfxr", 1, 0, "WavSaver");
+    qmlRegisterType<ExportService>("sfxr", 1, 0, "ExportService");
+    qmlRegisterType<SimilarSoundFinder>("sfxr", 1, 0, "SimilarSoundFinder");
+    qmlRegisterType<BreedingModel>("sfxr", 1, 0, "BreedingModel");
+    qmlRegisterType<MorphModel>("sfxr", 1, 0, "MorphModel");
     qmlRegisterType<SoundPreview>("sfxr", 1, 0, "SoundPreview");
+    qmlRegisterType<SoundThumbnail>("sfxr", 1, 0, "SoundThumbnail");
+    qmlRegisterUncreatableMetaObject(
+        WaveForm::staticMetaObject, "sfxr", 1, 0, "WaveForm", "Only enums");
     WaveForm::registerType();
     Result::registerType();
 }
 
 static void setupCommandLineParser(QCommandLineParser* parser) {
     parser->addHelpOption();
-    parser->addPositionalArgument("sound_file", QApplication::translate("main", "File to load."));
+    parser->addPositionalArgument(
+        "sound_file",
+        QApplication::translate("main", "File to load, or files to export with --export."));
 
     parser->addOption({"export",
                        QApplication::translate(
-                           "main", "Creates a wav file from the given SFXR file and exits.")});
-    parser->addOption(
-        {{"o", "output"},
-         QApplication::translate("main", "Specifies the path for the file created with --export."),
-         "path"});
-    parser->addOption(
-        {{"b", "bits"},
-         QApplication::translate("main",
-                                 "Specifies the bits per sample for the wav file created with "
-                                 "--export. Supported values are 8 and 16."),
-         "number"});
-    parser->addOption(
-        {{"r", "rate"},
-         QApplication::translate("main",
-                                 "Specifies the samplerate for the wav file created with --export. "
-                                 "Supported values are 22050 and 44100."),
-         "number"});
-}
-
-static int exportSound(const Arguments& args) {
-    Sound sound;
-    if (auto res = SoundIO::load(&sound, args.url); !res) {
-        qCritical("%s", qUtf8Printable(res.message()));
-        return 1;
-    }
-
-    WavSaver saver;
-    if (args.outputBits.has_value()) {
-        saver.setBits(args.outputBits.value());
-    }
-
-    if (args.outputFrequency.has_value()) {
-        saver.setFrequency(args.outputFrequency.value());
-    }
-
-    if (!saver.save(&sound, args.outputUrl)) {
-        qCritical("Could not save sound to %s.", qUtf8Printable(args.outputUrl.path()));
-        return 1;
-    }
-    return 0;
+                           "main", "Creates wav files from the given SFXR files and exits.")});
+    Commands::addOptions(parser);
 }
 
 static void loadInitialSound(QQmlApplicationEngine* engine, const QUrl& url) {
@@ -161,15 +96,15 @@ int main(int argc, char* argv[]) {
     setupCommandLineParser(&parser);
     parser.process(*cli.get());
 
-    registerQmlTypes();
-
-    auto maybeArgs = Arguments::parse(parser);
-    if (maybeArgs.has_value() && maybeArgs.value().export_) {
-        return exportSound(maybeArgs.value());
+    if (Commands::isCommandRequested(parser)) {
+        return Commands::run(parser);
     }
 
+    auto maybeArgs = Arguments::parse(parser);
     cli.reset();
 
+    registerQmlTypes();
+
     QApplication app(argc, argv);
     Q_INIT_RESOURCE(qml);
     app.setOrganizationDomain("agateau.com");
@@ -36,6 +36,24 @@ ApplicationWindow {
         }
     }
 
+    BreedingDialog {
+        id: breedingDialog
+        soundPlayer: soundPlayer
+        onSoundKept: {
+            soundListModel.addNew(sound);
+            soundListView.currentIndex = 0;
+        }
+    }
+
+    MorphDialog {
+        id: morphDialog
+        soundPlayer: soundPlayer
+        soundListModel: soundListModel
+        onSoundsAdded: {
+            soundListView.currentIndex = 0;
+        }
+    }
+
     Item {
         id: rootItem
         anchors.fill: parent
@@ -52,6 +70,12 @@ ApplicationWindow {
                 id: generators
                 generator: generator
                 sound: root.sound
+                onBreedRequested: {
+                    breedingDialog.start(root.sound);
+                }
+                onMorphRequested: {
+                    morphDialog.start(soundListView.currentIndex);
+                }
             }
 
             VerticalSpacer {}
@@ -288,6 +312,10 @@ ApplicationWindow {
         FileActions {
             id: fileActions
             sound: root.sound
+            soundListModel: soundListModel
+            onBankLoaded: {
+                soundListView.currentIndex = 0;
+            }
             anchors {
                 right: parent.right
                 top: parent.top
@@ -0,0 +1,85 @@
+#include "BatchGenerator.h"
+#include "SoundUtils.h"
+
+#include <catch2/catch.hpp>
+
+static quint64 hashCandidates(const QVector<BatchGenerator::Candidate>& candidates) {
+    quint64 hash = 0;
+    for (const auto& candidate : candidates) {
+        hash = hash * 31 + candidate.params.hash();
+    }
+    return hash;
+}
+
+TEST_CASE("BatchGenerator") {
+    SECTION("categories") {
+        for (const auto& category : BatchGenerator::categories()) {
+            INFO(category.toStdString());
+            CHECK(BatchGenerator::generateFunction(category) != nullptr);
+        }
+        CHECK(BatchGenerator::generateFunction("unknown") == nullptr);
+    }
+
+    SECTION("constraints") {
+        BatchGenerator::Constraints constraints;
+        SoundFeatures features;
+        features.duration = 0.5;
+        features.peak = 1.2;
+        features.clippedCount = 3;
+        features.spectralCentroid = 2000;
+        CHECK(constraints.accepts(features));
+
+        constraints.minDuration = 0.6;
+        CHECK(!constraints.accepts(features));
+        constraints.minDuration = 0.4;
+        constraints.maxSpectralCentroid = 1500;
+        CHECK(!constraints.accepts(features));
+        constraints.maxSpectralCentroid = 2500;
+        CHECK(constraints.accepts(features));
+        constraints.allowClipping = false;
+        CHECK(!constraints.accepts(features));
+    }
+
+    SECTION("accepted sounds match the constraints") {
+        BatchGenerator::Options options;
+        options.generate = SoundUtils::generateLaser;
+        options.count = 8;
+        options.seed = 12;
+        options.constraints.maxDuration = 0.3;
+        options.constraints.allowClipping = false;
+        int attemptCount;
+        auto candidates = BatchGenerator::run(options, &attemptCount);
+        REQUIRE(candidates.size() == 8);
+        CHECK(attemptCount >= 8);
+        for (const auto& candidate : candidates) {
+            CHECK(candidate.features.duration <= 0.3);
+            CHECK(candidate.features.clippedCount == 0);
+            CHECK(candidate.params.hash()
+                  == BatchGenerator::generate(options.generate, 12, candidate.attempt).hash());
+        }
+    }
+
+    SECTION("results do not depend on the number of jobs") {
+        BatchGenerator::Options options;
+        options.generate = SoundUtils::generateExplosion;
+        options.count = 10;
+        options.seed = 3;
+        options.constraints.minDuration = 0.5;
+        auto expected = hashCandidates(BatchGenerator::run(options));
+        for (int jobs : {2, 5}) {
+            options.jobs = jobs;
+            CHECK(hashCandidates(BatchGenerator::run(options)) == expected);
+        }
+    }
+
+    SECTION("stops after maxAttempts") {
+        BatchGenerator::Options options;
+        options.generate = SoundUtils::generatePickup;
+        options.count = 5;
+        options.maxAttempts = 20;
+        options.constraints.minDuration = 1000;
+        int attemptCount;
+        CHECK(BatchGenerator::run(options, &attemptCount).isEmpty());
+        CHECK(attemptCount == 20);
+    }
+}
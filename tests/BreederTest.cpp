@@ -0,0 +1,80 @@
+#include "Breeder.h"
+#include "Random.h"
+#include "SoundUtils.h"
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+/**
+ * Returns the largest difference between the real parameters of the two
+ * sounds
+ */
+static qreal maxDifference(const SoundParams& params1, const SoundParams& params2) {
+    qreal difference = 0;
+    for (const auto& field : SoundParams::realFields()) {
+        difference = qMax(difference, std::abs(params1.*field.member - params2.*field.member));
+    }
+    return difference;
+}
+
+TEST_CASE("Breeder") {
+    Random random(8);
+    auto laser = SoundUtils::generateLaser(&random);
+    auto explosion = SoundUtils::generateExplosion(&random);
+
+    SECTION("crossover") {
+        auto child = Breeder::crossover(laser, explosion, &random);
+        CHECK((child.waveForm == laser.waveForm || child.waveForm == explosion.waveForm));
+        int fromLaser = 0;
+        int fromExplosion = 0;
+        for (const auto& field : SoundParams::realFields()) {
+            INFO(field.name);
+            auto value = child.*field.member;
+            bool isFromLaser = value == laser.*field.member;
+            bool isFromExplosion = value == explosion.*field.member;
+            CHECK((isFromLaser || isFromExplosion));
+            fromLaser += isFromLaser && !isFromExplosion ? 1 : 0;
+            fromExplosion += isFromExplosion && !isFromLaser ? 1 : 0;
+        }
+        CHECK(fromLaser > 0);
+        CHECK(fromExplosion > 0);
+    }
+
+    SECTION("offspring of a single parent are mutations of it") {
+        auto offspring = Breeder::breed({laser}, Breeder::MIN_OFFSPRING_COUNT, &random);
+        REQUIRE(offspring.size() == Breeder::MIN_OFFSPRING_COUNT);
+        for (const auto& child : offspring) {
+            CHECK(child.waveForm == laser.waveForm);
+            CHECK(child.hash() != laser.hash());
+            CHECK(maxDifference(child, laser) <= 0.0501);
+        }
+    }
+
+    SECTION("offspring of several parents mix them") {
+        auto offspring = Breeder::breed({laser, explosion}, Breeder::MAX_OFFSPRING_COUNT, &random);
+        REQUIRE(offspring.size() == Breeder::MAX_OFFSPRING_COUNT);
+        int mixedCount = 0;
+        for (const auto& child : offspring) {
+            if (maxDifference(child, laser) > 0.0501 && maxDifference(child, explosion) > 0.0501) {
+                ++mixedCount;
+            }
+        }
+        CHECK(mixedCount > 0);
+    }
+
+    SECTION("offspring can be reproduced from the seed") {
+        Random random1(3);
+        Random random2(3);
+        auto offspring1 = Breeder::breed({laser, explosion}, 20, &random1);
+        auto offspring2 = Breeder::breed({laser, explosion}, 20, &random2);
+        REQUIRE(offspring1.size() == offspring2.size());
+        for (int idx = 0; idx < offspring1.size(); ++idx) {
+            CHECK(offspring1.at(idx).hash() == offspring2.at(idx).hash());
+        }
+    }
+
+    SECTION("no parents") {
+        CHECK(Breeder::breed({}, 20, &random).isEmpty());
+    }
+}
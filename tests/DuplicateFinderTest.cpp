@@ -0,0 +1,154 @@
+#include "BufferStrategy.h"
+#include "DuplicateFinder.h"
+#include "Random.h"
+#include "SoundFingerprint.h"
+#include "SoundUtils.h"
+#include "Synthesizer.h"
+
+#include <catch2/catch.hpp>
+
+#include <numeric>
+#include <vector>
+
+/**
+ * Slightly changes all the parameters of `params`, so that the result sounds
+ * almost the same
+ */
+static SoundParams nudge(const SoundParams& params, Random* random) {
+    SoundParams result = params;
+    for (const auto& field : SoundParams::realFields()) {
+        result.*field.member += random->real(0.004) - 0.002;
+    }
+    return result;
+}
+
+/**
+ * Returns the number of sounds which can be removed, by comparing all the
+ * pairs of fingerprints
+ */
+static int countRemovableSounds(const QVector<SoundFingerprint>& fingerprints) {
+    std::vector<int> roots(size_t(fingerprints.size()));
+    std::iota(roots.begin(), roots.end(), 0);
+    auto findRoot = [&roots](int index) {
+        while (roots[index] != index) {
+            index = roots[index];
+        }
+        return index;
+    };
+    for (int idx1 = 0; idx1 < fingerprints.size(); ++idx1) {
+        for (int idx2 = idx1 + 1; idx2 < fingerprints.size(); ++idx2) {
+            if (DuplicateFinder::areDuplicates(fingerprints.at(idx1), fingerprints.at(idx2))) {
+                roots[findRoot(idx2)] = findRoot(idx1);
+            }
+        }
+    }
+    int count = 0;
+    for (int idx = 0; idx < fingerprints.size(); ++idx) {
+        if (findRoot(idx) != idx) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+TEST_CASE("SoundFingerprint") {
+    Random random(3);
+    auto laser = SoundUtils::generateLaser(&random);
+    auto samples = renderSamples(laser);
+    auto fingerprint = SoundFingerprint::fromSamples(samples);
+
+    SECTION("same sound") {
+        CHECK(SoundFingerprint::fromParams(laser).distance(fingerprint) == 0);
+        CHECK(fingerprint.duration == Approx(qreal(samples.size()) / Synthesizer::SAMPLE_RATE));
+    }
+
+    SECTION("the volume does not matter") {
+        for (auto& sample : samples) {
+            sample *= 0.25;
+        }
+        CHECK(SoundFingerprint::fromSamples(samples).distance(fingerprint) <= 2);
+    }
+
+    SECTION("sounds which sound almost the same are close") {
+        auto other = SoundFingerprint::fromParams(nudge(laser, &random));
+        CHECK(other.distance(fingerprint) <= DuplicateFinder::DEFAULT_MAX_DISTANCE);
+    }
+
+    SECTION("different sounds are far") {
+        auto explosion = SoundFingerprint::fromParams(SoundUtils::generateExplosion(&random));
+        CHECK(explosion.distance(fingerprint) > DuplicateFinder::DEFAULT_MAX_DISTANCE);
+    }
+
+    SECTION("empty sound") {
+        auto empty = SoundFingerprint::fromSamples({});
+        CHECK(empty.duration == 0);
+        CHECK(empty.distance(SoundFingerprint()) == 0);
+    }
+}
+
+TEST_CASE("DuplicateFinder") {
+    Random random(5);
+
+    SECTION("clusters") {
+        auto laser = SoundUtils::generateLaser(&random);
+        QVector<SoundFingerprint> fingerprints = {
+            SoundFingerprint::fromParams(laser),
+            SoundFingerprint::fromParams(SoundUtils::generateExplosion(&random)),
+            SoundFingerprint::fromParams(nudge(laser, &random)),
+            SoundFingerprint::fromParams(SoundUtils::generateJump(&random)),
+            SoundFingerprint::fromParams(laser),
+        };
+        auto clusters = DuplicateFinder::findClusters(fingerprints);
+        REQUIRE(clusters.size() == 1);
+        // The two copies of the laser are both the closest to the others: the
+        // first one is kept
+        CHECK(clusters.first().kept == 0);
+        CHECK(clusters.first().dropped == QVector<int>{2, 4});
+    }
+
+    SECTION("near-duplicates have close durations") {
+        SoundFingerprint fingerprint;
+        fingerprint.duration = 1;
+        SoundFingerprint longer = fingerprint;
+        longer.duration = 1.1;
+        CHECK(DuplicateFinder::areDuplicates(fingerprint, longer));
+        longer.duration = 2;
+        CHECK(!DuplicateFinder::areDuplicates(fingerprint, longer));
+        CHECK(DuplicateFinder::findClusters({fingerprint, longer}).isEmpty());
+    }
+
+    SECTION("large buckets of duplicates") {
+        // Silent sounds all share the same fingerprint, and so the same
+        // bucket in all the tables
+        QVector<SoundFingerprint> fingerprints(20000, SoundFingerprint::fromSamples({}));
+        auto clusters = DuplicateFinder::findClusters(fingerprints);
+        REQUIRE(clusters.size() == 1);
+        CHECK(clusters.first().kept == 0);
+        CHECK(clusters.first().dropped.size() == fingerprints.size() - 1);
+    }
+
+    SECTION("hashing finds almost all the duplicates") {
+        const std::vector<SoundParams (*)(Random*)> generateFunctions = {
+            SoundUtils::generatePickup,
+            SoundUtils::generateLaser,
+            SoundUtils::generateExplosion,
+            SoundUtils::generateJump,
+        };
+        QVector<SoundFingerprint> fingerprints;
+        for (int idx = 0; idx < 200; ++idx) {
+            auto params = generateFunctions[idx % generateFunctions.size()](&random);
+            fingerprints << SoundFingerprint::fromParams(params);
+            if (idx % 2 == 0) {
+                fingerprints << SoundFingerprint::fromParams(nudge(params, &random));
+            }
+        }
+        int droppedCount = 0;
+        for (const auto& cluster : DuplicateFinder::findClusters(fingerprints)) {
+            droppedCount += cluster.dropped.size();
+        }
+        int expected = countRemovableSounds(fingerprints);
+        CHECK(expected > 0);
+        CHECK(droppedCount >= expected * 95 / 100);
+        CHECK(droppedCount <= expected);
+    }
+}
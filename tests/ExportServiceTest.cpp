@@ -0,0 +1,86 @@
+#include "ExportService.h"
+#include "SoundParams.h"
+#include "TestUtils.h"
+#include "WavSaver.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <catch2/catch.hpp>
+
+static const QStringList NAMES = {"blip", "missile", "pickup", "power-up", "splash"};
+
+TEST_CASE("ExportService") {
+    WaveForm::registerType();
+    Result::registerType();
+    QTemporaryDir tempDir;
+    WavSaver saver;
+    ExportService service;
+    QSignalSpy finishedSpy(&service, &ExportService::finished);
+    QSignalSpy itemSpy(&service, &ExportService::itemFinished);
+
+    SECTION("exports all the sounds") {
+        for (const auto& name : NAMES) {
+            service.add(saver, loadFixtureParams(name), tempDir.filePath(name + ".wav"));
+        }
+        CHECK(service.isBusy());
+        CHECK(service.totalCount() == NAMES.size());
+        REQUIRE(finishedSpy.wait());
+
+        CHECK(!service.isBusy());
+        CHECK(service.doneCount() == NAMES.size());
+        CHECK(service.failureCount() == 0);
+        REQUIRE(itemSpy.count() == NAMES.size());
+        for (const auto& args : itemSpy) {
+            CHECK(args.at(2).value<Result>());
+        }
+
+        // The exported files are the same as the ones saved synchronously
+        for (const auto& name : NAMES) {
+            QFile file(tempDir.filePath(name + ".wav"));
+            REQUIRE(file.open(QIODevice::ReadOnly));
+            auto expectedPath = tempDir.filePath(name + "-expected.wav");
+            REQUIRE(saver.save(loadFixtureParams(name), expectedPath));
+            QFile expected(expectedPath);
+            REQUIRE(expected.open(QIODevice::ReadOnly));
+            CHECK(file.readAll() == expected.readAll());
+        }
+    }
+
+    SECTION("reports failures") {
+        service.add(saver, loadFixtureParams("blip"), tempDir.filePath("blip.wav"));
+        auto badIndex =
+            service.add(saver, loadFixtureParams("blip"), tempDir.filePath("nodir/blip.wav"));
+        REQUIRE(finishedSpy.wait());
+
+        CHECK(service.failureCount() == 1);
+        REQUIRE(itemSpy.count() == 2);
+        for (const auto& args : itemSpy) {
+            bool ok = args.at(2).value<Result>();
+            CHECK(ok == (args.at(0).toInt() != badIndex));
+        }
+    }
+
+    SECTION("cancelled batches still finish") {
+        for (int idx = 0; idx < 200; ++idx) {
+            service.add(
+                saver, loadFixtureParams("splash"), tempDir.filePath(QString("%1.wav").arg(idx)));
+        }
+        service.cancel();
+        REQUIRE(finishedSpy.wait());
+
+        CHECK(service.doneCount() == service.totalCount());
+        CHECK(itemSpy.count() < 200);
+        CHECK(QDir(tempDir.path()).entryList(QDir::Files).size() == itemSpy.count());
+
+        // The next batch is not cancelled
+        finishedSpy.clear();
+        itemSpy.clear();
+        service.add(saver, loadFixtureParams("blip"), tempDir.filePath("blip.wav"));
+        REQUIRE(finishedSpy.wait());
+        CHECK(service.totalCount() == 1);
+        CHECK(itemSpy.count() == 1);
+    }
+}
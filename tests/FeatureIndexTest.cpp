@@ -0,0 +1,122 @@
+#include "FeatureIndex.h"
+#include "SoundFeatures.h"
+#include "SoundParams.h"
+#include "TestConfig.h"
+#include "TestUtils.h"
+#include "WavReader.h"
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include <catch2/catch.hpp>
+
+static FeatureIndex::Vector fixtureVector(const QString& name) {
+    return FeatureIndex::featureVector(SoundFeatures::fromParams(loadFixtureParams(name)));
+}
+
+TEST_CASE("FeatureIndex") {
+    WaveForm::registerType();
+    QTemporaryDir tempDir;
+    QDir libraryDir(tempDir.filePath("library"));
+    REQUIRE(libraryDir.mkpath("sub"));
+    for (const auto& name : FIXTURE_NAMES) {
+        // Put some sounds in a subdirectory, to check they are found
+        auto dir = name.startsWith('p') ? "sub/" : "";
+        REQUIRE(QFile::copy(fixturePath(name), libraryDir.filePath(dir + name + ".sfxj")));
+    }
+    auto splashPath = libraryDir.filePath("splash.sfxj");
+    auto indexPath = tempDir.filePath("index.sfxi");
+
+    FeatureIndex index;
+    auto paths = FeatureIndex::findSoundFiles(libraryDir.path());
+    REQUIRE(paths.size() == FIXTURE_NAMES.size());
+    CHECK(index.update(paths, 2) == FIXTURE_NAMES.size());
+    REQUIRE(index.count() == FIXTURE_NAMES.size());
+
+    SECTION("a sound is the closest to itself") {
+        auto matches = index.findNearest(fixtureVector("splash"), 3);
+        REQUIRE(matches.size() == 3);
+        CHECK(matches.at(0).path == splashPath);
+        CHECK(matches.at(0).distance == Approx(0).margin(1e-6));
+        CHECK(matches.at(1).distance <= matches.at(2).distance);
+
+        matches = index.findNearest(fixtureVector("splash"), 3, splashPath);
+        CHECK(matches.at(0).path != splashPath);
+
+        CHECK(index.findNearest(fixtureVector("splash"), 100).size() == FIXTURE_NAMES.size());
+    }
+
+    SECTION("the render of a sound is close to the sound") {
+        auto wavPath = QString("%1/synthesizer/expected/splash.wav").arg(TEST_FIXTURES_DIR);
+        QVector<qreal> samples;
+        REQUIRE(WavReader::load(wavPath, &samples));
+        auto vector = FeatureIndex::featureVector(SoundFeatures::fromSamples(samples));
+        auto matches = index.findNearest(vector, 1);
+        REQUIRE(matches.size() == 1);
+        CHECK(matches.at(0).path == splashPath);
+    }
+
+    SECTION("only new and modified files are updated") {
+        REQUIRE(index.save(indexPath));
+        FeatureIndex loaded;
+        REQUIRE(loaded.load(indexPath));
+        REQUIRE(loaded.count() == index.count());
+        for (int idx = 0; idx < index.count(); ++idx) {
+            CHECK(loaded.path(idx) == index.path(idx));
+        }
+        CHECK(loaded.update(paths, 2) == 0);
+
+        // Modify a file, remove another one and add a broken one
+        QFile::remove(splashPath);
+        REQUIRE(QFile::copy(fixturePath("blip"), splashPath));
+        QFile::remove(libraryDir.filePath("triangle.sfxj"));
+        QFile broken(libraryDir.filePath("broken.sfxj"));
+        REQUIRE(broken.open(QIODevice::WriteOnly));
+        broken.write("{");
+        broken.close();
+
+        QStringList errors;
+        CHECK(loaded.update(FeatureIndex::findSoundFiles(libraryDir.path()), 2, &errors) == 2);
+        CHECK(errors.size() == 1);
+        CHECK(loaded.count() == FIXTURE_NAMES.size() - 1);
+        auto matches = loaded.findNearest(fixtureVector("blip"), 2);
+        CHECK(matches.at(0).distance == Approx(0).margin(1e-6));
+        CHECK(matches.at(1).distance == Approx(0).margin(1e-6));
+    }
+
+    SECTION("invalid files") {
+        QFile file(indexPath);
+        REQUIRE(file.open(QIODevice::WriteOnly));
+        file.write("SFXRFIDX");
+        file.close();
+        FeatureIndex loaded;
+        CHECK(!loaded.load(indexPath));
+        CHECK(loaded.count() == 0);
+        CHECK(!loaded.load(tempDir.filePath("missing.sfxi")));
+    }
+}
+
+TEST_CASE("WavReader") {
+    WaveForm::registerType();
+    QTemporaryDir tempDir;
+    auto wavPath = QString("%1/synthesizer/expected/splash.wav").arg(TEST_FIXTURES_DIR);
+    auto data = loadFile(wavPath);
+
+    SECTION("16-bit samples") {
+        QVector<qreal> samples;
+        REQUIRE(WavReader::load(data, &samples));
+        // 44-byte header, then 16-bit samples
+        REQUIRE(samples.size() == (data.size() - 44) / 2);
+        auto expected = qFromLittleEndian<qint16>(data.constData() + 44 + 2 * 1000);
+        CHECK(samples.at(1000) == expected / 32768.0);
+    }
+
+    SECTION("invalid files") {
+        QVector<qreal> samples;
+        CHECK(!WavReader::load(QByteArray("RIFF"), &samples));
+        CHECK(!WavReader::load(data.left(36), &samples));
+        CHECK(!WavReader::load(tempDir.filePath("missing.wav"), &samples));
+    }
+}
@@ -0,0 +1,292 @@
+#include "FlacDecoder.h"
+
+#include <QCryptographicHash>
+
+#include <stdexcept>
+
+namespace {
+
+struct DecodeError : public std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+class BitReader {
+public:
+    explicit BitReader(const QByteArray& data) : mData(data) {
+    }
+
+    quint32 read(int bits) {
+        quint32 value = 0;
+        for (int idx = 0; idx < bits; ++idx) {
+            if (mPos / 8 >= mData.size()) {
+                throw DecodeError("Unexpected end of data");
+            }
+            int bit = (quint8(mData.at(mPos / 8)) >> (7 - mPos % 8)) & 1;
+            value = (value << 1) | bit;
+            ++mPos;
+        }
+        return value;
+    }
+
+    qint32 readSigned(int bits) {
+        quint32 value = read(bits);
+        if (bits < 32 && (value & (quint32(1) << (bits - 1)))) {
+            value |= ~quint32(0) << bits;
+        }
+        return qint32(value);
+    }
+
+    quint32 readUnary() {
+        quint32 zeros = 0;
+        while (read(1) == 0) {
+            ++zeros;
+        }
+        return zeros;
+    }
+
+    qint32 readRice(int parameter) {
+        quint32 folded = (readUnary() << parameter) | read(parameter);
+        return qint32(folded >> 1) ^ -qint32(folded & 1);
+    }
+
+    quint32 readUtf8() {
+        quint32 value = read(8);
+        int extraBytes = 0;
+        for (quint32 mask = 0x80; value & mask; mask >>= 1) {
+            ++extraBytes;
+        }
+        if (extraBytes == 0) {
+            return value;
+        }
+        --extraBytes;
+        value &= 0x7f >> (extraBytes + 1);
+        for (int idx = 0; idx < extraBytes; ++idx) {
+            value = (value << 6) | (read(8) & 0x3f);
+        }
+        return value;
+    }
+
+    void alignToByte() {
+        mPos = (mPos + 7) / 8 * 8;
+    }
+
+    int bytePos() const {
+        return mPos / 8;
+    }
+
+    bool atEnd() const {
+        return mPos / 8 >= mData.size();
+    }
+
+private:
+    const QByteArray& mData;
+    int mPos = 0;
+};
+
+quint8 crc8(const QByteArray& data) {
+    quint8 crc = 0;
+    for (char byte : data) {
+        crc ^= quint8(byte);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x80) ? quint8((crc << 1) ^ 0x07) : quint8(crc << 1);
+        }
+    }
+    return crc;
+}
+
+quint16 crc16(const QByteArray& data) {
+    quint16 crc = 0;
+    for (char byte : data) {
+        crc ^= quint16(quint8(byte) << 8);
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? quint16((crc << 1) ^ 0x8005) : quint16(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void decodeResidual(BitReader* reader, int blockSize, int order, qint32* out) {
+    int method = reader->read(2);
+    if (method > 1) {
+        throw DecodeError("Invalid residual coding method");
+    }
+    int parameterBits = method == 0 ? 4 : 5;
+    int partitionOrder = reader->read(4);
+    int partitionSize = blockSize >> partitionOrder;
+    int idx = order;
+    for (int partition = 0; partition < (1 << partitionOrder); ++partition) {
+        int count = partition == 0 ? partitionSize - order : partitionSize;
+        int parameter = reader->read(parameterBits);
+        if (parameter == (1 << parameterBits) - 1) {
+            int bits = reader->read(5);
+            for (int end = idx + count; idx < end; ++idx) {
+                out[idx] = bits == 0 ? 0 : reader->readSigned(bits);
+            }
+        } else {
+            for (int end = idx + count; idx < end; ++idx) {
+                out[idx] = reader->readRice(parameter);
+            }
+        }
+    }
+}
+
+void decodeSubframe(BitReader* reader, int blockSize, int bits, qint32* out) {
+    if (reader->read(1) != 0) {
+        throw DecodeError("Invalid subframe padding");
+    }
+    int type = reader->read(6);
+    if (reader->read(1) != 0) {
+        throw DecodeError("Wasted bits are not supported");
+    }
+
+    if (type == 0) {
+        qint32 value = reader->readSigned(bits);
+        std::fill(out, out + blockSize, value);
+    } else if (type == 1) {
+        for (int idx = 0; idx < blockSize; ++idx) {
+            out[idx] = reader->readSigned(bits);
+        }
+    } else if (type >= 0b001000 && type <= 0b001100) {
+        int order = type & 0b111;
+        for (int idx = 0; idx < order; ++idx) {
+            out[idx] = reader->readSigned(bits);
+        }
+        decodeResidual(reader, blockSize, order, out);
+        for (int idx = order; idx < blockSize; ++idx) {
+            const qint32* x = out + idx;
+            qint64 prediction = 0;
+            switch (order) {
+            case 1:
+                prediction = x[-1];
+                break;
+            case 2:
+                prediction = 2 * qint64(x[-1]) - x[-2];
+                break;
+            case 3:
+                prediction = 3 * qint64(x[-1]) - 3 * qint64(x[-2]) + x[-3];
+                break;
+            case 4:
+                prediction = 4 * qint64(x[-1]) - 6 * qint64(x[-2]) + 4 * qint64(x[-3]) - x[-4];
+                break;
+            }
+            out[idx] += qint32(prediction);
+        }
+    } else if (type >= 0b100000) {
+        int order = (type & 0b11111) + 1;
+        for (int idx = 0; idx < order; ++idx) {
+            out[idx] = reader->readSigned(bits);
+        }
+        int precision = reader->read(4) + 1;
+        int shift = reader->readSigned(5);
+        QVector<qint32> coefficients;
+        for (int idx = 0; idx < order; ++idx) {
+            coefficients << reader->readSigned(precision);
+        }
+        decodeResidual(reader, blockSize, order, out);
+        for (int idx = order; idx < blockSize; ++idx) {
+            qint64 prediction = 0;
+            for (int coef = 0; coef < order; ++coef) {
+                prediction += qint64(coefficients.at(coef)) * out[idx - 1 - coef];
+            }
+            out[idx] += qint32(prediction >> shift);
+        }
+    } else {
+        throw DecodeError("Invalid subframe type");
+    }
+}
+
+} // namespace
+
+bool FlacDecoder::decode(const QByteArray& data) {
+    mSamples.clear();
+    try {
+        BitReader reader(data);
+        if (reader.read(32) != 0x664c6143) { // "fLaC"
+            throw DecodeError("Invalid marker");
+        }
+
+        bool lastBlock = false;
+        qint64 totalSamples = 0;
+        QByteArray md5;
+        while (!lastBlock) {
+            lastBlock = reader.read(1);
+            int type = reader.read(7);
+            int length = reader.read(24);
+            if (type != 0) {
+                throw DecodeError("Only STREAMINFO is supported");
+            }
+            reader.read(16); // min block size
+            reader.read(16); // max block size
+            reader.read(24); // min frame size
+            reader.read(24); // max frame size
+            mSampleRate = reader.read(20);
+            if (reader.read(3) != 0) {
+                throw DecodeError("Only mono is supported");
+            }
+            mBits = reader.read(5) + 1;
+            totalSamples = (qint64(reader.read(4)) << 32) | reader.read(32);
+            for (int idx = 0; idx < 16; ++idx) {
+                md5.append(char(reader.read(8)));
+            }
+            if (length != 34) {
+                throw DecodeError("Invalid STREAMINFO length");
+            }
+        }
+
+        while (!reader.atEnd()) {
+            int frameStart = reader.bytePos();
+            if (reader.read(14) != 0b11111111111110) {
+                throw DecodeError("Invalid frame sync code");
+            }
+            reader.read(2); // reserved, blocking strategy
+            int blockSizeCode = reader.read(4);
+            reader.read(4); // sample rate, must match STREAMINFO
+            if (reader.read(4) != 0) {
+                throw DecodeError("Only mono is supported");
+            }
+            reader.read(3); // sample size, must match STREAMINFO
+            reader.read(1);
+            reader.readUtf8();
+            int blockSize;
+            if (blockSizeCode == 0b0110) {
+                blockSize = reader.read(8) + 1;
+            } else if (blockSizeCode == 0b0111) {
+                blockSize = reader.read(16) + 1;
+            } else {
+                throw DecodeError("Unsupported block size code");
+            }
+            int crc = reader.read(8);
+            if (crc != crc8(data.mid(frameStart, reader.bytePos() - 1 - frameStart))) {
+                throw DecodeError("Invalid frame header CRC");
+            }
+
+            int offset = mSamples.size();
+            mSamples.resize(offset + blockSize);
+            decodeSubframe(&reader, blockSize, mBits, mSamples.data() + offset);
+            reader.alignToByte();
+            int frameEnd = reader.bytePos();
+            if (reader.read(16) != crc16(data.mid(frameStart, frameEnd - frameStart))) {
+                throw DecodeError("Invalid frame CRC");
+            }
+        }
+
+        if (totalSamples != 0 && totalSamples != mSamples.size()) {
+            throw DecodeError("Wrong sample count");
+        }
+
+        int bytesPerSample = (mBits + 7) / 8;
+        QByteArray pcm;
+        for (qint32 sample : mSamples) {
+            for (int idx = 0; idx < bytesPerSample; ++idx) {
+                pcm.append(char(sample >> (8 * idx)));
+            }
+        }
+        if (QCryptographicHash::hash(pcm, QCryptographicHash::Md5) != md5) {
+            throw DecodeError("Invalid MD5 signature");
+        }
+    } catch (const DecodeError& error) {
+        mErrorString = QString::fromUtf8(error.what());
+        return false;
+    }
+    return true;
+}
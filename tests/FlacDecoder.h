@@ -0,0 +1,45 @@
+#ifndef FLACDECODER_H
+#define FLACDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * A minimal FLAC decoder, to check the output of FlacEncoder.
+ *
+ * Only supports mono files, with the subframe types and residual coding
+ * methods of the format, but no metadata except STREAMINFO. Checks the CRCs
+ * and the MD5 signature.
+ */
+class FlacDecoder {
+public:
+    /**
+     * Decodes `data`. Returns false and sets errorString() on error.
+     */
+    bool decode(const QByteArray& data);
+
+    QString errorString() const {
+        return mErrorString;
+    }
+
+    int bits() const {
+        return mBits;
+    }
+
+    int sampleRate() const {
+        return mSampleRate;
+    }
+
+    const QVector<qint32>& samples() const {
+        return mSamples;
+    }
+
+private:
+    QString mErrorString;
+    int mBits = 0;
+    int mSampleRate = 0;
+    QVector<qint32> mSamples;
+};
+
+#endif // FLACDECODER_H
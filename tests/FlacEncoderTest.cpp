@@ -0,0 +1,127 @@
+#include "FlacDecoder.h"
+#include "FlacEncoder.h"
+#include "SoundParams.h"
+#include "TestUtils.h"
+#include "WavSaver.h"
+
+#include <QBuffer>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+#include <random>
+
+static QVector<qint32> decode(const QByteArray& data) {
+    FlacDecoder decoder;
+    bool ok = decoder.decode(data);
+    INFO(decoder.errorString());
+    REQUIRE(ok);
+    return decoder.samples();
+}
+
+/**
+ * Converts the output of WavSaver in Raw format to the signed samples used by
+ * FLAC
+ */
+static QVector<qint32> fromRaw(const QByteArray& raw, int bits) {
+    QVector<qint32> samples;
+    if (bits == 16) {
+        for (int idx = 0; idx + 1 < raw.size(); idx += 2) {
+            samples << qint16(quint8(raw.at(idx)) | (quint8(raw.at(idx + 1)) << 8));
+        }
+    } else {
+        for (char value : raw) {
+            samples << qint32(quint8(value)) - 128;
+        }
+    }
+    return samples;
+}
+
+TEST_CASE("FlacEncoder") {
+    SECTION("round trip of synthesized sounds") {
+        WaveForm::registerType();
+        auto name = GENERATE(as<QString>(),
+                             "blip",
+                             "missile",
+                             "pickup",
+                             "power-up",
+                             "power-up-sine",
+                             "splash",
+                             "triangle");
+        auto bits = GENERATE(8, 16);
+        int frequency = bits == 8 ? 22050 : 44100;
+        CAPTURE(name, bits);
+
+        auto params = loadFixtureParams(name);
+
+        WavSaver saver;
+        saver.setBits(bits);
+        saver.setFrequency(frequency);
+        QBuffer raw;
+        raw.open(QIODevice::WriteOnly);
+        saver.setFormat(WavSaver::Raw);
+        REQUIRE(saver.save(params, &raw));
+
+        QBuffer flac;
+        flac.open(QIODevice::WriteOnly);
+        saver.setFormat(WavSaver::Flac);
+        qint64 sampleCount;
+        REQUIRE(saver.save(params, &flac, &sampleCount));
+
+        FlacDecoder decoder;
+        REQUIRE(decoder.decode(flac.data()));
+        CHECK(decoder.bits() == bits);
+        CHECK(decoder.sampleRate() == frequency);
+        CHECK(decoder.samples() == fromRaw(raw.data(), bits));
+        CHECK(sampleCount == decoder.samples().size());
+        CHECK(flac.data().size() < raw.data().size());
+    }
+
+    SECTION("round trip of edge cases") {
+        QVector<qint32> samples;
+        SECTION("constant") {
+            samples.fill(-1234, 5000);
+        }
+        SECTION("shorter than the block size") {
+            samples = {1, -2, 3, -4, 5};
+        }
+        SECTION("white noise") {
+            std::mt19937 engine(42);
+            std::uniform_int_distribution<qint32> distribution(-32768, 32767);
+            for (int idx = 0; idx < 20000; ++idx) {
+                samples << distribution(engine);
+            }
+        }
+        SECTION("noise bursts") {
+            // Gives partitions which are escaped, next to Rice coded ones
+            std::mt19937 engine(42);
+            std::uniform_int_distribution<qint32> distribution(-512, 511);
+            for (int idx = 0; idx < 40000; ++idx) {
+                qint32 value = qint32(8000 * std::sin(idx * 0.01));
+                samples << ((idx / 3000) % 2 ? value + distribution(engine) : value);
+            }
+        }
+        SECTION("alternating extremes") {
+            for (int idx = 0; idx < 10000; ++idx) {
+                samples << (idx % 2 ? 32767 : -32768);
+            }
+        }
+        FlacEncoder encoder(16, 44100);
+        CHECK(decode(encoder.encode(samples)) == samples);
+
+        encoder.setBlockSize(16);
+        CHECK(decode(encoder.encode(samples)) == samples);
+    }
+
+    SECTION("multithreaded encoding gives the same result") {
+        QVector<qint32> samples;
+        for (int idx = 0; idx < 50000; ++idx) {
+            samples << qint32(10000 * std::sin(idx * 0.01) * std::cos(idx * 0.0007));
+        }
+        FlacEncoder encoder(16, 44100);
+        auto expected = encoder.encode(samples);
+        encoder.setJobs(4);
+        CHECK(encoder.encode(samples) == expected);
+        CHECK(decode(expected) == samples);
+    }
+}
@@ -0,0 +1,132 @@
+#include "SoundIO.h"
+#include "SoundParams.h"
+#include "TestConfig.h"
+#include "TestUtils.h"
+#include "WavSaver.h"
+#include "sfxr.h"
+
+#include <QBuffer>
+#include <QUrl>
+#include <QtEndian>
+
+#include <catch2/catch.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using ParamsPtr = std::unique_ptr<sfxr_params, decltype(&sfxr_params_free)>;
+using SynthPtr = std::unique_ptr<sfxr_synth, decltype(&sfxr_synth_free)>;
+
+static ParamsPtr loadParams(const QByteArray& data) {
+    ParamsPtr params(sfxr_params_create(), sfxr_params_free);
+    REQUIRE(sfxr_params_load(params.get(), data.constData(), data.size()) == SFXR_OK);
+    return params;
+}
+
+TEST_CASE("libsfxr") {
+    WaveForm::registerType();
+
+    SECTION("renders the same samples as WavSaver") {
+        WavSaver saver;
+        saver.setFormat(WavSaver::Raw);
+        for (const auto& name : FIXTURE_NAMES) {
+            INFO(name.toStdString());
+            auto expectedParams = loadFixtureParams(name);
+            QBuffer expected;
+            expected.open(QIODevice::WriteOnly);
+            REQUIRE(saver.save(expectedParams, &expected));
+
+            auto params = loadParams(loadFile(fixturePath(name)));
+            SynthPtr synth(sfxr_synth_create(params.get()), sfxr_synth_free);
+            REQUIRE(synth);
+            // Render in small blocks, like an audio callback would
+            std::vector<int16_t> samples(sfxr_synth_max_sample_count(synth.get()));
+            size_t count = 0;
+            while (true) {
+                auto blockSize = qMin(size_t(500), samples.size() - count);
+                auto written =
+                    sfxr_synth_render_s16(synth.get(), samples.data() + count, blockSize);
+                if (written == 0) {
+                    break;
+                }
+                count += written;
+            }
+            QByteArray pcm(int(count * 2), Qt::Uninitialized);
+            qToLittleEndian<qint16>(samples.data(), qsizetype(count), pcm.data());
+            CHECK(pcm == expected.data());
+
+            // Once the sound is over, nothing is rendered anymore
+            float value;
+            CHECK(sfxr_synth_render_f32(synth.get(), &value, 1) == 0);
+        }
+    }
+
+    SECTION("float and 16-bit samples match") {
+        auto params = loadParams(loadFile(fixturePath("splash")));
+        SynthPtr synth(sfxr_synth_create(params.get()), sfxr_synth_free);
+        std::vector<float> floatSamples(1000);
+        std::vector<int16_t> intSamples(1000);
+        REQUIRE(sfxr_synth_render_f32(synth.get(), floatSamples.data(), 1000) == 1000);
+        sfxr_synth_reset(synth.get(), params.get());
+        REQUIRE(sfxr_synth_render_s16(synth.get(), intSamples.data(), 1000) == 1000);
+        for (int idx = 0; idx < 1000; ++idx) {
+            CHECK(floatSamples[idx] >= -1);
+            CHECK(floatSamples[idx] <= 1);
+            CHECK(std::abs(int16_t(double(floatSamples[idx]) * 32000) - intSamples[idx]) <= 1);
+        }
+    }
+
+    SECTION("sfxr and sfxj files are loaded like SoundIO does") {
+        for (const char* fileName : {"pickup.sfxr", "pickup.sfxj"}) {
+            INFO(fileName);
+            auto path = QString("%1/%2").arg(TEST_FIXTURES_DIR, fileName);
+            SoundParams expected;
+            REQUIRE(SoundIO::load(&expected, QUrl::fromLocalFile(path)));
+
+            auto params = loadParams(loadFile(path));
+            double value;
+            REQUIRE(sfxr_params_get(params.get(), "waveForm", &value) == SFXR_OK);
+            CHECK(value == expected.waveForm);
+            for (const auto& field : SoundParams::realFields()) {
+                INFO(field.name);
+                REQUIRE(sfxr_params_get(params.get(), field.name, &value) == SFXR_OK);
+                CHECK(value == expected.*field.member);
+            }
+        }
+    }
+
+    SECTION("parameters can be changed") {
+        ParamsPtr params(sfxr_params_create(), sfxr_params_free);
+        CHECK(sfxr_params_set(params.get(), "slide", 0.25) == SFXR_OK);
+        CHECK(sfxr_params_set(params.get(), "waveForm", 3) == SFXR_OK);
+        CHECK(sfxr_params_set(params.get(), "waveForm", 12) == SFXR_ERROR_INVALID_ARGUMENT);
+        CHECK(sfxr_params_set(params.get(), "unknown", 1) == SFXR_ERROR_INVALID_ARGUMENT);
+
+        ParamsPtr clone(sfxr_params_clone(params.get()), sfxr_params_free);
+        CHECK(sfxr_params_set(params.get(), "slide", 0.5) == SFXR_OK);
+        double value;
+        REQUIRE(sfxr_params_get(clone.get(), "slide", &value) == SFXR_OK);
+        CHECK(value == 0.25);
+        REQUIRE(sfxr_params_get(clone.get(), "waveForm", &value) == SFXR_OK);
+        CHECK(value == 3);
+    }
+
+    SECTION("invalid files are rejected") {
+        ParamsPtr params(sfxr_params_create(), sfxr_params_free);
+        sfxr_params_set(params.get(), "slide", 0.5);
+        auto sfxr = loadFile(QString(TEST_FIXTURES_DIR) + "/pickup.sfxr");
+        QByteArray sfxj = R"({"version": 1, "properties": {"slide": 0.1})";
+
+        CHECK(sfxr_params_load(params.get(), sfxr.constData(), sfxr.size() - 1)
+              == SFXR_ERROR_INVALID_DATA);
+        CHECK(sfxr_params_load(params.get(), sfxj.constData(), sfxj.size())
+              == SFXR_ERROR_INVALID_DATA);
+        CHECK(sfxr_params_load(params.get(), "", 0) == SFXR_ERROR_INVALID_DATA);
+        CHECK(sfxr_params_load(nullptr, "", 0) == SFXR_ERROR_INVALID_ARGUMENT);
+
+        double value;
+        REQUIRE(sfxr_params_get(params.get(), "slide", &value) == SFXR_OK);
+        CHECK(value == 0.5);
+    }
+}
@@ -0,0 +1,76 @@
+#include "ParamBank.h"
+#include "Sound.h"
+#include "TestUtils.h"
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("ParamBank") {
+    WaveForm::registerType();
+    QTemporaryDir tempDir;
+    auto path = tempDir.filePath("bank.sfxp");
+
+    SECTION("sounds are stored without loss") {
+        QVector<SoundParams> fixtures;
+        ParamBankWriter writer;
+        for (const auto& name : FIXTURE_NAMES) {
+            auto params = loadFixtureParams(name);
+            fixtures << params;
+            writer.addSound(name, params, {"fixture", name.left(1)});
+        }
+        REQUIRE(writer.write(path));
+
+        ParamBank bank;
+        REQUIRE(bank.open(path));
+        REQUIRE(bank.count() == FIXTURE_NAMES.size());
+        for (int idx = 0; idx < bank.count(); ++idx) {
+            CHECK(bank.name(idx) == FIXTURE_NAMES.at(idx));
+            CHECK(bank.tags(idx) == QStringList({"fixture", FIXTURE_NAMES.at(idx).left(1)}));
+            CHECK(bank.params(idx).hash() == fixtures.at(idx).hash());
+        }
+    }
+
+    SECTION("params can be applied to a sound") {
+        SoundParams params;
+        params.waveForm = WaveForm::Noise;
+        params.slide = -0.25;
+        params.volume = 0.8;
+        Sound sound;
+        params.applyTo(&sound);
+        CHECK(SoundParams::fromSound(&sound).hash() == params.hash());
+    }
+
+    SECTION("sounds without tags") {
+        ParamBankWriter writer;
+        writer.addSound("a", SoundParams());
+        REQUIRE(writer.write(path));
+        ParamBank bank;
+        REQUIRE(bank.open(path));
+        CHECK(bank.tags(0).isEmpty());
+    }
+
+    SECTION("empty bank") {
+        ParamBankWriter writer;
+        REQUIRE(writer.write(path));
+        ParamBank bank;
+        REQUIRE(bank.open(path));
+        CHECK(bank.count() == 0);
+    }
+
+    SECTION("invalid files are rejected") {
+        ParamBankWriter writer;
+        writer.addSound("a", SoundParams());
+        REQUIRE(writer.write(path));
+        auto data = loadFile(path);
+        {
+            QFile file(path);
+            REQUIRE(file.open(QIODevice::WriteOnly));
+            file.write(data.left(data.size() - 1));
+        }
+        ParamBank bank;
+        CHECK(!bank.open(path));
+        CHECK(!bank.open(tempDir.filePath("does-not-exist.sfxp")));
+    }
+}
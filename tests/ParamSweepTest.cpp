@@ -0,0 +1,89 @@
+#include "ParamSweep.h"
+
+#include "ContactSheet.h"
+#include "Random.h"
+#include "SoundUtils.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <vector>
+
+static std::vector<quint32> cellPixels(const ContactSheet& sheet, int column, int row) {
+    int left = ContactSheet::SPACING + column * (ContactSheet::CELL_WIDTH + ContactSheet::SPACING);
+    int top = ContactSheet::SPACING + row * (ContactSheet::CELL_HEIGHT + ContactSheet::SPACING);
+    std::vector<quint32> pixels;
+    for (int y = top; y < top + ContactSheet::CELL_HEIGHT; ++y) {
+        auto begin = sheet.pixels().begin() + y * sheet.width() + left;
+        pixels.insert(pixels.end(), begin, begin + ContactSheet::CELL_WIDTH);
+    }
+    return pixels;
+}
+
+TEST_CASE("ParamSweep::Axis") {
+    ParamSweep::Axis axis{"slide", -0.5, 0.5, 5};
+    CHECK(axis.value(0) == -0.5);
+    CHECK(axis.value(2) == Approx(0));
+    CHECK(axis.value(4) == 0.5);
+
+    SECTION("single step") {
+        axis.steps = 1;
+        CHECK(axis.value(0) == -0.5);
+    }
+}
+
+TEST_CASE("ParamSweep::findField") {
+    CHECK(ParamSweep::findField("slide") == &SoundParams::slide);
+    CHECK(ParamSweep::findField("lpFilterCutoff") == &SoundParams::lpFilterCutoff);
+    CHECK(ParamSweep::findField("waveForm") == nullptr);
+    CHECK(ParamSweep::findField("nothing") == nullptr);
+}
+
+TEST_CASE("ParamSweep::run") {
+    Random random(5);
+    ParamSweep::Options options;
+    options.base = SoundUtils::generateLaser(&random);
+    options.columns = {"slide", -0.5, 0.5, 4};
+    options.rows = ParamSweep::Axis{"lpFilterCutoff", 0.2, 1, 3};
+    options.jobs = 3;
+
+    SECTION("cells") {
+        auto cells = ParamSweep::run(options);
+        REQUIRE(cells.size() == 12);
+        for (int idx = 0; idx < cells.size(); ++idx) {
+            const auto& cell = cells.at(idx);
+            CAPTURE(idx);
+            CHECK(cell.column == idx % 4);
+            CHECK(cell.row == idx / 4);
+            CHECK(cell.params.slide == options.columns.value(cell.column));
+            CHECK(cell.params.lpFilterCutoff == options.rows->value(cell.row));
+            CHECK(cell.params.baseFrequency == options.base.baseFrequency);
+            auto features = SoundFeatures::fromParams(cell.params);
+            CHECK(cell.features.duration == features.duration);
+            CHECK(cell.features.spectralCentroid == features.spectralCentroid);
+        }
+    }
+
+    SECTION("a single axis") {
+        options.rows.reset();
+        auto cells = ParamSweep::run(options);
+        REQUIRE(cells.size() == 4);
+        CHECK(cells.at(3).row == 0);
+        CHECK(cells.at(3).params.lpFilterCutoff == options.base.lpFilterCutoff);
+    }
+
+    SECTION("contact sheet") {
+        ContactSheet sheet(4, 3);
+        CHECK(sheet.width() == 4 * ContactSheet::CELL_WIDTH + 5 * ContactSheet::SPACING);
+        CHECK(sheet.height() == 3 * ContactSheet::CELL_HEIGHT + 4 * ContactSheet::SPACING);
+        ParamSweep::run(options, &sheet);
+        REQUIRE(sheet.pixels().size() == sheet.width() * sheet.height());
+        CHECK(sheet.pixels().first() == ContactSheet::SPACING_COLOR);
+
+        auto first = cellPixels(sheet, 0, 0);
+        CHECK(std::count(first.begin(), first.end(), ContactSheet::WAVE_FORM_COLOR) > 0);
+        CHECK(cellPixels(sheet, 3, 0) != first);
+        CHECK(cellPixels(sheet, 0, 2) != first);
+        CHECK(sheet.toPng().startsWith("\x89PNG"));
+    }
+}
@@ -0,0 +1,78 @@
+#include "PngEncoder.h"
+
+#include <QtEndian>
+
+#include <catch2/catch.hpp>
+
+struct Chunk {
+    QByteArray type;
+    QByteArray content;
+};
+
+static QVector<Chunk> readChunks(const QByteArray& png) {
+    QVector<Chunk> chunks;
+    int pos = 8;
+    while (pos + 12 <= png.size()) {
+        auto length = int(qFromBigEndian<quint32>(png.constData() + pos));
+        Chunk chunk;
+        chunk.type = png.mid(pos + 4, 4);
+        chunk.content = png.mid(pos + 8, length);
+        chunks << chunk;
+        pos += 12 + length;
+    }
+    return chunks;
+}
+
+TEST_CASE("PngEncoder") {
+    // A red, green, blue and white pixel, above two black ones and two gray
+    // ones
+    QVector<quint32> pixels = {
+        0xff0000, 0x00ff00, 0x0000ff, 0xffffff, 0x000000, 0x000000, 0x808080, 0x808080};
+    auto png = PngEncoder::encode(pixels, 4, 2);
+
+    REQUIRE(png.mid(0, 8) == QByteArray("\x89PNG\r\n\x1a\n", 8));
+    auto chunks = readChunks(png);
+    REQUIRE(chunks.size() == 3);
+    CHECK(chunks.at(0).type == QByteArray("IHDR"));
+    CHECK(chunks.at(1).type == QByteArray("IDAT"));
+    CHECK(chunks.at(2).type == QByteArray("IEND"));
+
+    SECTION("header") {
+        const auto& header = chunks.at(0).content;
+        REQUIRE(header.size() == 13);
+        CHECK(qFromBigEndian<quint32>(header.constData()) == 4);
+        CHECK(qFromBigEndian<quint32>(header.constData() + 4) == 2);
+        // 8 bits per channel, RGB
+        CHECK(header.at(8) == 8);
+        CHECK(header.at(9) == 2);
+    }
+
+    SECTION("checksums") {
+        // CRC-32 of "IEND", from the PNG specification
+        CHECK(png.mid(png.size() - 4) == QByteArray("\xae\x42\x60\x82", 4));
+    }
+
+    SECTION("pixels") {
+        // Add the uncompressed size expected by qUncompress()
+        QByteArray compressed(4, '\0');
+        qToBigEndian(quint32(2 * (1 + 4 * 3)), compressed.data());
+        compressed.append(chunks.at(1).content);
+        auto rows = qUncompress(compressed);
+        REQUIRE(rows.size() == 2 * (1 + 4 * 3));
+
+        // Undo the Sub filter of each row
+        for (int y = 0; y < 2; ++y) {
+            const char* row = rows.constData() + y * (1 + 4 * 3);
+            CHECK(row[0] == 1);
+            quint8 previous[3] = {0, 0, 0};
+            for (int x = 0; x < 4; ++x) {
+                quint32 pixel = 0;
+                for (int channel = 0; channel < 3; ++channel) {
+                    previous[channel] = quint8(previous[channel] + row[1 + x * 3 + channel]);
+                    pixel = (pixel << 8) | previous[channel];
+                }
+                CHECK(pixel == pixels.at(y * 4 + x));
+            }
+        }
+    }
+}
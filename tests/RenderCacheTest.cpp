@@ -0,0 +1,141 @@
+#include "BufferStrategy.h"
+#include "RenderCache.h"
+#include "SoundParams.h"
+#include "Synthesizer.h"
+#include "TestUtils.h"
+#include "WavSaver.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <catch2/catch.hpp>
+
+static QByteArray saveToBuffer(const WavSaver& saver, const SoundParams& params) {
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    saver.save(params, &buffer);
+    return buffer.data();
+}
+
+TEST_CASE("RenderCache") {
+    WaveForm::registerType();
+    QTemporaryDir tempDir;
+    RenderCache cache;
+    REQUIRE(cache.open(tempDir.path()));
+    auto params = loadFixtureParams("splash");
+
+    SECTION("find returns inserted entries") {
+        auto key = RenderCache::key(params, 16, 44100);
+        QByteArray pcm;
+        CHECK(!cache.find(key, &pcm));
+        cache.insert(key, "abcd");
+        REQUIRE(cache.find(key, &pcm));
+        CHECK(pcm == "abcd");
+        CHECK(!cache.find(RenderCache::key(params, 8, 44100), &pcm));
+
+        // Entries persist across runs
+        RenderCache cache2;
+        REQUIRE(cache2.open(tempDir.path()));
+        CHECK(cache2.size() == cache.size());
+        REQUIRE(cache2.find(key, &pcm));
+        CHECK(pcm == "abcd");
+    }
+
+    SECTION("cached renders are identical to uncached ones") {
+        for (auto format : {WavSaver::Wav, WavSaver::Raw, WavSaver::Flac}) {
+            for (int bits : {8, 16}) {
+                WavSaver saver;
+                saver.setFormat(format);
+                saver.setBits(bits);
+                saver.setFrequency(bits == 8 ? 22050 : 44100);
+                auto expected = saveToBuffer(saver, params);
+
+                saver.setRenderCache(&cache);
+                // First call fills the cache, second one uses it
+                CHECK(saveToBuffer(saver, params) == expected);
+                CHECK(saveToBuffer(saver, params) == expected);
+            }
+        }
+    }
+
+    SECTION("the saver uses the cached samples") {
+        WavSaver saver;
+        saver.setFormat(WavSaver::Raw);
+        saver.setRenderCache(&cache);
+        cache.insert(RenderCache::key(params, saver.bits(), saver.frequency()), "abcd");
+        CHECK(saveToBuffer(saver, params) == "abcd");
+    }
+
+    SECTION("samples round-trip through the cache") {
+        QVector<qreal> samples;
+        BufferStrategy strategy(&samples);
+        Synthesizer synth;
+        synth.init(params);
+        while (synth.synthSample(256, &strategy)) {
+        }
+        cache.insertSamples(params, samples);
+
+        QVector<qreal> cachedSamples;
+        REQUIRE(cache.findSamples(params, &cachedSamples));
+        REQUIRE(cachedSamples.size() == samples.size());
+        for (int idx = 0; idx < samples.size(); ++idx) {
+            REQUIRE(std::abs(cachedSamples.at(idx) - samples.at(idx)) < 1. / 16000);
+        }
+
+        // It is the entry a saver with the default settings uses
+        WavSaver saver;
+        saver.setFormat(WavSaver::Raw);
+        auto expected = saveToBuffer(saver, params);
+        saver.setRenderCache(&cache);
+        CHECK(saveToBuffer(saver, params) == expected);
+    }
+
+    SECTION("least recently used entries are evicted") {
+        QByteArray pcm(1000, 'x');
+        RenderCache smallCache;
+        REQUIRE(smallCache.open(tempDir.path(), 3500));
+        for (const char* key : {"a", "b", "c"}) {
+            smallCache.insert(key, pcm);
+            // Let the modification times differ
+            QThread::msleep(20);
+        }
+        QByteArray found;
+        REQUIRE(smallCache.find("a", &found));
+        QThread::msleep(20);
+        smallCache.insert("d", pcm);
+
+        CHECK(smallCache.size() <= 3500);
+        CHECK(smallCache.find("a", &found));
+        CHECK(!smallCache.find("b", &found));
+        CHECK(smallCache.find("d", &found));
+    }
+
+    SECTION("renders of other engine versions are removed") {
+        QDir dir(tempDir.path());
+        REQUIRE(dir.mkpath("engine-0"));
+        QFile oldEntry(dir.filePath("engine-0/old.pcm"));
+        REQUIRE(oldEntry.open(QIODevice::WriteOnly));
+        oldEntry.close();
+
+        RenderCache cache2;
+        REQUIRE(cache2.open(tempDir.path()));
+        CHECK(!dir.exists("engine-0"));
+        CHECK(dir.exists(QString("engine-%1").arg(Synthesizer::VERSION)));
+    }
+
+    SECTION("corrupted entries are ignored") {
+        cache.insert("a", "abcd");
+        auto path = QString("%1/engine-%2/a.pcm").arg(tempDir.path()).arg(Synthesizer::VERSION);
+        QFile file(path);
+        REQUIRE(file.open(QIODevice::ReadWrite));
+        REQUIRE(file.resize(file.size() - 1));
+        file.close();
+
+        QByteArray pcm;
+        CHECK(!cache.find("a", &pcm));
+        CHECK(!QFile::exists(path));
+    }
+}
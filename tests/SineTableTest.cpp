@@ -0,0 +1,70 @@
+#include "BufferStrategy.h"
+#include "SineTable.h"
+#include "SoundParams.h"
+#include "Synthesizer.h"
+#include "TestUtils.h"
+
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+static const qreal PI = 3.14159265358979323846;
+
+TEST_CASE("SineTable") {
+    const auto& table = SineTable::instance();
+
+    SECTION("values are close to the libm ones") {
+        // Below the resolution of 16-bit samples
+        CHECK(table.maxError(100000) < 5e-6);
+    }
+
+    SECTION("exact values") {
+        CHECK(table.sin(0) == 0);
+        CHECK(table.sinTurns(0.25) == Approx(1));
+        CHECK(table.sinTurns(0.75) == Approx(-1));
+    }
+
+    SECTION("values outside of the first period") {
+        for (qreal x : {-PI / 3, -10.0, 7 * PI / 4, 1000.5}) {
+            INFO(x);
+            CHECK(std::abs(table.sin(x) - std::sin(x)) < 1e-5);
+        }
+    }
+}
+
+// Hidden by default, run with `tests [benchmark]`
+TEST_CASE("SineTable performance", "[.][benchmark]") {
+    WaveForm::registerType();
+    const auto& table = SineTable::instance();
+    WARN("Maximum error: " << table.maxError(1000000));
+
+    BENCHMARK("libm sin()") {
+        qreal sum = 0;
+        for (int idx = 0; idx < 10000; ++idx) {
+            sum += std::sin(idx * 0.001);
+        }
+        return sum;
+    };
+    BENCHMARK("SineTable::sin()") {
+        qreal sum = 0;
+        for (int idx = 0; idx < 10000; ++idx) {
+            sum += table.sin(idx * 0.001);
+        }
+        return sum;
+    };
+
+    for (const char* name : {"power-up-sine", "splash"}) {
+        auto params = loadFixtureParams(name);
+        QVector<qreal> samples;
+        BENCHMARK(std::string("render ") + name) {
+            samples.clear();
+            BufferStrategy strategy(&samples);
+            Synthesizer synth;
+            synth.init(params);
+            while (synth.synthSample(4096, &strategy)) {
+            }
+            return samples.size();
+        };
+    }
+}
@@ -0,0 +1,110 @@
+#include "SoundBank.h"
+#include "TestUtils.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include <catch2/catch.hpp>
+
+#include <cmath>
+
+static QVector<qint16> createSine(int size, qreal step) {
+    QVector<qint16> samples;
+    for (int idx = 0; idx < size; ++idx) {
+        samples << qint16(20000 * std::sin(idx * step));
+    }
+    return samples;
+}
+
+TEST_CASE("SoundBank") {
+    QTemporaryDir tempDir;
+    auto path = tempDir.filePath("bank.sfxrbank");
+
+    QVector<QVector<qint16>> sounds;
+    for (int idx = 0; idx < 100; ++idx) {
+        sounds << createSine(idx * 37 % 500, 0.01 * (1 + idx % 7));
+    }
+
+    SECTION("pcm16 samples are read in place") {
+        SoundBankWriter writer(SoundBank::Pcm16, 22050);
+        for (int idx = 0; idx < sounds.size(); ++idx) {
+            REQUIRE(writer.addSound(QString("sound-%1").arg(idx), sounds.at(idx)));
+        }
+        REQUIRE(writer.write(path));
+
+        SoundBank bank;
+        REQUIRE(bank.open(path));
+        CHECK(bank.encoding() == SoundBank::Pcm16);
+        CHECK(bank.sampleRate() == 22050);
+        REQUIRE(bank.count() == sounds.size());
+        for (int idx = 0; idx < sounds.size(); ++idx) {
+            auto name = QString("sound-%1").arg(idx);
+            REQUIRE(bank.indexOf(name) == idx);
+            CHECK(bank.name(idx) == name);
+            auto samples = bank.samples(name);
+            CHECK(quintptr(samples.data) % SoundBank::DATA_ALIGNMENT == 0);
+            CHECK(QVector<qint16>(samples.data, samples.data + samples.size) == sounds.at(idx));
+        }
+        CHECK(bank.indexOf("missing") == -1);
+        CHECK(bank.samples("missing").data == nullptr);
+    }
+
+    SECTION("adpcm samples are close to the originals") {
+        SoundBankWriter writer(SoundBank::ImaAdpcm, 44100);
+        for (int idx = 0; idx < sounds.size(); ++idx) {
+            REQUIRE(writer.addSound(QString("sound-%1").arg(idx), sounds.at(idx)));
+        }
+        REQUIRE(writer.write(path));
+        // 4 bits per sample, plus the index: less than a byte per sample
+        int totalSampleCount = 0;
+        for (const auto& sound : sounds) {
+            totalSampleCount += sound.size();
+        }
+        CHECK(QFileInfo(path).size() < totalSampleCount);
+
+        SoundBank bank;
+        REQUIRE(bank.open(path));
+        CHECK(bank.encoding() == SoundBank::ImaAdpcm);
+        for (int idx = 0; idx < sounds.size(); ++idx) {
+            const auto& expected = sounds.at(idx);
+            REQUIRE(bank.sampleCount(idx) == expected.size());
+            QVector<qint16> samples(expected.size());
+            bank.decode(idx, samples.data());
+            // Skip the first samples, while the step size adapts
+            for (int sampleIdx = 16; sampleIdx < expected.size(); ++sampleIdx) {
+                REQUIRE(std::abs(samples.at(sampleIdx) - expected.at(sampleIdx)) < 500);
+            }
+        }
+    }
+
+    SECTION("names must be unique") {
+        SoundBankWriter writer(SoundBank::Pcm16, 44100);
+        CHECK(writer.addSound("a", sounds.at(1)));
+        CHECK(!writer.addSound("a", sounds.at(2)));
+    }
+
+    SECTION("empty bank") {
+        SoundBankWriter writer(SoundBank::Pcm16, 44100);
+        REQUIRE(writer.write(path));
+        SoundBank bank;
+        REQUIRE(bank.open(path));
+        CHECK(bank.count() == 0);
+        CHECK(bank.indexOf("a") == -1);
+    }
+
+    SECTION("invalid files are rejected") {
+        SoundBankWriter writer(SoundBank::Pcm16, 44100);
+        writer.addSound("a", sounds.at(1));
+        REQUIRE(writer.write(path));
+        auto data = loadFile(path);
+        {
+            QFile file(path);
+            REQUIRE(file.open(QIODevice::WriteOnly));
+            file.write(data.left(data.size() - 1));
+        }
+        SoundBank bank;
+        CHECK(!bank.open(path));
+        CHECK(!bank.open(tempDir.filePath("does-not-exist")));
+    }
+}
@@ -0,0 +1,105 @@
+#include "BufferStrategy.h"
+#include "SoundFeatures.h"
+#include "SoundParams.h"
+#include "Spectrum.h"
+#include "Synthesizer.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+static const qreal PI = 3.14159265358979323846;
+
+static QVector<qreal> createSine(qreal frequency, qreal amplitude, int count) {
+    QVector<qreal> samples(count);
+    for (int idx = 0; idx < count; ++idx) {
+        samples[idx] = amplitude * std::sin(2 * PI * frequency * idx / Synthesizer::SAMPLE_RATE);
+    }
+    return samples;
+}
+
+TEST_CASE("Spectrum") {
+    SECTION("the peak is in the bin of the frequency") {
+        auto samples = createSine(Spectrum::binFrequency(40, Synthesizer::SAMPLE_RATE), 1, 1024);
+        std::array<qreal, Spectrum::BIN_COUNT> magnitudes;
+        Spectrum::computeMagnitudes(samples.constData(), samples.size(), magnitudes.data());
+        auto it = std::max_element(magnitudes.begin(), magnitudes.end());
+        CHECK(it - magnitudes.begin() == 40);
+    }
+
+    SECTION("missing samples are zeros") {
+        std::array<qreal, Spectrum::BIN_COUNT> magnitudes;
+        qreal sample = 0;
+        Spectrum::computeMagnitudes(&sample, 1, magnitudes.data());
+        CHECK(*std::max_element(magnitudes.begin(), magnitudes.end()) == 0);
+    }
+}
+
+TEST_CASE("SoundFeatures") {
+    SECTION("features of a sine") {
+        auto samples = createSine(1000, 0.5, Synthesizer::SAMPLE_RATE / 2);
+        auto features = SoundFeatures::fromSamples(samples);
+        CHECK(features.duration == Approx(0.5));
+        CHECK(features.peak == Approx(0.5).epsilon(0.001));
+        CHECK(features.rms == Approx(0.5 / std::sqrt(2)).epsilon(0.001));
+        CHECK(features.clippedCount == 0);
+        CHECK(features.spectralCentroid == Approx(1000).epsilon(0.01));
+    }
+
+    SECTION("envelopes and pitch of a sine") {
+        auto samples = createSine(1000, 0.5, Synthesizer::SAMPLE_RATE / 2);
+        auto features = SoundFeatures::fromSamples(samples);
+        CHECK(features.spectralRolloff == Approx(1000).epsilon(0.05));
+        for (int slice = 0; slice < SoundFeatures::SLICE_COUNT; ++slice) {
+            INFO(slice);
+            CHECK(features.rmsEnvelope[slice] == Approx(0.5 / std::sqrt(2)).epsilon(0.01));
+            CHECK(features.peakEnvelope[slice] == Approx(0.5).epsilon(0.01));
+            CHECK(features.pitchTrajectory[slice] == Approx(1000).epsilon(0.01));
+        }
+    }
+
+    SECTION("silent slices have no pitch") {
+        auto samples = createSine(440, 0.5, Synthesizer::SAMPLE_RATE / 2);
+        std::fill(samples.begin() + samples.size() / 2, samples.end(), 0);
+        auto features = SoundFeatures::fromSamples(samples);
+        CHECK(features.pitchTrajectory.front() == Approx(440).epsilon(0.02));
+        CHECK(features.pitchTrajectory.back() == 0);
+        CHECK(features.rmsEnvelope.back() == 0);
+    }
+
+    SECTION("clipped samples are counted") {
+        QVector<qreal> samples = {0.5, 1.5, -2, 1};
+        auto features = SoundFeatures::fromSamples(samples);
+        CHECK(features.peak == 2);
+        CHECK(features.clippedCount == 2);
+    }
+
+    SECTION("silence") {
+        auto features = SoundFeatures::fromSamples(QVector<qreal>(100, 0.));
+        CHECK(features.peak == 0);
+        CHECK(features.spectralCentroid == 0);
+        CHECK(features.spectralRolloff == 0);
+        CHECK(SoundFeatures::fromSamples({}).duration == 0);
+    }
+
+    SECTION("features of synthesized sounds") {
+        SoundParams params;
+        Synthesizer synth;
+        synth.init(params);
+        auto features = SoundFeatures::fromParams(params);
+        CHECK(features.duration * Synthesizer::SAMPLE_RATE == Approx(synth.maxSampleCount()));
+        CHECK(Synthesizer::maxSampleCount(params) == synth.maxSampleCount());
+        CHECK(features.peak > 0);
+
+        // Capped renders are the start of the full render
+        auto samples = renderSamples(params);
+        CHECK(renderSamples(params, 5000) == samples.mid(0, 5000));
+
+        // A higher frequency sounds brighter
+        auto highParams = params;
+        highParams.baseFrequency = 0.6;
+        CHECK(SoundFeatures::fromParams(highParams).spectralCentroid > features.spectralCentroid);
+    }
+}
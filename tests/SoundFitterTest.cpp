@@ -0,0 +1,67 @@
+#include "SoundFitter.h"
+
+#include "BufferStrategy.h"
+#include "Random.h"
+#include "SoundUtils.h"
+#include "Spectrum.h"
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("SoundFitter::Spectrogram") {
+    Random random(4);
+    auto laser = SoundFitter::Spectrogram::fromSamples(
+        renderSamples(SoundUtils::generateLaser(&random)));
+    auto jump =
+        SoundFitter::Spectrogram::fromSamples(renderSamples(SoundUtils::generateJump(&random)));
+
+    SECTION("a sound is at distance 0 of itself") {
+        CHECK(laser.distance(laser) == 0);
+    }
+
+    SECTION("different sounds are apart") {
+        CHECK(laser.distance(jump) > 5);
+        CHECK(laser.distance(jump) == Approx(jump.distance(laser)));
+    }
+
+    SECTION("missing frames count as silence") {
+        SoundFitter::Spectrogram empty;
+        CHECK(empty.frameCount() == 0);
+        CHECK(empty.distance(empty) == 0);
+        auto silence = SoundFitter::Spectrogram::fromSamples(
+            QVector<qreal>(laser.frameCount() * Spectrum::FRAME_SIZE, 0.));
+        CHECK(silence.frameCount() == laser.frameCount());
+        CHECK(empty.distance(laser) == Approx(silence.distance(laser)));
+    }
+}
+
+TEST_CASE("SoundFitter::fit") {
+    Random random(2);
+    auto params = SoundUtils::generateLaser(&random);
+    auto target = renderSamples(params);
+    auto targetSpectrogram = SoundFitter::Spectrogram::fromSamples(target);
+
+    SoundFitter::Options options;
+    options.maxEvaluations = 400;
+    options.populationSize = 24;
+    options.seed = 1;
+    QVector<qreal> distances;
+    options.progress = [&distances](int, qreal distance) { distances << distance; };
+    auto fit = SoundFitter::fit(target, options);
+
+    SECTION("gets closer to the target") {
+        CHECK(fit.evaluationCount == options.maxEvaluations);
+        REQUIRE(distances.size() >= 2);
+        CHECK(fit.distance < distances.first());
+        auto fitSpectrogram = SoundFitter::Spectrogram::fromSamples(renderSamples(fit.params));
+        CHECK(fitSpectrogram.distance(targetSpectrogram) == Approx(fit.distance));
+        auto defaultSpectrogram = SoundFitter::Spectrogram::fromSamples(renderSamples({}));
+        CHECK(fit.distance < defaultSpectrogram.distance(targetSpectrogram));
+    }
+
+    SECTION("does not depend on the number of jobs") {
+        options.jobs = 3;
+        auto fit2 = SoundFitter::fit(target, options);
+        CHECK(fit2.params.hash() == fit.params.hash());
+        CHECK(fit2.distance == fit.distance);
+    }
+}
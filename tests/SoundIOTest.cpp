@@ -0,0 +1,165 @@
+#include "Sound.h"
+#include "SoundIO.h"
+#include "SoundParams.h"
+#include "Synthesizer.h"
+#include "TestConfig.h"
+#include "TestUtils.h"
+
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QUrl>
+
+#include <catch2/catch.hpp>
+
+/**
+ * The loader used before the fast parser: a JSON document, then one
+ * setProperty() call per property
+ */
+static void legacyLoadSfxj(Sound* sound, const QString& path) {
+    QFile file(path);
+    file.open(QIODevice::ReadOnly);
+    auto root = QJsonDocument::fromJson(file.readAll()).object();
+    auto props = root["properties"].toObject();
+    for (auto it = props.constBegin(), end = props.constEnd(); it != end; ++it) {
+        sound->setProperty(it.key().toUtf8(), it.value().toVariant());
+    }
+}
+
+TEST_CASE("SoundIO") {
+    WaveForm::registerType();
+
+    SECTION("sfxj files are loaded like the JSON document loader did") {
+        for (const auto& name : FIXTURE_NAMES) {
+            auto path = fixturePath(name);
+            Sound sound;
+            legacyLoadSfxj(&sound, path);
+
+            SoundParams params;
+            REQUIRE(SoundIO::loadSfxj(&params, loadFile(path)));
+            INFO(name.toStdString());
+            CHECK(params.hash() == SoundParams::fromSound(&sound).hash());
+        }
+    }
+
+    SECTION("all properties are loaded") {
+        QJsonObject props;
+        int idx = 0;
+        for (const auto& field : SoundParams::realFields()) {
+            props[field.name] = 0.01 + 0.03 * idx++;
+        }
+        props["waveForm"] = "Noise";
+        props["name"] = "ignored";
+        QJsonObject root;
+        root["version"] = 1;
+        root["properties"] = props;
+
+        SoundParams params;
+        REQUIRE(SoundIO::loadSfxj(&params, QJsonDocument(root).toJson()));
+        CHECK(params.waveForm == WaveForm::Noise);
+        idx = 0;
+        for (const auto& field : SoundParams::realFields()) {
+            INFO(field.name);
+            CHECK(params.*field.member == 0.01 + 0.03 * idx++);
+        }
+    }
+
+    SECTION("unusual sfxj files are loaded too") {
+        QByteArray json = R"({
+            "version": 1,
+            "extra": {"a": [1, 2]},
+            "properties": {"slide": 0.25, "waveForm": 2}
+        })";
+        SoundParams params;
+        REQUIRE(SoundIO::loadSfxj(&params, json));
+        CHECK(params.slide == 0.25);
+        CHECK(params.waveForm == WaveForm::Sine);
+    }
+
+    SECTION("invalid sfxj files are rejected") {
+        SoundParams params;
+        params.slide = 0.5;
+        CHECK(!SoundIO::loadSfxj(&params, R"({"properties": {"slide": 0.1}})"));
+        CHECK(!SoundIO::loadSfxj(&params, R"({"version": 2, "properties": {"slide": 0.1}})"));
+        CHECK(!SoundIO::loadSfxj(&params, R"({"version": 1, "properties": {"slide": 0.1})"));
+        CHECK(params.slide == 0.5);
+    }
+
+    SECTION("envelope times are clamped") {
+        QByteArray json = R"({"version": 1, "properties": {"attackTime": 100, "decayTime": -1e9}})";
+        // The fast parser does not handle escape sequences, this uses the
+        // JSON document loader
+        QByteArray escapedJson =
+            R"({"version": 1, "na\u006de": "x", "properties": {"sustainTime": 1e300}})";
+        SoundParams params;
+        REQUIRE(SoundIO::loadSfxj(&params, json));
+        REQUIRE(SoundIO::loadSfxj(&params, escapedJson));
+        CHECK(params.attackTime == SoundParams::MAX_ENVELOPE_TIME);
+        CHECK(params.sustainTime == SoundParams::MAX_ENVELOPE_TIME);
+        CHECK(params.decayTime == -SoundParams::MAX_ENVELOPE_TIME);
+        CHECK(Synthesizer::maxSampleCount(params) == Synthesizer::MAX_SAMPLE_COUNT);
+    }
+
+    SECTION("truncated sfxr files are rejected") {
+        auto data = loadFile(QString(TEST_FIXTURES_DIR) + "/pickup.sfxr");
+        SoundParams params;
+        REQUIRE(SoundIO::loadSfxr(&params, data));
+        CHECK(params.baseFrequency == Approx(0.5019));
+
+        SoundParams truncatedParams;
+        CHECK(!SoundIO::loadSfxr(&truncatedParams, data.left(data.size() - 1)));
+        CHECK(!SoundIO::loadSfxr(&truncatedParams, QByteArray()));
+        CHECK(truncatedParams.hash() == SoundParams().hash());
+    }
+}
+
+// Hidden by default, run with `tests [benchmark]`. Each run loads all the
+// files of the corpus: loads per second are CORPUS_SIZE divided by the mean
+// time. Set SFXR_BENCHMARK_DIR to measure the performance on a specific
+// storage.
+TEST_CASE("SoundIO load throughput", "[.][benchmark]") {
+    static constexpr int CORPUS_SIZE = 10000;
+    WaveForm::registerType();
+    QTemporaryDir tempDir(qEnvironmentVariable("SFXR_BENCHMARK_DIR", QDir::tempPath())
+                          + "/sfxr-benchmark-XXXXXX");
+    REQUIRE(tempDir.isValid());
+
+    QStringList sfxjPaths;
+    QStringList sfxrPaths;
+    auto sfxrPath = QString(TEST_FIXTURES_DIR) + "/pickup.sfxr";
+    for (int idx = 0; idx < CORPUS_SIZE; ++idx) {
+        auto path = tempDir.filePath(QString::number(idx));
+        REQUIRE(QFile::copy(fixturePath(FIXTURE_NAMES.at(idx % FIXTURE_NAMES.size())),
+                            path + ".sfxj"));
+        REQUIRE(QFile::copy(sfxrPath, path + ".sfxr"));
+        sfxjPaths << path + ".sfxj";
+        sfxrPaths << path + ".sfxr";
+    }
+
+    BENCHMARK("sfxj, legacy") {
+        for (const auto& path : sfxjPaths) {
+            Sound sound;
+            legacyLoadSfxj(&sound, path);
+        }
+    };
+    BENCHMARK("sfxj, to Sound") {
+        for (const auto& path : sfxjPaths) {
+            Sound sound;
+            sound.load(QUrl::fromLocalFile(path));
+        }
+    };
+    BENCHMARK("sfxj, to SoundParams") {
+        for (const auto& path : sfxjPaths) {
+            SoundParams params;
+            SoundIO::load(&params, QUrl::fromLocalFile(path));
+        }
+    };
+    BENCHMARK("sfxr, to SoundParams") {
+        for (const auto& path : sfxrPaths) {
+            SoundParams params;
+            SoundIO::load(&params, QUrl::fromLocalFile(path));
+        }
+    };
+}
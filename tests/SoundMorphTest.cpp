@@ -0,0 +1,98 @@
+#include "SoundMorph.h"
+
+#include "BufferStrategy.h"
+#include "Random.h"
+#include "SoundUtils.h"
+
+#include <catch2/catch.hpp>
+
+TEST_CASE("SoundMorph::interpolate") {
+    Random random(6);
+    auto from = SoundUtils::generateExplosion(&random);
+    auto to = SoundUtils::generateLaser(&random);
+    from.waveForm = WaveForm::Noise;
+    to.waveForm = WaveForm::Square;
+
+    CHECK(SoundMorph::interpolate(from, to, 0).hash() == from.hash());
+    CHECK(SoundMorph::interpolate(from, to, 1).hash() == to.hash());
+
+    auto params = SoundMorph::interpolate(from, to, 0.25);
+    CHECK(params.waveForm == from.waveForm);
+    for (const auto& field : SoundParams::realFields()) {
+        INFO(field.name);
+        CHECK(params.*field.member
+              == Approx(0.75 * from.*field.member + 0.25 * to.*field.member));
+    }
+    CHECK(SoundMorph::interpolate(from, to, 0.75).waveForm == to.waveForm);
+}
+
+TEST_CASE("SoundMorph::synthesize") {
+    Random random(7);
+    auto from = SoundUtils::generateJump(&random);
+    auto to = SoundUtils::generateJump(&random);
+
+    SECTION("same wave forms") {
+        to.waveForm = from.waveForm;
+        auto samples = SoundMorph::synthesize(from, to, 0.4);
+        CHECK(samples == renderSamples(SoundMorph::interpolate(from, to, 0.4)));
+    }
+
+    SECTION("different wave forms are crossfaded") {
+        from.waveForm = WaveForm::Square;
+        to.waveForm = WaveForm::Sine;
+        auto params = SoundMorph::interpolate(from, to, 0.4);
+        params.waveForm = WaveForm::Square;
+        auto squareSamples = renderSamples(params);
+        params.waveForm = WaveForm::Sine;
+        auto sineSamples = renderSamples(params);
+
+        auto samples = SoundMorph::synthesize(from, to, 0.4);
+        REQUIRE(samples.size() == qMax(squareSamples.size(), sineSamples.size()));
+        for (int idx = 0; idx < samples.size(); idx += 97) {
+            CAPTURE(idx);
+            qreal square = idx < squareSamples.size() ? squareSamples.at(idx) : 0;
+            qreal sine = idx < sineSamples.size() ? sineSamples.at(idx) : 0;
+            CHECK(samples.at(idx) == Approx(0.6 * square + 0.4 * sine).margin(1e-9));
+        }
+    }
+}
+
+TEST_CASE("SoundMorph::synthesizeSteps") {
+    Random random(8);
+    auto from = SoundUtils::generateExplosion(&random);
+    auto to = SoundUtils::generatePowerup(&random);
+
+    CHECK(SoundMorph::stepPosition(0, 5) == 0);
+    CHECK(SoundMorph::stepPosition(2, 5) == 0.5);
+    CHECK(SoundMorph::stepPosition(4, 5) == 1);
+
+    auto steps = SoundMorph::synthesizeSteps(from, to, 5, 3);
+    REQUIRE(steps.size() == 5);
+    for (int idx = 0; idx < steps.size(); ++idx) {
+        CAPTURE(idx);
+        CHECK(steps.at(idx)
+              == SoundMorph::synthesize(from, to, SoundMorph::stepPosition(idx, 5)));
+    }
+
+    SECTION("mixing steps") {
+        CHECK(SoundMorph::mixSteps(steps, 0) == steps.at(0));
+        CHECK(SoundMorph::mixSteps(steps, 0.5) == steps.at(2));
+        CHECK(SoundMorph::mixSteps(steps, 1) == steps.at(4));
+
+        // Halfway between steps 1 and 2
+        auto samples = SoundMorph::mixSteps(steps, 0.375);
+        const auto& step1 = steps.at(1);
+        const auto& step2 = steps.at(2);
+        REQUIRE(samples.size() == qMax(step1.size(), step2.size()));
+        for (int idx = 0; idx < samples.size(); idx += 101) {
+            CAPTURE(idx);
+            qreal sample1 = idx < step1.size() ? step1.at(idx) : 0;
+            qreal sample2 = idx < step2.size() ? step2.at(idx) : 0;
+            CHECK(samples.at(idx) == Approx((sample1 + sample2) / 2).margin(1e-9));
+        }
+    }
+
+    SECTION("no steps") {
+        CHECK(SoundMorph::mixSteps({}, 0.5).isEmpty());
+    }
+}
@@ -1,3 +1,4 @@
+#include "Random.h"
 #include "Sound.h"
 #include "SoundIO.h"
 #include "SoundUtils.h"
@@ -58,8 +59,11 @@ TEST_CASE("Sound") {
     SECTION("load/save sfxj") {
         QTemporaryDir tempDir;
         auto path = tempDir.filePath("test.sfxj");
+        Random random;
+        SoundParams params;
+        SoundUtils::mutate(&params, &random);
         Sound sound1;
-        SoundUtils::mutate(&sound1);
+        params.applyTo(&sound1);
         REQUIRE(sound1.save(path));
 
         Sound sound2;
@@ -1,8 +1,16 @@
 #include "TestUtils.h"
 
+#include "Result.h"
+#include "SoundIO.h"
+#include "SoundParams.h"
+#include "TestConfig.h"
+
 #include <QDebug>
 #include <QFile>
 
+const QStringList FIXTURE_NAMES = {
+    "blip", "missile", "pickup", "power-up", "power-up-sine", "splash", "triangle"};
+
 QByteArray loadFile(const QString& path) {
     QFile file(path);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -12,6 +20,19 @@ QByteArray loadFile(const QString& path) {
     return file.readAll();
 }
 
+QString fixturePath(const QString& name) {
+    return QString("%1/synthesizer/input/%2.sfxj").arg(TEST_FIXTURES_DIR, name);
+}
+
+SoundParams loadFixtureParams(const QString& name) {
+    SoundParams params;
+    auto result = SoundIO::load(&params, QUrl::fromLocalFile(fixturePath(name)));
+    if (!result) {
+        qCritical() << "Could not load fixture" << name << ":" << result.message();
+    }
+    return params;
+}
+
 QtDebugSilencer::QtDebugSilencer() {
     auto silentHandler = [](QtMsgType, const QMessageLogContext&, const QString&) {};
     mOldHandler = qInstallMessageHandler(silentHandler);
@@ -2,12 +2,30 @@
 #define TESTUTILS_H
 
 #include <QString>
+#include <QStringList>
 #include <QUrl>
 
 #include <fstream>
 
+struct SoundParams;
+
 QByteArray loadFile(const QString& path);
 
+/**
+ * Names of the sounds of the synthesizer fixtures
+ */
+extern const QStringList FIXTURE_NAMES;
+
+/**
+ * Path of the .sfxj file of the synthesizer fixture called `name`
+ */
+QString fixturePath(const QString& name);
+
+/**
+ * Loads the synthesizer fixture called `name`
+ */
+SoundParams loadFixtureParams(const QString& name);
+
 /**
  * Disable all qDebug output while it is alive
  */
@@ -0,0 +1,168 @@
+#include "BufferStrategy.h"
+#include "SoundParams.h"
+#include "Synthesizer.h"
+#include "TestConfig.h"
+#include "TestUtils.h"
+#include "WavSaver.h"
+
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+#include <catch2/catch.hpp>
+
+/**
+ * The writer used before WavSaver rendered in memory: one write per sample,
+ * then seeks to patch the header
+ */
+static void legacySave(const SoundParams& params, const QString& path) {
+    QFile file(path);
+    file.open(QIODevice::WriteOnly);
+    auto writeUInt32 = [&file](quint32 value) {
+        value = qToLittleEndian(value);
+        file.write(reinterpret_cast<char*>(&value), 4);
+    };
+    auto writeUInt16 = [&file](quint16 value) {
+        value = qToLittleEndian(value);
+        file.write(reinterpret_cast<char*>(&value), 2);
+    };
+    file.write("RIFF", 4);
+    writeUInt32(0);
+    file.write("WAVEfmt ", 8);
+    writeUInt32(16);
+    writeUInt16(1);
+    writeUInt16(1);
+    writeUInt32(44100);
+    writeUInt32(44100 * 2);
+    writeUInt16(2);
+    writeUInt16(16);
+    file.write("data", 4);
+    writeUInt32(0);
+
+    class Strategy : public Synthesizer::SynthStrategy {
+    public:
+        explicit Strategy(QFile* file) : mFile(file) {
+        }
+        void write(qreal sample) override {
+            qint16 value = qToLittleEndian(qint16(qBound(-1.0, sample, 1.0) * 32000));
+            mFile->write(reinterpret_cast<char*>(&value), 2);
+            ++count;
+        }
+        quint32 count = 0;
+
+    private:
+        QFile* const mFile;
+    } strategy(&file);
+
+    Synthesizer synth;
+    synth.init(params);
+    while (synth.synthSample(256, &strategy)) {
+    }
+    file.seek(4);
+    writeUInt32(36 + strategy.count * 2);
+    file.seek(40);
+    writeUInt32(strategy.count * 2);
+}
+
+TEST_CASE("WavSaver") {
+    WaveForm::registerType();
+    QTemporaryDir tempDir;
+    auto params = loadFixtureParams("splash");
+    auto expected =
+        loadFile(QString("%1/synthesizer/expected/splash.wav").arg(TEST_FIXTURES_DIR));
+    REQUIRE(!expected.isEmpty());
+
+    SECTION("buffered and mapped modes produce the same file") {
+        WavSaver saver;
+        for (auto mode : {WavSaver::Buffered, WavSaver::Mapped}) {
+            saver.setWriteMode(mode);
+            auto path = tempDir.filePath(QString("splash-%1.wav").arg(mode));
+            // Write twice to check existing files are truncated
+            REQUIRE(saver.save(params, path));
+            qint64 sampleCount;
+            REQUIRE(saver.save(params, path, &sampleCount));
+            CHECK(loadFile(path) == expected);
+            CHECK(sampleCount == (expected.size() - 44) / 2);
+        }
+    }
+
+    SECTION("save to a device") {
+        WavSaver saver;
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        REQUIRE(saver.save(params, &buffer));
+        CHECK(buffer.data() == expected);
+    }
+
+    SECTION("raw format") {
+        WavSaver saver;
+        saver.setFormat(WavSaver::Raw);
+        QBuffer buffer;
+        buffer.open(QIODevice::WriteOnly);
+        qint64 sampleCount;
+        REQUIRE(saver.save(params, &buffer, &sampleCount));
+        CHECK(buffer.data() == expected.mid(44));
+        CHECK(sampleCount == (expected.size() - 44) / 2);
+    }
+
+    SECTION("header sizes match the data at 22050 Hz") {
+        WavSaver saver;
+        saver.setFrequency(22050);
+        saver.setBits(8);
+        auto path = tempDir.filePath("splash-22050.wav");
+        REQUIRE(saver.save(params, path));
+        auto data = loadFile(path);
+        CHECK(qFromLittleEndian<quint32>(data.constData() + 4) == quint32(data.size() - 8));
+        CHECK(qFromLittleEndian<quint32>(data.constData() + 40) == quint32(data.size() - 44));
+    }
+
+    SECTION("saving synthesized samples gives the same result") {
+        QVector<qreal> samples;
+        BufferStrategy strategy(&samples);
+        Synthesizer synth;
+        synth.init(params);
+        while (synth.synthSample(256, &strategy)) {
+        }
+
+        WavSaver saver;
+        saver.setBits(8);
+        saver.setFrequency(22050);
+        auto fromParamsPath = tempDir.filePath("from-params.wav");
+        auto fromSamplesPath = tempDir.filePath("from-samples.wav");
+        REQUIRE(saver.save(params, fromParamsPath));
+        REQUIRE(saver.save(samples, fromSamplesPath));
+        CHECK(loadFile(fromSamplesPath) == loadFile(fromParamsPath));
+    }
+
+    SECTION("legacy writer produces the same file") {
+        auto path = tempDir.filePath("splash-legacy.wav");
+        legacySave(params, path);
+        CHECK(loadFile(path) == expected);
+    }
+}
+
+// Hidden by default, run with `tests [benchmark]`. Set SFXR_BENCHMARK_DIR to
+// measure the performance on a specific storage.
+TEST_CASE("WavSaver throughput", "[.][benchmark]") {
+    WaveForm::registerType();
+    QTemporaryDir tempDir(qEnvironmentVariable("SFXR_BENCHMARK_DIR", QDir::tempPath())
+                          + "/sfxr-benchmark-XXXXXX");
+    REQUIRE(tempDir.isValid());
+    auto params = loadFixtureParams("splash");
+    auto path = tempDir.filePath("splash.wav");
+    WavSaver saver;
+
+    BENCHMARK("legacy") {
+        legacySave(params, path);
+    };
+    BENCHMARK("buffered") {
+        saver.setWriteMode(WavSaver::Buffered);
+        saver.save(params, path);
+    };
+    BENCHMARK("mapped") {
+        saver.setWriteMode(WavSaver::Mapped);
+        saver.save(params, path);
+    };
+}